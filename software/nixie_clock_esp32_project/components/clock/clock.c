@@ -92,3 +92,29 @@ void clock_increment_minutes(myclock_t *clk) {
 void clock_decrement_minutes(myclock_t *clk) {
     clk->minutes = (uint8_t)((clk->minutes + 59U) % 60U);
 }
+
+/**
+ * @brief Pack the time into one 32-bit word (0x00HHMMSS).
+ *
+ * A word can be stored and loaded atomically, so readers get a
+ * consistent time without taking the clock mutex.
+ *
+ * @param clk Pointer to the clock structure.
+ *
+ * @return Packed time.
+ */
+uint32_t clock_pack(const myclock_t *clk) {
+    return ((uint32_t)clk->hours << 16U) | ((uint32_t)clk->minutes << 8U) | (uint32_t)clk->seconds;
+}
+
+/**
+ * @brief Unpack a word produced by clock_pack().
+ *
+ * @param packed Packed time.
+ * @param clk Pointer to the clock structure to fill.
+ */
+void clock_unpack(uint32_t packed, myclock_t *clk) {
+    clk->hours = (uint8_t)(packed >> 16U);
+    clk->minutes = (uint8_t)(packed >> 8U);
+    clk->seconds = (uint8_t)packed;
+}
@@ -48,4 +48,10 @@ void clock_increment_minutes(myclock_t *clk);
 // Decrement minutes immediately (e.g., called from button)
 void clock_decrement_minutes(myclock_t *clk);
 
+// Pack the time into one word (0x00HHMMSS), for lock-free snapshots
+uint32_t clock_pack(const myclock_t *clk);
+
+// Unpack a word produced by clock_pack()
+void clock_unpack(uint32_t packed, myclock_t *clk);
+
 #endif // CLOCK_H
\ No newline at end of file
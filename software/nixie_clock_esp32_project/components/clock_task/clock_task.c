@@ -4,8 +4,9 @@
 #ifdef STATIC_ANALYSIS
 #include "../test/common/esp_stub.h"
 #endif
-#include "esp_task_wdt.h"
+#include <stdatomic.h>
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "clock_task.h"
@@ -15,6 +16,9 @@
 #include "../gpio_driver/gpio_driver.h"
 #include "../rotary_encoder/rotary_encoder.h"
 #include "../config/config.h"
+#include "../timer_service/timer_service.h"
+#include "../event_bus/event_payloads.h"
+#include "../metrics/metrics.h"
 
 /******************************************************************
  * 2. Define declarations (macros then function macros)
@@ -23,6 +27,9 @@
 #define CLOCK_MENU_CONFIGURE_MINUTES    (1U)
 #define CLOCK_MENU_CONFIGURE_HOURS      (2U)
 #define CLOCK_PATTERN_MAX_STEP          (9U)
+#define CLOCK_TICK_PERIOD_MS            (1000U)
+#define CLOCK_DISPLAY_PERIOD_MS         (50U)
+#define CLOCK_DISPLAY_PERIOD_US         ((int64_t)CLOCK_DISPLAY_PERIOD_MS * 1000)
 
 /******************************************************************
  * 3. Typedef definitions (simple typedef, then enum and structs)
@@ -34,114 +41,129 @@
 static const char CLOCK_TASK_TAG[] = "CLOCK_TASK";
 static myclock_t clk;
 static SemaphoreHandle_t clk_mutex = NULL;
+static StaticSemaphore_t clk_mutex_buffer;
+/* clock_pack() of clk, stored under clk_mutex and read without it */
+static atomic_uint_least32_t clk_snapshot = 0U;
+
+/* Display state, only touched from the dispatcher task */
+static bool dots = true;
+static uint8_t pattern_step = 0U;
+static bool in_pattern_mode = false;
+static bool in_test_mode = false;
+static int64_t last_frame_us = 0;
 
 /******************************************************************
  * 5. Functions prototypes (static only)
 ******************************************************************/
-static void clock_menu(myclock_t *clk, const uint8_t* payload, const uint8_t size);
-static void clock_task(void *arg);
+static void clock_menu(myclock_t *clk, const uint8_t* payload, const uint16_t size);
+static void clock_publish_snapshot(void);
 
 /******************************************************************
  * 6. Functions definitions
 ******************************************************************/
 
 /**
- * @brief Main clock task.
- *
- * Runs in a FreeRTOS task. Handles:
- * - Clock ticking every second
- * - Display updates
- * - User input via clock_menu()
+ * @brief Publish the current time for clock_get_snapshot().
  *
- * @param[in] arg Task argument (unused)
+ * **Important:** The caller must hold clk_mutex.
  */
-static void clock_task(void *arg) { 
+static void clock_publish_snapshot(void)
+{
+    atomic_store_explicit(&clk_snapshot, clock_pack(&clk), memory_order_relaxed);
+}
 
-    bool dots = true;
-    uint8_t pattern_step = 0U;
-    (void)arg; 
-    config_t config;
-    bool in_pattern_mode = false;
-    bool in_test_mode = false;
-    esp_err_t ret = ESP_OK;
+/**
+ * @brief Advance the clock, on every EVT_TIMER_CLOCK_TICK (1 s).
+ *
+ * The event carries the number of seconds elapsed since the previous
+ * one, more than 1 when the timer or the dispatcher ran late. Starts the
+ * anti-poisoning pattern at each new minute.
+ */
+void clock_tick_callback(uint8_t* payload, uint16_t size)
+{
+    evt_timer_tick_t tick;
 
-    /* Add task watchdog */
-    esp_task_wdt_add(NULL);
+    if ((evt_timer_tick_unpack(payload, size, &tick) == true) && (clk_mutex != NULL)) {
+        bool new_minute = false;
 
-    clock_init(&clk, CONFIG_CLOCK_DEFAULT_HOURS, CONFIG_CLOCK_DEFAULT_MINUTES, CONFIG_CLOCK_DEFAULT_SECONDS);
+        xSemaphoreTake(clk_mutex, portMAX_DELAY);
+        for (uint16_t i = 0U; i < tick.ticks; i++) {
+            dots = !dots;
+            clock_tick(&clk);
+            new_minute = new_minute || (clk.seconds == 0U);
+        }
+        clock_publish_snapshot();
+        ESP_LOGI(CLOCK_TASK_TAG, "The time is %02d:%02d:%02d", clk.hours, clk.minutes, clk.seconds);
 
-    TickType_t lastTick = xTaskGetTickCount();
-    const TickType_t tickPeriod = pdMS_TO_TICKS(1000);    // 1s
-    const TickType_t displayPeriod = pdMS_TO_TICKS(50);   // 50ms
+        if (new_minute == true) {
+            in_pattern_mode = true;
+            pattern_step = 0U;
+        }
+        xSemaphoreGive(clk_mutex);
+    }
+}
 
-    while (ret == ESP_OK) {
-        /* Reset watchdog */
-        esp_task_wdt_reset();
+/**
+ * @brief Refresh the display, on every EVT_TIMER_DISPLAY (50 ms).
+ *
+ * Shows the time, the test pattern or the anti-poisoning pattern
+ * depending on the configured mode. The distance of each frame interval
+ * from the period goes to the display jitter histogram, a late or
+ * coalesced frame shows up there as a visible stutter would.
+ */
+void clock_display_callback(uint8_t* payload, uint16_t size)
+{
+    (void)payload;
+    (void)size;
+    config_t config;
+    int64_t now_us = esp_timer_get_time();
 
-        TickType_t now = xTaskGetTickCount();
-        
-        /* Get latest configuration */
-        ret = config_get_copy(&config);
-        if (ret == ESP_OK) {
-
-            /* Every second */
-            if ((now - lastTick) >= tickPeriod) {
-                lastTick += tickPeriod;
-				dots = !dots;
-				
-                xSemaphoreTake(clk_mutex, portMAX_DELAY);
-                clock_tick(&clk);
-                ESP_LOGI(CLOCK_TASK_TAG, "The time is %02d:%02d:%02d", clk.hours, clk.minutes, clk.seconds);
-                
-                if (clk.seconds == 0U) {
-                    in_pattern_mode = true;
-                    pattern_step = 0U;
-                }
-				xSemaphoreGive(clk_mutex);
-            }
+    if (last_frame_us != 0) {
+        int64_t jitter_us = (now_us - last_frame_us) - CLOCK_DISPLAY_PERIOD_US;
+        jitter_us = (jitter_us < 0) ? -jitter_us : jitter_us;
+        metrics_observe(METRICS_DISPLAY_JITTER_US,
+                        (jitter_us > (int64_t)UINT32_MAX) ? UINT32_MAX : (uint32_t)jitter_us);
+    }
+    last_frame_us = now_us;
 
-            if (in_pattern_mode == false) {
-                if (config.mode == (uint8_t)CONFIG_MODE_ANTIPOISONING){
-                    in_pattern_mode = true;
-                    in_test_mode = false;
-                }
-                else if (config.mode == (uint8_t)CONFIG_MODE_TEST){
-                    in_pattern_mode = false;
-                    in_test_mode = true;
-                }
-                else { /* Clock mode */
-                    in_pattern_mode = false;
-                    in_test_mode = false;
-                }
+    /* Get latest configuration */
+    if ((clk_mutex != NULL) && (config_get_copy(&config) == ESP_OK)) {
+        if (in_pattern_mode == false) {
+            if (config.mode == (uint8_t)CONFIG_MODE_ANTIPOISONING){
+                in_pattern_mode = true;
+                in_test_mode = false;
             }
-
-            if (in_test_mode == true) {
-                uint8_t display_leading_zero = 1U;
-                display_set_time(12U, 34U, 56U, 1U, 1U, display_leading_zero);
+            else if (config.mode == (uint8_t)CONFIG_MODE_TEST){
+                in_pattern_mode = false;
+                in_test_mode = true;
             }
-            else if (in_pattern_mode == true) {
-                display_set_pattern_1(pattern_step);
-                pattern_step++;
-
-                if (pattern_step > CLOCK_PATTERN_MAX_STEP) {
-                    pattern_step = 0U;
-                    in_pattern_mode = false;
-                }
-            } else {
-				xSemaphoreTake(clk_mutex, portMAX_DELAY);
-                uint8_t display_leading_zero = 0U;
-                display_set_time(clk.hours, clk.minutes, clk.seconds, dots, dots, display_leading_zero);
-				xSemaphoreGive(clk_mutex);
+            else { /* Clock mode */
+                in_pattern_mode = false;
+                in_test_mode = false;
             }
+        }
+
+        if (in_test_mode == true) {
+            uint8_t display_leading_zero = 1U;
+            display_set_time(12U, 34U, 56U, 1U, 1U, display_leading_zero);
+        }
+        else if (in_pattern_mode == true) {
+            display_set_pattern_1(pattern_step);
+            pattern_step++;
 
-            vTaskDelay(displayPeriod);
+            if (pattern_step > CLOCK_PATTERN_MAX_STEP) {
+                pattern_step = 0U;
+                in_pattern_mode = false;
+            }
         } else {
-            ESP_LOGE(CLOCK_TASK_TAG, "Unable to get configuration");
+            xSemaphoreTake(clk_mutex, portMAX_DELAY);
+            uint8_t display_leading_zero = 0U;
+            display_set_time(clk.hours, clk.minutes, clk.seconds, dots, dots, display_leading_zero);
+            xSemaphoreGive(clk_mutex);
         }
+    } else {
+        ESP_LOGE(CLOCK_TASK_TAG, "Unable to get configuration");
     }
-
-    /* Free task */
-    vTaskDelete(NULL);
 }
 
 /**
@@ -159,16 +181,11 @@ static void clock_task(void *arg) {
  * @param[in] payload Pointer to event data buffer.
  * @param[in] size Size of the payload in bytes.
  */
-static void clock_menu(myclock_t *clk, const uint8_t* payload, const uint8_t size)
+static void clock_menu(myclock_t *clk, const uint8_t* payload, const uint16_t size)
 {
-    button_event_t event;
+    evt_button_t event;
 
-    if ((payload != NULL) && (size == sizeof(event))) {
-        event.id = payload[0];
-        event.pressed = payload[1];
-        event.state = payload[2];
-        event.updateValue = payload[3];
-        event.steps = payload[4];
+    if (evt_button_unpack(payload, size, &event) == true) {
 
         /* Filter only release states */
         if (event.state == BUTTON_STATE_RELEASE) {
@@ -192,6 +209,7 @@ static void clock_menu(myclock_t *clk, const uint8_t* payload, const uint8_t siz
                             for (uint8_t i = 0U; i < event.steps; i++) {
                                 clock_increment_minutes(clk);
                             }
+                            clock_publish_snapshot();
                             xSemaphoreGive(clk_mutex);
                         }
                         else if (event.updateValue == ROTARY_ENCODER_EVENT_DECREMENT) {
@@ -199,6 +217,7 @@ static void clock_menu(myclock_t *clk, const uint8_t* payload, const uint8_t siz
                             for (uint8_t i = 0U; i < event.steps; i++) {
                                 clock_decrement_minutes(clk);
                             }
+                            clock_publish_snapshot();
                             xSemaphoreGive(clk_mutex);
                         }
                         else {
@@ -221,6 +240,7 @@ static void clock_menu(myclock_t *clk, const uint8_t* payload, const uint8_t siz
                             for (uint8_t i = 0U; i < event.steps; i++) {
                                 clock_increment_hours(clk);
                             }
+                            clock_publish_snapshot();
                             xSemaphoreGive(clk_mutex);
                         }
                         else if (event.updateValue == ROTARY_ENCODER_EVENT_DECREMENT) {
@@ -228,6 +248,7 @@ static void clock_menu(myclock_t *clk, const uint8_t* payload, const uint8_t siz
                             for (uint8_t i = 0U; i < event.steps; i++) {
                                 clock_decrement_hours(clk);
                             }
+                            clock_publish_snapshot();
                             xSemaphoreGive(clk_mutex);
                         }
                         else {
@@ -247,25 +268,27 @@ static void clock_menu(myclock_t *clk, const uint8_t* payload, const uint8_t siz
 }
 
 /**
- * @brief Start the clock task.
+ * @brief Start the clock.
  *
- * Creates the FreeRTOS task `clock_task` to handle clock updates,
- * display refresh, and user input. Logs an error if task creation fails.
+ * Initializes the clock state and schedules the periodic
+ * EVT_TIMER_CLOCK_TICK and EVT_TIMER_DISPLAY events handled by
+ * clock_tick_callback() and clock_display_callback(). Every tick is
+ * delivered, late display refreshes are merged.
  */
 void clock_task_start(void)
 {
     if (clk_mutex == NULL) {
-        clk_mutex = xSemaphoreCreateMutex();
+        clock_init(&clk, CONFIG_CLOCK_DEFAULT_HOURS, CONFIG_CLOCK_DEFAULT_MINUTES, CONFIG_CLOCK_DEFAULT_SECONDS);
+        clock_publish_snapshot();
+
+        clk_mutex = xSemaphoreCreateMutexStatic(&clk_mutex_buffer);
         if (clk_mutex == NULL) {
             ESP_LOGE(CLOCK_TASK_TAG, "Failed to create clk_mutex");
         }
         else {
-            /* Create clock task */
-            BaseType_t ret = xTaskCreate(clock_task, "clock_task", 4096, NULL, 2U, NULL);
-
-            if (ret != pdPASS) {
-                ESP_LOGE(CLOCK_TASK_TAG, "Failed to create clock_task");
-            }
+            /* Tick and refresh are driven by timer events, no task of our own */
+            (void)timer_service_start_counted(EVT_TIMER_CLOCK_TICK, CLOCK_TICK_PERIOD_MS, CLOCK_TICK_PERIOD_MS);
+            (void)timer_service_start(EVT_TIMER_DISPLAY, CLOCK_DISPLAY_PERIOD_MS, CLOCK_DISPLAY_PERIOD_MS);
         }
     }
 }
@@ -275,19 +298,14 @@ void clock_task_start(void)
  *
  * Reads payload and updates the clock state.
  */
-void clock_ntp_config_callback(uint8_t* payload, uint8_t size)
+void clock_ntp_config_callback(uint8_t* payload, uint16_t size)
 {
-    (void)payload;
-    (void)size;
-
     /* Update with NTP */
-    myclock_t clockUpdate;
-    if ((payload != NULL) && (size == sizeof(clockUpdate)) && (clk_mutex != NULL)) {
-        clockUpdate.hours = payload[0];
-        clockUpdate.minutes = payload[1];
-        clockUpdate.seconds = payload[2];
+    evt_clock_time_t clockUpdate;
+    if ((evt_clock_time_unpack(payload, size, &clockUpdate) == true) && (clk_mutex != NULL)) {
         xSemaphoreTake(clk_mutex, portMAX_DELAY);
         clock_init(&clk, clockUpdate.hours, clockUpdate.minutes, clockUpdate.seconds);
+        clock_publish_snapshot();
         xSemaphoreGive(clk_mutex);
     }
     else {
@@ -302,7 +320,7 @@ void clock_ntp_config_callback(uint8_t* payload, uint8_t size)
  * NTP is disabled. Intended to be triggered by user input events
  * (rotary encoder, buttons).
  */
-void clock_update_with_menu_callback(uint8_t* payload, uint8_t size)
+void clock_update_with_menu_callback(uint8_t* payload, uint16_t size)
 {
     esp_err_t result = ESP_OK;
     config_t config;
@@ -328,7 +346,7 @@ void clock_update_with_menu_callback(uint8_t* payload, uint8_t size)
  * NTP is disabled. Intended to be triggered by configuration change
  * events (boot, webserver update, etc.).
  */
-void clock_update_from_config_callback(uint8_t* payload, uint8_t size)
+void clock_update_from_config_callback(uint8_t* payload, uint16_t size)
 {
     (void)payload;
     (void)size;
@@ -343,6 +361,7 @@ void clock_update_from_config_callback(uint8_t* payload, uint8_t size)
             if (clk_mutex != NULL) {
                 xSemaphoreTake(clk_mutex, portMAX_DELAY);
                 clock_init(&clk, config.time.hours, config.time.minutes, config.time.seconds);
+                clock_publish_snapshot();
                 xSemaphoreGive(clk_mutex);
             }
         }
@@ -375,4 +394,18 @@ bool clock_get_copy(myclock_t *out)
     }
 
     return ret;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Get the current clock state without blocking.
+ *
+ * Reads the snapshot published on every clock change, so it never
+ * waits for the clock mutex. The time is consistent but may be up to
+ * one update behind a concurrent writer.
+ *
+ * @param[out] out Pointer to the clock structure.
+ */
+void clock_get_snapshot(myclock_t *out)
+{
+    clock_unpack((uint32_t)atomic_load_explicit(&clk_snapshot, memory_order_relaxed), out);
+}
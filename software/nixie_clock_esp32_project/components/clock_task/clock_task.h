@@ -28,9 +28,12 @@
  * 6. Functions definitions
 ******************************************************************/
 void clock_task_start(void);
-void clock_ntp_config_callback(uint8_t* payload, uint8_t size);
-void clock_update_with_menu_callback(uint8_t* payload, uint8_t size);
-void clock_update_from_config_callback(uint8_t* payload, uint8_t size);
+void clock_tick_callback(uint8_t* payload, uint16_t size);
+void clock_display_callback(uint8_t* payload, uint16_t size);
+void clock_ntp_config_callback(uint8_t* payload, uint16_t size);
+void clock_update_with_menu_callback(uint8_t* payload, uint16_t size);
+void clock_update_from_config_callback(uint8_t* payload, uint16_t size);
 bool clock_get_copy(myclock_t *out);
+void clock_get_snapshot(myclock_t *out);
 
 #endif // CLOCK_TASK_H
\ No newline at end of file
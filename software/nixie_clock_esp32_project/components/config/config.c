@@ -4,15 +4,22 @@
 #ifdef STATIC_ANALYSIS
 #include "../test/common/esp_stub.h"
 #endif
+#include <stdatomic.h>
+#include <string.h>
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_system.h"
 #include "config.h"
+#include "config_schema.h"
 #include "nvs.h"
 #include "../event_bus/event_bus.h"
 #include "nvs_flash.h"
 /******************************************************************
  * 2. Define declarations (macros then function macros)
 ******************************************************************/
+#define CONFIG_SHUTDOWN_FLUSH_TIMEOUT_MS (1000U)   /* esp_restart() must not hang on a stuck mutex holder */
+#define CONFIG_MS_TO_US(ms)              ((int64_t)(ms) * 1000LL)
 
 /******************************************************************
  * 3. Typedef definitions (simple typedef, then enum and structs)
@@ -23,7 +30,16 @@
 ******************************************************************/
 static config_t cfg;
 static config_t cfg_last;
+static config_t cfg_persisted;
 static const char CONFIG_TAG[] = "CONFIG";
+static esp_timer_handle_t config_persist_timer = NULL;
+static int64_t config_dirty_since_us = 0;
+static bool config_dirty = false;
+static uint32_t config_pending_writes = 0U;
+static config_persist_stats_t config_stats = {0};
+/* Bumped under the mutex whenever cfg changes, read without it */
+static atomic_uint_least32_t config_generation = 0U;
+static StaticSemaphore_t config_mutex_buffer;
 SemaphoreHandle_t config_mutex = NULL;
 const TickType_t CONFIG_MUTEX_TIMEOUT = portMAX_DELAY;
 
@@ -32,6 +48,12 @@ const TickType_t CONFIG_MUTEX_TIMEOUT = portMAX_DELAY;
 ******************************************************************/
 static esp_err_t _config_read(void);
 static esp_err_t _config_save_nolock(void);
+static uint32_t _config_persist_nolock(void);
+static esp_err_t _config_flush(TickType_t timeout);
+static uint32_t _config_count_unpersisted_nolock(void);
+static void _config_schedule_persist_nolock(void);
+static void config_persist_timer_cb(void *arg);
+static void config_shutdown_handler(void);
 
 /**
  * @brief Initialize the configuration module.
@@ -44,27 +66,39 @@ static esp_err_t _config_save_nolock(void);
 esp_err_t config_init(void) {
     uint8_t init_flag = false;
     esp_err_t ret = ESP_OK;
-    config_t default_cfg = {
-        .ssid = "",
-        .wpa_passphrase = "",
-        .mode = CONFIG_MODE_DEFAULT,
-        .ntp = CONFIG_NTP_DEFAULT,
-        .time = {
-            .hours = CONFIG_CLOCK_DEFAULT_HOURS,
-            .minutes = CONFIG_CLOCK_DEFAULT_MINUTES,
-            .seconds = CONFIG_CLOCK_DEFAULT_SECONDS
-        },
-        .dutycycle = CONFIG_PWM_DEFAULT_DUTYCYCLE
-    };
+    config_t default_cfg;
+
+    for (uint8_t i = 0U; i < (uint8_t)CONFIG_FIELD_COUNT; i++) {
+        config_field_set_default(&default_cfg, &config_fields[i]);
+    }
 
     if (config_mutex == NULL) {
-        config_mutex = xSemaphoreCreateMutex();
+        config_mutex = xSemaphoreCreateMutexStatic(&config_mutex_buffer);
         if (config_mutex == NULL) {
             ESP_LOGE(CONFIG_TAG, "Failed to create config mutex");
             ret = ESP_FAIL;
         }
     }
 
+    if ((ret == ESP_OK) && (config_persist_timer == NULL)) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = config_persist_timer_cb,
+            .arg = NULL,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "config_persist"
+        };
+        ret = esp_timer_create(&timer_args, &config_persist_timer);
+        if (ret != ESP_OK) {
+            ESP_LOGE(CONFIG_TAG, "Failed to create persist timer");
+        }
+        else if (esp_register_shutdown_handler(config_shutdown_handler) != ESP_OK) {
+            ESP_LOGW(CONFIG_TAG, "Failed to register shutdown handler");
+        }
+        else {
+            /* Pending writes are flushed on esp_restart() */
+        }
+    }
+
     if (ret == ESP_OK) {
         BaseType_t taken = xSemaphoreTake(config_mutex, CONFIG_MUTEX_TIMEOUT);
         if (taken == pdTRUE)
@@ -73,9 +107,10 @@ esp_err_t config_init(void) {
             if (ret == ESP_OK) {
                 esp_err_t ret_load = nvs_load_init_flag(&init_flag);
                 if (ret_load != ESP_OK) {
-                    /* First time initialization */
+                    /* First time initialization, written through immediately */
                     cfg = default_cfg;
-                    ret = _config_save_nolock();
+                    cfg_last = cfg;
+                    ret = (_config_persist_nolock() > 0U) ? ESP_OK : ESP_FAIL;
 
                     /* Save the initialization flag */
                     if (ret == ESP_OK) {
@@ -92,9 +127,9 @@ esp_err_t config_init(void) {
                     if (init_flag != 1U) {
                         ESP_LOGE(CONFIG_TAG, "Critical: Failed to load init flag from NVS");
 
-                        /* First time initialization */
+                        /* First time initialization, written through immediately */
                         cfg = default_cfg;
-                        (void)_config_save_nolock();
+                        (void)_config_persist_nolock();
 
                         /* Save the initialization flag */
                         (void)nvs_save_init_flag(1U);
@@ -104,10 +139,12 @@ esp_err_t config_init(void) {
                         if (_config_read() != ESP_OK) {
                             ESP_LOGE(CONFIG_TAG, "Error loading configuration");
                         }
+                        cfg_persisted = cfg;
                     }
 
                     cfg_last = cfg;  
                 }
+                (void)atomic_fetch_add_explicit(&config_generation, 1U, memory_order_release);
             }
 
             BaseType_t give_ret = xSemaphoreGive(config_mutex);
@@ -119,16 +156,10 @@ esp_err_t config_init(void) {
                 ret = ESP_OK;
 
                 /* Push events on bus */
-                event_bus_message_t evt_message;
-                evt_message.type = EVT_WIFI_CONFIG;
-                evt_message.payload_size = 0U;
-                event_bus_publish(evt_message);
-                evt_message.type = EVT_PWM_CONFIG;
-                event_bus_publish(evt_message);
-                evt_message.type = EVT_NTP_CONFIG;
-                event_bus_publish(evt_message);
-                evt_message.type = EVT_CLOCK_WEB_CONFIG;
-                event_bus_publish(evt_message);
+                event_bus_publish(EVT_WIFI_CONFIG, EVENT_BUS_BUFFER_NONE);
+                event_bus_publish(EVT_PWM_CONFIG, EVENT_BUS_BUFFER_NONE);
+                event_bus_publish(EVT_NTP_CONFIG, EVENT_BUS_BUFFER_NONE);
+                event_bus_publish(EVT_CLOCK_WEB_CONFIG, EVENT_BUS_BUFFER_NONE);
             }
         }
     }
@@ -137,12 +168,15 @@ esp_err_t config_init(void) {
 }
 
 /**
- * @brief Save the configuration to NVS if it has changed.
+ * @brief Apply the configuration and schedule its persistence to NVS.
  *
- * Compares current configuration with last saved one and writes
- * only the modified fields to NVS. Access is protected by mutex.
+ * Compares current configuration with the last applied one and publishes
+ * the change events at once. Writing to NVS is deferred: it happens after
+ * CONFIG_PERSIST_QUIET_MS without further changes, at the latest
+ * CONFIG_PERSIST_MAX_DELAY_MS after the first unsaved change, or on
+ * config_flush() / shutdown. Access is protected by mutex.
  *
- * @return ESP_OK if any value was saved, ESP_FAIL if nothing changed
+ * @return ESP_OK if any value changed, ESP_FAIL if nothing changed
  *         or mutex could not be acquired.
  */
 esp_err_t config_save(void){
@@ -151,10 +185,12 @@ esp_err_t config_save(void){
     BaseType_t taken = xSemaphoreTake(config_mutex, CONFIG_MUTEX_TIMEOUT);
     if (taken == pdTRUE) {
 
+        config_stats.save_requests++;
         ret = _config_save_nolock();
         if (ret != ESP_OK) {
             ESP_LOGI(CONFIG_TAG, "No configuration changes to save");
         }
+        _config_schedule_persist_nolock();
 
         BaseType_t give_ret = xSemaphoreGive(config_mutex);
 
@@ -169,167 +205,334 @@ esp_err_t config_save(void){
 
 
 /**
- * @brief Save the configuration to NVS if it has changed.
+ * @brief Load the configuration from NVS.
  *
- * Compares current configuration with last saved one and writes
- * only the modified fields to NVS. Access is protected by mutex.
+ * Every persisted field of the schema is read from its NVS key. Fields
+ * that cannot be read, and fields that are not persisted, get their
+ * schema default.
  *
- * @return ESP_OK if any value was saved, ESP_FAIL if nothing changed
- *         or mutex could not be acquired.
+ * @return ESP_OK if every persisted field was loaded, ESP_FAIL otherwise.
  */
 static esp_err_t _config_read(void)
 {
-    /* Load existing configuration from NVS */
-    size_t len = CONFIG_SSID_BUF_SZ;
-	esp_err_t ret = ESP_OK;
-	
-    esp_err_t ret_load = nvs_load_ssid(cfg.ssid, &len);
-    if (ret_load != ESP_OK)
-    {
-        cfg.ssid[0] = '\0';
-		ret = ESP_FAIL;
-    }
+    esp_err_t ret = ESP_OK;
 
-    len = CONFIG_WPA_PASSPHRASE_BUF_SZ;
-    ret_load = nvs_load_wpa_passphrase(cfg.wpa_passphrase, &len);
-    if (ret_load != ESP_OK)
-    {
-        cfg.wpa_passphrase[0] = '\0';
-		ret = ESP_FAIL;
-    }
+    for (uint8_t i = 0U; i < (uint8_t)CONFIG_FIELD_COUNT; i++) {
+        const config_field_t *field = &config_fields[i];
+        esp_err_t ret_load = ESP_FAIL;
 
-    ret_load = nvs_load_mode(&cfg.mode);
-    if (ret_load != ESP_OK)
-    {
-        cfg.mode = 0;
-		ret = ESP_FAIL;
-    }
-	
-    ret_load = nvs_load_ntp(&cfg.ntp);
-    if (ret_load != ESP_OK)
-    {
-        cfg.ntp = 0;
-		ret = ESP_FAIL;
-    }
-	
-    cfg.time.hours = CONFIG_CLOCK_DEFAULT_HOURS;
-    cfg.time.minutes = CONFIG_CLOCK_DEFAULT_MINUTES;
-    cfg.time.seconds = CONFIG_CLOCK_DEFAULT_SECONDS;
+        if (field->nvs_key != CONFIG_NVS_NONE) {
+            if (field->type == CONFIG_FIELD_STR) {
+                size_t len = field->size;
+                ret_load = nvs_load_str(field->nvs_key, (char *)config_field_ptr(&cfg, field), &len);
+            }
+            else {
+                ret_load = nvs_load_value(field->nvs_key, (uint8_t *)config_field_ptr(&cfg, field));
+            }
 
-    ret_load = nvs_load_dutycycle(&cfg.dutycycle);
-    if (ret_load != ESP_OK)
-    {
-        cfg.dutycycle = CONFIG_PWM_DEFAULT_DUTYCYCLE;
-		ret = ESP_FAIL;
+            if (ret_load != ESP_OK) {
+                ret = ESP_FAIL;
+            }
+        }
+
+        if (ret_load != ESP_OK) {
+            config_field_set_default(&cfg, field);
+        }
     }
 
     return ret;
 }
 
 /**
- * @brief Save configuration fields that have changed without taking a mutex.
+ * @brief Publish events for configuration fields that have changed without taking a mutex.
  *
  * This function compares the current configuration `cfg` with the previous
- * configuration `cfg_last` and saves only the fields that have changed to NVS.
+ * configuration `cfg_last` and publishes, once each, the change events that
+ * the schema associates with the modified fields. Nothing is written to NVS
+ * here, see _config_persist_nolock().
  * 
  * **Important:** This function does not take any mutex. The caller must ensure
  * thread safety if called from multiple tasks.
  *
  * @return
- * - ESP_OK if at least one field was successfully saved.
- * - ESP_FAIL if no field was saved or if all save operations failed.
+ * - ESP_OK if at least one field has changed.
+ * - ESP_FAIL if no field has changed.
  */
 static esp_err_t _config_save_nolock(void)
 {
     esp_err_t ret = ESP_FAIL;
-    esp_err_t ret_save;
-    bool wifi_changed = false;
-    bool ntp_changed = false;
+    uint32_t changed_events = 0U;
 
-    if (strcmp(cfg.ssid, cfg_last.ssid) != 0)
-    {
-        ret_save = nvs_save_ssid(cfg.ssid);
-        if (ret_save == ESP_OK)
-        {
-            wifi_changed = true;
+    for (uint8_t i = 0U; i < (uint8_t)CONFIG_FIELD_COUNT; i++) {
+        const config_field_t *field = &config_fields[i];
+        if (config_field_equal(&cfg, &cfg_last, field) == false) {
+            if (field->event != EVT_NONE) {
+                changed_events |= (1UL << field->event);
+            }
             ret = ESP_OK;
         }
     }
 
-    if (strcmp(cfg.wpa_passphrase, cfg_last.wpa_passphrase) != 0)
+    if (cfg.ntp == 0U)
     {
-        ret_save = nvs_save_wpa_passphrase(cfg.wpa_passphrase);
-        if (ret_save == ESP_OK)
-        {
-            wifi_changed = true;
-            ret = ESP_OK;
-        }
+        /* Update clock in manual time setup mode, even if the time is unchanged */
+        changed_events |= (1UL << EVT_CLOCK_WEB_CONFIG);
     }
 
-    if (cfg.mode != cfg_last.mode)
-    {
-        ret_save = nvs_save_mode(cfg.mode);
-        if (ret_save == ESP_OK)
-        {
-            ret = ESP_OK;
+    for (event_bus_event_t evt = 0U; evt < 32U; evt++) {
+        if ((changed_events & (1UL << evt)) != 0U) {
+            event_bus_publish(evt, EVENT_BUS_BUFFER_NONE);
         }
     }
 
-    if (cfg.ntp != cfg_last.ntp)
-    {
-        ret_save = nvs_save_ntp(cfg.ntp);
-        if (ret_save == ESP_OK)
-        {
-            ntp_changed = true;
-            ret = ESP_OK;
+    /* Update previous config */
+    cfg_last = cfg;
+
+    return ret;
+}
+
+/**
+ * @brief Count the persisted fields that differ from the NVS content.
+ *
+ * **Important:** This function does not take any mutex.
+ *
+ * @return Number of NVS keys that a flush would write.
+ */
+static uint32_t _config_count_unpersisted_nolock(void)
+{
+    uint32_t count = 0U;
+
+    for (uint8_t i = 0U; i < (uint8_t)CONFIG_FIELD_COUNT; i++) {
+        const config_field_t *field = &config_fields[i];
+        if ((field->nvs_key != CONFIG_NVS_NONE) && (config_field_equal(&cfg, &cfg_persisted, field) == false)) {
+            count++;
         }
     }
 
-    if (cfg.dutycycle != cfg_last.dutycycle)
-    {
-        ret_save = nvs_save_dutycycle(cfg.dutycycle);
-        if (ret_save == ESP_OK)
-        {
-            event_bus_message_t evt_message;
-            evt_message.type = EVT_PWM_CONFIG;
-            evt_message.payload_size = 0U;
-            event_bus_publish(evt_message);
+    return count;
+}
 
-            ret = ESP_OK;
+/**
+ * @brief Write the fields that differ from the NVS content without taking a mutex.
+ *
+ * Compares `cfg` with `cfg_persisted`, the image of what is stored in NVS,
+ * and writes only the modified keys. `cfg_persisted` is updated for every
+ * key successfully written, so a failed key is retried on the next flush.
+ *
+ * **Important:** This function does not take any mutex.
+ *
+ * @return Number of NVS keys successfully written.
+ */
+static uint32_t _config_persist_nolock(void)
+{
+    uint32_t written = 0U;
+    uint32_t attempted = 0U;
+
+    for (uint8_t i = 0U; i < (uint8_t)CONFIG_FIELD_COUNT; i++) {
+        const config_field_t *field = &config_fields[i];
+
+        if ((field->nvs_key != CONFIG_NVS_NONE) && (config_field_equal(&cfg, &cfg_persisted, field) == false)) {
+            esp_err_t ret_save = ESP_FAIL;
+
+            attempted++;
+            if (field->type == CONFIG_FIELD_STR) {
+                ret_save = nvs_save_str(field->nvs_key, config_field_get_str(&cfg, field));
+            }
+            else {
+                ret_save = nvs_save_value(field->nvs_key, config_field_get_u8(&cfg, field));
+            }
+
+            if (ret_save == ESP_OK) {
+                config_field_copy(&cfg_persisted, &cfg, field);
+                written++;
+            }
         }
     }
 
-    if (wifi_changed == true)
-    {
-        event_bus_message_t evt_message;
-        evt_message.type = EVT_WIFI_CONFIG;
-        evt_message.payload_size = 0U;
-        event_bus_publish(evt_message);
+    /* Every requested write that did not reach the flash was coalesced */
+    if (config_pending_writes > attempted) {
+        config_stats.writes_avoided += config_pending_writes - attempted;
     }
+    config_pending_writes = 0U;
+    config_stats.nvs_writes += written;
+    config_stats.flushes++;
+    config_dirty = (written < attempted);
 
-    if (ntp_changed == true)
-    {
-        event_bus_message_t evt_message;
-        evt_message.type = EVT_NTP_CONFIG;
-        evt_message.payload_size = 0U;
-        event_bus_publish(evt_message);
+    return written;
+}
+
+/**
+ * @brief Arm the write-behind timer for the pending configuration changes.
+ *
+ * The deadline is pushed back by CONFIG_PERSIST_QUIET_MS on every change,
+ * but never beyond CONFIG_PERSIST_MAX_DELAY_MS after the first unsaved one.
+ *
+ * **Important:** This function does not take any mutex.
+ */
+static void _config_schedule_persist_nolock(void)
+{
+    uint32_t unpersisted = _config_count_unpersisted_nolock();
+
+    if (unpersisted > 0U) {
+        int64_t now = esp_timer_get_time();
+
+        config_pending_writes += unpersisted;
+        if (config_dirty == false) {
+            config_dirty = true;
+            config_dirty_since_us = now;
+        }
+
+        int64_t deadline = now + CONFIG_MS_TO_US(CONFIG_PERSIST_QUIET_MS);
+        int64_t max_deadline = config_dirty_since_us + CONFIG_MS_TO_US(CONFIG_PERSIST_MAX_DELAY_MS);
+        if (deadline > max_deadline) {
+            deadline = max_deadline;
+        }
+        if (deadline < now) {
+            deadline = now;
+        }
+
+        if (config_persist_timer != NULL) {
+            (void)esp_timer_stop(config_persist_timer);
+            if (esp_timer_start_once(config_persist_timer, (uint64_t)(deadline - now)) != ESP_OK) {
+                ESP_LOGE(CONFIG_TAG, "Failed to arm persist timer, writing now");
+                (void)_config_persist_nolock();
+            }
+        }
+        else {
+            (void)_config_persist_nolock();
+        }
     }
+}
 
-    if (cfg.ntp == 0U)
-    {
-        /* Update clock in manual time setup mode */
-        event_bus_message_t evt_message;
-        evt_message.type = EVT_CLOCK_WEB_CONFIG;
-        evt_message.payload_size = 0U;
-        event_bus_publish(evt_message);
+/**
+ * @brief Write the pending configuration changes to NVS now.
+ *
+ * Cancels the write-behind timer. Called on EVT_CONFIG_PERSIST when the
+ * timer expires, on shutdown, and by anyone who needs the NVS content to
+ * be up to date.
+ *
+ * @return ESP_OK if NVS is up to date, ESP_ERR_TIMEOUT if the mutex could
+ *         not be acquired, ESP_FAIL if a write failed.
+ */
+esp_err_t config_flush(void)
+{
+    return _config_flush(CONFIG_MUTEX_TIMEOUT);
+}
+
+/**
+ * @brief Flush the pending changes, waiting at most timeout for the mutex.
+ *
+ * @param timeout Ticks to wait for config_mutex.
+ *
+ * @return ESP_OK if NVS is up to date, ESP_ERR_TIMEOUT if the mutex could
+ *         not be acquired in time, ESP_FAIL if a write failed.
+ */
+static esp_err_t _config_flush(TickType_t timeout)
+{
+    esp_err_t ret = ESP_FAIL;
+
+    if (config_mutex != NULL) {
+        BaseType_t taken = xSemaphoreTake(config_mutex, timeout);
+        if (taken != pdTRUE) {
+            ret = ESP_ERR_TIMEOUT;
+        }
+        else {
+            if (config_persist_timer != NULL) {
+                (void)esp_timer_stop(config_persist_timer);
+            }
+
+            if (config_dirty == true) {
+                uint32_t written = _config_persist_nolock();
+                ESP_LOGI(CONFIG_TAG, "Flushed %u key(s), %u write(s) avoided so far",
+                         (unsigned)written, (unsigned)config_stats.writes_avoided);
+            }
+            ret = (config_dirty == false) ? ESP_OK : ESP_FAIL;
+
+            BaseType_t give_ret = xSemaphoreGive(config_mutex);
+            if (give_ret != pdTRUE) {
+                ESP_LOGE(CONFIG_TAG, "Failed to give config mutex in flush");
+                ret = ESP_FAIL;
+            }
+        }
     }
 
-    /* Update previous config */
-    cfg_last = cfg;
+    return ret;
+}
+
+/**
+ * @brief Get the write-behind persistence counters.
+ *
+ * @param[out] stats Pointer to a config_persist_stats_t structure to fill.
+ *
+ * @return ESP_OK if copy succeeded, ESP_ERR_INVALID_ARG if stats is NULL,
+ *         ESP_FAIL if mutex could not be acquired.
+ */
+esp_err_t config_get_persist_stats(config_persist_stats_t *stats)
+{
+    esp_err_t ret = ESP_ERR_INVALID_ARG;
+
+    if (stats != NULL) {
+        ret = ESP_FAIL;
+        BaseType_t taken = xSemaphoreTake(config_mutex, CONFIG_MUTEX_TIMEOUT);
+        if (taken == pdTRUE) {
+            *stats = config_stats;
+            if (xSemaphoreGive(config_mutex) == pdTRUE) {
+                ret = ESP_OK;
+            }
+        }
+    }
 
     return ret;
 }
 
+/**
+ * @brief Write-behind timer callback, runs in the esp_timer task.
+ *
+ * Only publishes EVT_CONFIG_PERSIST: NVS writes erase flash for tens to
+ * hundreds of ms and would hold every other esp_timer callback back.
+ *
+ * @param arg Unused.
+ */
+static void config_persist_timer_cb(void *arg)
+{
+    (void)arg;
+    event_bus_publish(EVT_CONFIG_PERSIST, EVENT_BUS_BUFFER_NONE);
+}
+
+/**
+ * @brief Write the pending changes to NVS, on EVT_CONFIG_PERSIST.
+ *
+ * Subscribe it on a context that may block, such as the worker pool.
+ */
+void config_persist_callback(uint8_t* payload, uint16_t size)
+{
+    (void)payload;
+    (void)size;
+    (void)config_flush();
+}
+
+/**
+ * @brief Shutdown handler, flushes pending changes before esp_restart().
+ *
+ * Waits a bounded time for the mutex: a holder that never gives it back
+ * must not turn a restart into a hang. Changes still pending are lost.
+ */
+static void config_shutdown_handler(void)
+{
+    esp_err_t ret = _config_flush(pdMS_TO_TICKS(CONFIG_SHUTDOWN_FLUSH_TIMEOUT_MS));
+
+    if (ret == ESP_ERR_TIMEOUT) {
+        ESP_LOGE(CONFIG_TAG, "Config mutex not free after %u ms, restarting without flushing",
+                 (unsigned)CONFIG_SHUTDOWN_FLUSH_TIMEOUT_MS);
+    }
+    else if (ret != ESP_OK) {
+        ESP_LOGE(CONFIG_TAG, "Flush on shutdown failed, pending changes lost");
+    }
+    else {
+        /* NVS is up to date */
+    }
+}
+
 /**
  * @brief Get a copy of the current configuration.
  *
@@ -388,7 +591,10 @@ esp_err_t config_set_config(const config_t *config)
 
     BaseType_t taken = xSemaphoreTake(config_mutex, CONFIG_MUTEX_TIMEOUT);
     if (taken == pdTRUE) {
-        cfg = *config;
+        if (memcmp(&cfg, config, sizeof(cfg)) != 0) {
+            cfg = *config;
+            (void)atomic_fetch_add_explicit(&config_generation, 1U, memory_order_release);
+        }
         BaseType_t give_ret = xSemaphoreGive(config_mutex);
         if (give_ret != pdTRUE) {
             ESP_LOGE(CONFIG_TAG, "Failed to give config mutex in init");
@@ -401,3 +607,21 @@ esp_err_t config_set_config(const config_t *config)
 
     return result;
 }
+
+/**
+ * @brief Get the generation of the configuration in RAM.
+ *
+ * The value changes every time the configuration changes, so callers
+ * can keep data derived from it and call config_get_copy() only when
+ * the generation differs. It does not take the config mutex.
+ *
+ * Read the generation before the copy: if the configuration changes
+ * in between, the copy is newer than its generation and is refreshed
+ * again on the next check.
+ *
+ * @return Current generation.
+ */
+uint32_t config_get_generation(void)
+{
+    return (uint32_t)atomic_load_explicit(&config_generation, memory_order_acquire);
+}
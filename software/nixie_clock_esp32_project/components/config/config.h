@@ -25,6 +25,8 @@
 #define CONFIG_WPA_PASSPHRASE_BUF_SZ     (CONFIG_WPA_PASSPHRASE_SIZE + 1U)
 #define CONFIG_MODE_ANTIPOISONING        (1U)
 #define CONFIG_MODE_TEST                 (2U)
+#define CONFIG_PERSIST_QUIET_MS          (3000U)
+#define CONFIG_PERSIST_MAX_DELAY_MS      (15000U)
 
 /******************************************************************
  * 3. Typedef definitions (simple typedef, then enum and structs)
@@ -38,6 +40,13 @@ typedef struct {
     uint8_t dutycycle;
 } config_t;
 
+typedef struct {
+    uint32_t save_requests;     /* Calls to config_save() */
+    uint32_t flushes;           /* Write-behind flushes to NVS */
+    uint32_t nvs_writes;        /* NVS keys actually written */
+    uint32_t writes_avoided;    /* NVS key writes coalesced away */
+} config_persist_stats_t;
+
 /******************************************************************
  * 4. Variable definitions (static then global)
 ******************************************************************/
@@ -55,5 +64,9 @@ esp_err_t config_init(void);
 esp_err_t config_save(void);
 esp_err_t config_get_copy(config_t *copy);
 esp_err_t config_set_config(const config_t *config);
+esp_err_t config_flush(void);
+void config_persist_callback(uint8_t* payload, uint16_t size);
+esp_err_t config_get_persist_stats(config_persist_stats_t *stats);
+uint32_t config_get_generation(void);
 
 #endif // CONFIG_H
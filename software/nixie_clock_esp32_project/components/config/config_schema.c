@@ -0,0 +1,208 @@
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#ifdef STATIC_ANALYSIS
+#include "../test/common/esp_stub.h"
+#endif
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config_schema.h"
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+#define CONFIG_FIELD_EVENT_CHECK(id, key, member, type, min, max, def, nvs_key, event, flags) \
+    _Static_assert((event) < 32U, "config change events are collected in a 32-bit mask");
+#define CONFIG_FIELD_DESCRIPTOR(id, key, member, type, min, max, def, nvs_key, event, flags) \
+    { (key), (nvs_key), (type), (uint16_t)offsetof(config_t, member), \
+      (uint16_t)sizeof(((config_t *)NULL)->member), (min), (max), (def), (event), (flags) },
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+const config_field_t config_fields[CONFIG_FIELD_COUNT] = {
+    CONFIG_SCHEMA(CONFIG_FIELD_DESCRIPTOR)
+};
+
+CONFIG_SCHEMA(CONFIG_FIELD_EVENT_CHECK)
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+static const void *config_field_cptr(const config_t *config, const config_field_t *field);
+
+/******************************************************************
+ * 6. Functions definitions
+******************************************************************/
+
+/**
+ * @brief Find a field descriptor by its web/API key.
+ *
+ * @param key Null-terminated key, e.g. "dutycycle".
+ *
+ * @return Pointer to the descriptor, NULL if the key is unknown.
+ */
+const config_field_t *config_field_find(const char *key)
+{
+    const config_field_t *found = NULL;
+
+    if (key != NULL) {
+        for (uint8_t i = 0U; i < (uint8_t)CONFIG_FIELD_COUNT; i++) {
+            if (strcmp(config_fields[i].key, key) == 0) {
+                found = &config_fields[i];
+                break;
+            }
+        }
+    }
+
+    return found;
+}
+
+/**
+ * @brief Get a writable pointer to the storage of a field.
+ *
+ * @param config Configuration holding the field.
+ * @param field Field descriptor.
+ *
+ * @return Pointer to the field inside config.
+ */
+void *config_field_ptr(config_t *config, const config_field_t *field)
+{
+    return &((uint8_t *)config)[field->offset];
+}
+
+/**
+ * @brief Get a read-only pointer to the storage of a field.
+ */
+static const void *config_field_cptr(const config_t *config, const config_field_t *field)
+{
+    return &((const uint8_t *)config)[field->offset];
+}
+
+/**
+ * @brief Read a CONFIG_FIELD_U8 field.
+ */
+uint8_t config_field_get_u8(const config_t *config, const config_field_t *field)
+{
+    return *(const uint8_t *)config_field_cptr(config, field);
+}
+
+/**
+ * @brief Read a CONFIG_FIELD_STR field.
+ */
+const char *config_field_get_str(const config_t *config, const config_field_t *field)
+{
+    return (const char *)config_field_cptr(config, field);
+}
+
+/**
+ * @brief Compare one field of two configurations.
+ *
+ * @return true if the field holds the same value in both.
+ */
+bool config_field_equal(const config_t *a, const config_t *b, const config_field_t *field)
+{
+    bool equal = false;
+
+    if (field->type == CONFIG_FIELD_STR) {
+        equal = (strncmp(config_field_get_str(a, field), config_field_get_str(b, field), field->size) == 0);
+    }
+    else {
+        equal = (config_field_get_u8(a, field) == config_field_get_u8(b, field));
+    }
+
+    return equal;
+}
+
+/**
+ * @brief Copy one field from a configuration to another.
+ */
+void config_field_copy(config_t *dst, const config_t *src, const config_field_t *field)
+{
+    (void)memcpy(config_field_ptr(dst, field), config_field_cptr(src, field), field->size);
+}
+
+/**
+ * @brief Reset one field to its schema default.
+ */
+void config_field_set_default(config_t *config, const config_field_t *field)
+{
+    if (field->type == CONFIG_FIELD_STR) {
+        (void)memset(config_field_ptr(config, field), 0, field->size);
+    }
+    else {
+        *(uint8_t *)config_field_ptr(config, field) = field->default_value;
+    }
+}
+
+/**
+ * @brief Set a CONFIG_FIELD_U8 field after range validation.
+ *
+ * @param config Configuration to update.
+ * @param field Field descriptor.
+ * @param value New value.
+ *
+ * @return ESP_OK if stored, ESP_ERR_INVALID_ARG if the value is out of
+ *         range or the field is not numeric.
+ */
+esp_err_t config_field_set_u8(config_t *config, const config_field_t *field, long value)
+{
+    esp_err_t ret = ESP_ERR_INVALID_ARG;
+
+    if ((field->type == CONFIG_FIELD_U8) && (value >= (long)field->min) && (value <= (long)field->max)) {
+        *(uint8_t *)config_field_ptr(config, field) = (uint8_t)value;
+        ret = ESP_OK;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Parse and validate a decoded text value into a field.
+ *
+ * Numbers must be complete base-10 integers within [min, max].
+ * Strings must be at most max characters long.
+ *
+ * @param config Configuration to update, untouched on error.
+ * @param field Field descriptor.
+ * @param value Null-terminated, already URL-decoded, value.
+ *
+ * @return ESP_OK if stored, ESP_ERR_INVALID_ARG on a malformed or
+ *         out-of-range number, ESP_ERR_INVALID_SIZE on a too long string.
+ */
+esp_err_t config_field_set_from_str(config_t *config, const config_field_t *field, const char *value)
+{
+    esp_err_t ret = ESP_ERR_INVALID_ARG;
+
+    if ((config != NULL) && (field != NULL) && (value != NULL)) {
+        if (field->type == CONFIG_FIELD_STR) {
+            size_t len = strnlen(value, (size_t)field->size);
+            if (len <= (size_t)field->max) {
+                char *dst = (char *)config_field_ptr(config, field);
+                (void)memcpy(dst, value, len);
+                dst[len] = '\0';
+                ret = ESP_OK;
+            }
+            else {
+                ret = ESP_ERR_INVALID_SIZE;
+            }
+        }
+        else {
+            char *endptr = NULL;
+            errno = 0;  /* Reset errno before calling strtol */
+            const long tmp_val = strtol(value, &endptr, 10);
+            /* Check for successful numeric conversion */
+            if ((endptr != value) && (*endptr == '\0') && (errno == 0)) {
+                ret = config_field_set_u8(config, field, tmp_val);
+            }
+        }
+    }
+
+    return ret;
+}
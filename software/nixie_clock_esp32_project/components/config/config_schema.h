@@ -0,0 +1,92 @@
+#ifndef CONFIG_SCHEMA_H
+#define CONFIG_SCHEMA_H
+
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#include <stdbool.h>
+#include "esp_err.h"
+#include "config.h"
+#include "../event_bus/event_bus.h"
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+typedef uint8_t config_field_type_t;
+#define CONFIG_FIELD_U8                  ((config_field_type_t)0U)
+#define CONFIG_FIELD_STR                 ((config_field_type_t)1U)
+
+/* Field is an HTML checkbox: absent from the form means its minimum */
+#define CONFIG_FIELD_FLAG_CHECKBOX       (0x01U)
+/* Field is a secret, never sent back in clear text */
+#define CONFIG_FIELD_FLAG_SECRET         (0x02U)
+
+/* No NVS key: the field lives in RAM only */
+#define CONFIG_NVS_NONE                  (NULL)
+
+/**
+ * Configuration schema, one line per field of config_t.
+ *
+ * X(id, key, member, type, min, max, default, nvs_key, event, flags)
+ * - key:     name used by the web form and the API
+ * - member:  config_t member, may be nested
+ * - min/max: value range for CONFIG_FIELD_U8, length range for CONFIG_FIELD_STR
+ * - nvs_key: NVS key, CONFIG_NVS_NONE if not persisted
+ * - event:   event published when the field changes, EVT_NONE if none
+ */
+#define CONFIG_SCHEMA(X) \
+    X(SSID,           "ssid",           ssid,           CONFIG_FIELD_STR, 0U, CONFIG_SSID_SIZE,           0U,                           "ssid",           EVT_WIFI_CONFIG,      0U) \
+    X(WPA_PASSPHRASE, "wpa-passphrase", wpa_passphrase, CONFIG_FIELD_STR, 0U, CONFIG_WPA_PASSPHRASE_SIZE, 0U,                           "wpa_passphrase", EVT_WIFI_CONFIG,      CONFIG_FIELD_FLAG_SECRET) \
+    X(MODE,           "mode",           mode,           CONFIG_FIELD_U8,  0U, CONFIG_MODE_TEST,           CONFIG_MODE_DEFAULT,          "mode",           EVT_NONE,             0U) \
+    X(NTP,            "ntp",            ntp,            CONFIG_FIELD_U8,  0U, 1U,                         CONFIG_NTP_DEFAULT,           "ntp",            EVT_NTP_CONFIG,       CONFIG_FIELD_FLAG_CHECKBOX) \
+    X(HOURS,          "hours",          time.hours,     CONFIG_FIELD_U8,  0U, 23U,                        CONFIG_CLOCK_DEFAULT_HOURS,   CONFIG_NVS_NONE,  EVT_CLOCK_WEB_CONFIG, 0U) \
+    X(MINUTES,        "minutes",        time.minutes,   CONFIG_FIELD_U8,  0U, 59U,                        CONFIG_CLOCK_DEFAULT_MINUTES, CONFIG_NVS_NONE,  EVT_CLOCK_WEB_CONFIG, 0U) \
+    X(SECONDS,        "seconds",        time.seconds,   CONFIG_FIELD_U8,  0U, 59U,                        CONFIG_CLOCK_DEFAULT_SECONDS, CONFIG_NVS_NONE,  EVT_CLOCK_WEB_CONFIG, 0U) \
+    X(DUTYCYCLE,      "dutycycle",      dutycycle,      CONFIG_FIELD_U8,  0U, 255U,                       CONFIG_PWM_DEFAULT_DUTYCYCLE, "dutycycle",      EVT_PWM_CONFIG,       0U)
+
+#define CONFIG_FIELD_ENUM(id, key, member, type, min, max, def, nvs_key, event, flags)  CONFIG_FIELD_ID_##id,
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+typedef enum {
+    CONFIG_SCHEMA(CONFIG_FIELD_ENUM)
+    CONFIG_FIELD_COUNT
+} config_field_id_t;
+
+typedef struct {
+    const char *key;
+    const char *nvs_key;
+    config_field_type_t type;
+    uint16_t offset;
+    uint16_t size;
+    uint8_t min;
+    uint8_t max;
+    uint8_t default_value;
+    event_bus_event_t event;
+    uint8_t flags;
+} config_field_t;
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+extern const config_field_t config_fields[CONFIG_FIELD_COUNT];
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+
+/******************************************************************
+ * 6. Functions definitions (public API in .c)
+******************************************************************/
+const config_field_t *config_field_find(const char *key);
+bool config_field_equal(const config_t *a, const config_t *b, const config_field_t *field);
+void config_field_copy(config_t *dst, const config_t *src, const config_field_t *field);
+void config_field_set_default(config_t *config, const config_field_t *field);
+esp_err_t config_field_set_u8(config_t *config, const config_field_t *field, long value);
+esp_err_t config_field_set_from_str(config_t *config, const config_field_t *field, const char *value);
+void *config_field_ptr(config_t *config, const config_field_t *field);
+uint8_t config_field_get_u8(const config_t *config, const config_field_t *field);
+const char *config_field_get_str(const config_t *config, const config_field_t *field);
+
+#endif // CONFIG_SCHEMA_H
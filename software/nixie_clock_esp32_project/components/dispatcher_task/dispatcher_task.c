@@ -1,36 +1,93 @@
 /******************************************************************
  * 1. Included files (microcontroller ones then user defined ones)
  ******************************************************************/
+#include <stdio.h>
 #include "esp_task_wdt.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
 #include "freertos/semphr.h"
+#include "freertos/task.h"
 #include "event_bus.h"
 #include "dispatcher_task.h"
+#include "../mem_budget/mem_budget.h"
 
 /******************************************************************
  * 2. Define declarations (macros then function macros)
  ******************************************************************/
-#define DISPATCHERTASK_MAX_SUBSCRIBERS    (16U)
+#define DISPATCHERTASK_MAX_SUBSCRIBERS      (24U)
+#define DISPATCHERTASK_NO_SUBSCRIBER        (0U)    /* Subscriber links are index + 1 */
+#define DISPATCHERTASK_SLOW_CALLBACK_US     (20000U)
+
+#define DISPATCHERTASK_PRIORITY             (5U)
+#define DISPATCHERTASK_STACK_SIZE           MEM_BUDGET_DISPATCHER_STACK_SIZE
+
+/* Shared worker pool, for handlers that may run in any order */
+#define DISPATCHERTASK_POOL_WORKERS         MEM_BUDGET_DISPATCHER_POOL_WORKERS
+#define DISPATCHERTASK_POOL_QUEUE_SIZE      MEM_BUDGET_DISPATCHER_POOL_QUEUE_SIZE
+#define DISPATCHERTASK_POOL_PRIORITY        (4U)
+#define DISPATCHERTASK_POOL_STACK_SIZE      MEM_BUDGET_DISPATCHER_POOL_STACK_SIZE
+
+/* Dedicated workers, one task per subscriber for blocking handlers */
+#define DISPATCHERTASK_MAX_DEDICATED        MEM_BUDGET_DISPATCHER_MAX_DEDICATED
+#define DISPATCHERTASK_DEDICATED_QUEUE_SIZE MEM_BUDGET_DISPATCHER_DEDICATED_QUEUE_SIZE
+#define DISPATCHERTASK_DEDICATED_PRIORITY   (3U)
+#define DISPATCHERTASK_DEDICATED_STACK_SIZE MEM_BUDGET_DISPATCHER_DEDICATED_STACK_SIZE
 
 /******************************************************************
  * 3. Typedef definitions (simple typedef, then enum and structs)
  ******************************************************************/
 typedef struct
 {
-  event_bus_event_t evt_type;
   event_callback_t cb;
+  dispatcher_context_t context;
+  uint8_t next;   /* Next subscriber of the same event, DISPATCHERTASK_NO_SUBSCRIBER if last */
+  QueueHandle_t queue;  /* Worker queue for DISPATCHER_CONTEXT_DEDICATED, NULL otherwise */
 } subscriber_t;
 
+typedef struct
+{
+  uint8_t head;
+  uint8_t tail;
+} subscriber_list_t;
+
+/* Deferred callback invocation, owns one reference on the payload */
+typedef struct
+{
+  event_callback_t cb;
+  event_bus_event_t type;
+  event_bus_buffer_t payload;
+} dispatcher_job_t;
+
 /******************************************************************
  * 4. Variable definitions (static then global)
  ******************************************************************/
+static const char DISPATCHER_TAG[] = "DISPATCHER";
 static subscriber_t subscribers[DISPATCHERTASK_MAX_SUBSCRIBERS];
+static subscriber_list_t subscriber_lists[EVT_COUNT];
 static uint8_t subscriber_count = 0U;
+static uint8_t dedicated_count = 0U;
+static QueueHandle_t pool_queue = NULL;
+
+/* Static storage of the dispatcher task and its workers, see mem_budget.h */
+static StackType_t dispatcher_stack[DISPATCHERTASK_STACK_SIZE];
+static StaticTask_t dispatcher_tcb;
+static StackType_t dispatcher_pool_stack[DISPATCHERTASK_POOL_WORKERS][DISPATCHERTASK_POOL_STACK_SIZE];
+static StaticTask_t dispatcher_pool_tcb[DISPATCHERTASK_POOL_WORKERS];
+static uint8_t dispatcher_pool_queue_storage[DISPATCHERTASK_POOL_QUEUE_SIZE * sizeof(dispatcher_job_t)];
+static StaticQueue_t dispatcher_pool_queue_buffer;
+static StackType_t dispatcher_dedicated_stack[DISPATCHERTASK_MAX_DEDICATED][DISPATCHERTASK_DEDICATED_STACK_SIZE];
+static StaticTask_t dispatcher_dedicated_tcb[DISPATCHERTASK_MAX_DEDICATED];
+static uint8_t dispatcher_dedicated_queue_storage[DISPATCHERTASK_MAX_DEDICATED][DISPATCHERTASK_DEDICATED_QUEUE_SIZE * sizeof(dispatcher_job_t)];
+static StaticQueue_t dispatcher_dedicated_queue_buffer[DISPATCHERTASK_MAX_DEDICATED];
 
 /******************************************************************
  * 5. Functions prototypes (static only)
  ******************************************************************/
+static void dispatcher_run(event_callback_t cb, event_bus_event_t type, event_bus_buffer_t payload);
+static void dispatcher_defer(const subscriber_t *subscriber, event_bus_event_t type, event_bus_buffer_t payload);
+static void dispatcher_worker(void *arg);
 
 /******************************************************************
  * 6. Functions definitions
@@ -38,13 +95,105 @@ static uint8_t subscriber_count = 0U;
 
 /**
  * @brief Subscribe a callback to a specific event
+ *
+ * Subscribers are kept in one list per event type, in subscription order,
+ * so dispatching an event only visits its own subscribers. Must be called
+ * before dispatcher_task_start().
+ *
+ * @param evt_type Event to subscribe to.
+ * @param cb Callback.
+ * @param context Where the callback runs:
+ *        - DISPATCHER_CONTEXT_INLINE: on the dispatcher task, for short
+ *          latency-sensitive handlers
+ *        - DISPATCHER_CONTEXT_POOL: on the shared worker pool, for handlers
+ *          that do not depend on their relative order
+ *        - DISPATCHER_CONTEXT_DEDICATED: on a task of its own, for handlers
+ *          that block, events are handled in order
  */
-void dispatcher_subscribe(event_bus_event_t evt_type, event_callback_t cb)
+void dispatcher_subscribe(event_bus_event_t evt_type, event_callback_t cb, dispatcher_context_t context)
 {
-  if (subscriber_count < DISPATCHERTASK_MAX_SUBSCRIBERS) {
-    subscribers[subscriber_count].evt_type = evt_type;
+  if ((evt_type == EVT_NONE) || (evt_type >= EVT_COUNT) || (cb == NULL) || (context > DISPATCHER_CONTEXT_DEDICATED)) {
+    ESP_LOGE(DISPATCHER_TAG, "Invalid subscription to event %u", (unsigned)evt_type);
+  }
+  else if (subscriber_count >= DISPATCHERTASK_MAX_SUBSCRIBERS) {
+    ESP_LOGE(DISPATCHER_TAG, "Too many subscribers, event %u ignored", (unsigned)evt_type);
+  }
+  else if ((context == DISPATCHER_CONTEXT_DEDICATED) && (dedicated_count >= DISPATCHERTASK_MAX_DEDICATED)) {
+    ESP_LOGE(DISPATCHER_TAG, "Too many dedicated workers, event %u ignored", (unsigned)evt_type);
+  }
+  else {
+    subscriber_list_t *list = &subscriber_lists[evt_type];
+
     subscribers[subscriber_count].cb = cb;
+    subscribers[subscriber_count].context = context;
+    subscribers[subscriber_count].next = DISPATCHERTASK_NO_SUBSCRIBER;
+    subscribers[subscriber_count].queue = NULL;
+    if (context == DISPATCHER_CONTEXT_DEDICATED) {
+      dedicated_count++;
+    }
     subscriber_count++;
+
+    /* Append to the event list, subscriber_count is now the new link */
+    if (list->tail == DISPATCHERTASK_NO_SUBSCRIBER) {
+      list->head = subscriber_count;
+    }
+    else {
+      subscribers[list->tail - 1U].next = subscriber_count;
+    }
+    list->tail = subscriber_count;
+  }
+}
+
+/**
+ * @brief Run one callback and record its runtime.
+ */
+static void dispatcher_run(event_callback_t cb, event_bus_event_t type, event_bus_buffer_t payload)
+{
+  int64_t start_us = esp_timer_get_time();
+  cb(event_bus_buffer_data(payload), event_bus_buffer_size(payload));
+  uint32_t runtime_us = (uint32_t)(esp_timer_get_time() - start_us);
+
+  event_bus_record_callback(type, runtime_us);
+  if (runtime_us > DISPATCHERTASK_SLOW_CALLBACK_US) {
+    ESP_LOGW(DISPATCHER_TAG, "Slow callback %p on event %u: %lu us",
+             (void *)cb, (unsigned)type, (unsigned long)runtime_us);
+  }
+}
+
+/**
+ * @brief Hand a callback over to its worker.
+ *
+ * Never blocks the dispatcher: if the worker queue is full the call is
+ * dropped with an error log.
+ */
+static void dispatcher_defer(const subscriber_t *subscriber, event_bus_event_t type, event_bus_buffer_t payload)
+{
+  QueueHandle_t queue = (subscriber->context == DISPATCHER_CONTEXT_POOL) ? pool_queue : subscriber->queue;
+  dispatcher_job_t job = { subscriber->cb, type, payload };
+
+  /* The worker owns its own reference on the payload */
+  event_bus_buffer_retain(payload);
+  if ((queue == NULL) || (xQueueSend(queue, &job, 0U) != pdTRUE)) {
+    event_bus_buffer_release(payload);
+    ESP_LOGE(DISPATCHER_TAG, "Worker busy, callback %p on event %u dropped", (void *)subscriber->cb, (unsigned)type);
+  }
+}
+
+/**
+ * @brief Worker task running deferred callbacks from its queue.
+ *
+ * @param arg Queue of dispatcher_job_t to serve.
+ */
+static void dispatcher_worker(void *arg)
+{
+  QueueHandle_t queue = (QueueHandle_t)arg;
+  dispatcher_job_t job;
+
+  while(1) {
+    if (xQueueReceive(queue, &job, portMAX_DELAY) == pdTRUE) {
+      dispatcher_run(job.cb, job.type, job.payload);
+      event_bus_buffer_release(job.payload);
+    }
   }
 }
 
@@ -66,23 +215,74 @@ static void dispatcher_task(void *arg)
     /* Wait for the next event, not blocking for watchdog */
     event_bus_message_t evt_message = event_bus_wait(pdMS_TO_TICKS(500));
 
-    if (evt_message.type != EVT_NONE) {
-      /* Call all callbacks subscribed to this event */
-      for (uint8_t i = 0; i < subscriber_count; i++) {
-        if (subscribers[i].evt_type == evt_message.type) {
-          if(subscribers[i].cb != NULL) {
-            subscribers[i].cb(evt_message.payload, evt_message.payload_size);
-          }
+    if ((evt_message.type != EVT_NONE) && (evt_message.type < EVT_COUNT)) {
+      /* Call or defer all callbacks subscribed to this event, all share the same buffer */
+      uint8_t link = subscriber_lists[evt_message.type].head;
+      while (link != DISPATCHERTASK_NO_SUBSCRIBER) {
+        const subscriber_t *subscriber = &subscribers[link - 1U];
+        if (subscriber->context == DISPATCHER_CONTEXT_INLINE) {
+          dispatcher_run(subscriber->cb, evt_message.type, evt_message.payload);
         }
+        else {
+          dispatcher_defer(subscriber, evt_message.type, evt_message.payload);
+        }
+        link = subscriber->next;
       }
     }
+
+    /* Drop the reference handed over by the publisher */
+    event_bus_buffer_release(evt_message.payload);
   }
 }
 
 /**
- * @brief Start the dispatcher task
+ * @brief Start the dispatcher task and its workers
+ *
+ * The worker pool is only created if a subscriber uses it, and one task is
+ * created per DISPATCHER_CONTEXT_DEDICATED subscriber.
  */
 void dispatcher_task_start(void)
 {
-  xTaskCreate(dispatcher_task, "dispatcher_task", 4096, NULL, 5, NULL);
-}
\ No newline at end of file
+  bool pool_needed = false;
+  uint8_t dedicated = 0U;
+
+  for (uint8_t i = 0U; i < subscriber_count; i++) {
+    if (subscribers[i].context == DISPATCHER_CONTEXT_POOL) {
+      pool_needed = true;
+    }
+    else if (subscribers[i].context == DISPATCHER_CONTEXT_DEDICATED) {
+      char name[configMAX_TASK_NAME_LEN];
+      (void)snprintf(name, sizeof(name), "dispatch_ded%u", (unsigned)dedicated);
+      /* dispatcher_subscribe() caps dedicated subscribers to DISPATCHERTASK_MAX_DEDICATED */
+      subscribers[i].queue = xQueueCreateStatic(DISPATCHERTASK_DEDICATED_QUEUE_SIZE, sizeof(dispatcher_job_t),
+                                                dispatcher_dedicated_queue_storage[dedicated],
+                                                &dispatcher_dedicated_queue_buffer[dedicated]);
+      if ((subscribers[i].queue == NULL) ||
+          (xTaskCreateStatic(dispatcher_worker, name, DISPATCHERTASK_DEDICATED_STACK_SIZE, subscribers[i].queue,
+                             DISPATCHERTASK_DEDICATED_PRIORITY, dispatcher_dedicated_stack[dedicated],
+                             &dispatcher_dedicated_tcb[dedicated]) == NULL)) {
+        ESP_LOGE(DISPATCHER_TAG, "Failed to create dedicated worker %u", (unsigned)i);
+      }
+      dedicated++;
+    }
+    else {
+      /* DISPATCHER_CONTEXT_INLINE */
+    }
+  }
+
+  if (pool_needed == true) {
+    pool_queue = xQueueCreateStatic(DISPATCHERTASK_POOL_QUEUE_SIZE, sizeof(dispatcher_job_t),
+                                    dispatcher_pool_queue_storage, &dispatcher_pool_queue_buffer);
+    for (uint8_t i = 0U; (pool_queue != NULL) && (i < DISPATCHERTASK_POOL_WORKERS); i++) {
+      char name[configMAX_TASK_NAME_LEN];
+      (void)snprintf(name, sizeof(name), "dispatch_pool%u", (unsigned)i);
+      if (xTaskCreateStatic(dispatcher_worker, name, DISPATCHERTASK_POOL_STACK_SIZE, pool_queue,
+                            DISPATCHERTASK_POOL_PRIORITY, dispatcher_pool_stack[i], &dispatcher_pool_tcb[i]) == NULL) {
+        ESP_LOGE(DISPATCHER_TAG, "Failed to create pool worker %u", (unsigned)i);
+      }
+    }
+  }
+
+  (void)xTaskCreateStatic(dispatcher_task, "dispatcher_task", DISPATCHERTASK_STACK_SIZE, NULL, DISPATCHERTASK_PRIORITY,
+                          dispatcher_stack, &dispatcher_tcb);
+}
@@ -9,11 +9,17 @@
 /******************************************************************
  * 2. Define declarations (macros then function macros)
 ******************************************************************/
+/* Execution context of a subscriber callback */
+typedef uint8_t dispatcher_context_t;
+#define DISPATCHER_CONTEXT_INLINE     ((dispatcher_context_t)0U)  /* On the dispatcher task */
+#define DISPATCHER_CONTEXT_POOL       ((dispatcher_context_t)1U)  /* On the shared worker pool */
+#define DISPATCHER_CONTEXT_DEDICATED  ((dispatcher_context_t)2U)  /* On a task of its own */
 
 /******************************************************************
  * 3. Typedef definitions (simple typedef, then enum and structs)
 ******************************************************************/
-typedef void (*event_callback_t)(uint8_t* payload, uint8_t size);
+/* The payload is only valid during the call, copy what must outlive it */
+typedef void (*event_callback_t)(uint8_t* payload, uint16_t size);
 
 /******************************************************************
  * 4. Variable definitions (static then global)
@@ -26,7 +32,7 @@ typedef void (*event_callback_t)(uint8_t* payload, uint8_t size);
 /******************************************************************
  * 6. Functions definitions
 ******************************************************************/
-void dispatcher_subscribe(event_bus_event_t evt_type, event_callback_t cb);
+void dispatcher_subscribe(event_bus_event_t evt_type, event_callback_t cb, dispatcher_context_t context);
 void dispatcher_task_start(void);
 
 #endif // SERVICE_MANAGER_H
\ No newline at end of file
@@ -4,90 +4,580 @@
 #ifdef STATIC_ANALYSIS
 #include "../test/common/esp_stub.h"
 #endif
+#include <stdio.h>
 #include "event_bus.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "../mem_budget/mem_budget.h"
 
 /******************************************************************
  * 2. Define declarations (macros then function macros)
 ******************************************************************/
-#define EVENT_BUS_QUEUE_SIZE            (32U)
+#define EVENT_BUS_INPUT_QUEUE_SIZE          MEM_BUDGET_EVENT_BUS_INPUT_QUEUE_SIZE
+#define EVENT_BUS_TIME_QUEUE_SIZE           MEM_BUDGET_EVENT_BUS_TIME_QUEUE_SIZE
+#define EVENT_BUS_CONFIG_QUEUE_SIZE         MEM_BUDGET_EVENT_BUS_CONFIG_QUEUE_SIZE
+#define EVENT_BUS_TELEMETRY_QUEUE_SIZE      MEM_BUDGET_EVENT_BUS_TELEMETRY_QUEUE_SIZE
+#define EVENT_BUS_QUEUE_SIZE                (EVENT_BUS_INPUT_QUEUE_SIZE + EVENT_BUS_TIME_QUEUE_SIZE + \
+                                             EVENT_BUS_CONFIG_QUEUE_SIZE + EVENT_BUS_TELEMETRY_QUEUE_SIZE)
+
+#define EVENT_BUS_INPUT_BUDGET_US           (20000U)
+#define EVENT_BUS_TIME_BUDGET_US            (100000U)
+#define EVENT_BUS_CONFIG_BUDGET_US          (500000U)
+#define EVENT_BUS_TELEMETRY_BUDGET_US       (1000000U)
+
+/* Text report: one lane header, one line per lane, one type header, three lines per type */
+#define EVENT_BUS_STATS_TYPE_LINES          (3U)
+#define EVENT_BUS_STATS_FIRST_TYPE_LINE     (EVENT_BUS_LANE_COUNT + 2U)
+#define EVENT_BUS_STATS_LINE_COUNT          (EVENT_BUS_STATS_FIRST_TYPE_LINE + (EVT_COUNT * EVENT_BUS_STATS_TYPE_LINES))
+#define EVENT_BUS_STATS_LOG_LINE_SIZE       (192U)
+
+_Static_assert(EVT_COUNT <= 32U, "pending events are tracked in a 32-bit mask");
 
 /******************************************************************
  * 3. Typedef definitions (simple typedef, then enum and structs)
 ******************************************************************/
+/* Queue item: the message and its publication time */
+typedef struct {
+    event_bus_message_t message;
+    int64_t publish_us;
+} event_bus_item_t;
+
+typedef struct {
+    QueueHandle_t queue;
+    uint8_t size;
+} event_bus_lane_queue_t;
 
 /******************************************************************
  * 4. Variable definitions (static then global)
 ******************************************************************/
-static QueueHandle_t s_event_queue = NULL;
+static const char EVENT_BUS_TAG[] = "EVENT_BUS";
+
+/* Lane of each event type, indexed by event_bus_event_t */
+static const event_bus_lane_t s_event_lanes[EVT_COUNT] = {
+    EVENT_BUS_LANE_TELEMETRY,   /* EVT_NONE */
+    EVENT_BUS_LANE_TIME,        /* EVT_CLOCK_NTP_CONFIG */
+    EVENT_BUS_LANE_INPUT,       /* EVT_CLOCK_GPIO_CONFIG */
+    EVENT_BUS_LANE_CONFIG,      /* EVT_CLOCK_WEB_CONFIG */
+    EVENT_BUS_LANE_CONFIG,      /* EVT_NTP_CONFIG */
+    EVENT_BUS_LANE_CONFIG,      /* EVT_WIFI_CONFIG */
+    EVENT_BUS_LANE_CONFIG,      /* EVT_PWM_CONFIG */
+    EVENT_BUS_LANE_TIME,        /* EVT_TIMER_CLOCK_TICK */
+    EVENT_BUS_LANE_TIME,        /* EVT_TIMER_DISPLAY */
+    EVENT_BUS_LANE_CONFIG,      /* EVT_CONFIG_PERSIST */
+};
+
+static event_bus_lane_queue_t s_lanes[EVENT_BUS_LANE_COUNT] = {
+    { NULL, EVENT_BUS_INPUT_QUEUE_SIZE },
+    { NULL, EVENT_BUS_TIME_QUEUE_SIZE },
+    { NULL, EVENT_BUS_CONFIG_QUEUE_SIZE },
+    { NULL, EVENT_BUS_TELEMETRY_QUEUE_SIZE },
+};
+
+static event_bus_lane_stats_t s_lane_stats[EVENT_BUS_LANE_COUNT] = {
+    { .budget_us = EVENT_BUS_INPUT_BUDGET_US },
+    { .budget_us = EVENT_BUS_TIME_BUDGET_US },
+    { .budget_us = EVENT_BUS_CONFIG_BUDGET_US },
+    { .budget_us = EVENT_BUS_TELEMETRY_BUDGET_US },
+};
+
+static event_bus_type_stats_t s_type_stats[EVT_COUNT];
+
+/* Number of queued events over all lanes, the dispatcher blocks on it */
+static SemaphoreHandle_t s_event_count = NULL;
+
+/* Static storage of the lane queues, lanes are laid out back to back */
+static uint8_t s_event_bus_queue_storage[EVENT_BUS_QUEUE_SIZE * sizeof(event_bus_item_t)];
+static StaticQueue_t s_event_bus_queue_buffer[EVENT_BUS_LANE_COUNT];
+static StaticSemaphore_t s_event_bus_count_buffer;
+static portMUX_TYPE s_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/* Payload-less event types currently queued, one bit per type, under s_stats_lock.
+ * s_stats_lock is also taken from ISRs, hence the _SAFE critical sections
+ * on the publish path. */
+static uint32_t s_pending_mask = 0U;
 
 /******************************************************************
  * 5. Functions prototypes (static only)
 ******************************************************************/
+static bool event_bus_coalesce(event_bus_event_t type, event_bus_lane_t lane);
+static void event_bus_count_drop(event_bus_event_t type, event_bus_lane_t lane, bool coalesce);
+static void event_bus_count_publish(event_bus_event_t type, event_bus_lane_t lane, uint32_t depth);
+static uint8_t event_bus_hist_bucket(uint32_t duration_us);
+static size_t event_bus_format_hist(char *buf, size_t size, const char *name, const uint32_t *hist);
 
 /******************************************************************
  * 6. Functions definitions
 ******************************************************************/
 
 /**
- * @brief Initialize the Event Bus queue.
+ * @brief Initialize the Event Bus queues.
  *
  * This function must be called before any event publication or consumption.
- * It allocates a FreeRTOS queue capable of storing multiple event_bus_message_t
- * messages. Subsequent calls have no effect (idempotent).
+ * It creates one FreeRTOS queue per priority lane and a counting semaphore
+ * tracking the total number of queued events, all from static storage.
+ * Subsequent calls have no effect (idempotent).
  *
  * @note If this function is not called before event_bus_publish(), events
- *       will simply be ignored because the queue does not exist.
+ *       will simply be ignored because the queues do not exist.
  */
 void event_bus_init(void)
 {
-    if (s_event_queue == NULL) {
-        s_event_queue = xQueueCreate(EVENT_BUS_QUEUE_SIZE, sizeof(event_bus_message_t));
+    if (s_event_count == NULL) {
+        uint8_t *storage = s_event_bus_queue_storage;
+
+        for (uint8_t lane = 0U; lane < EVENT_BUS_LANE_COUNT; lane++) {
+            s_lanes[lane].queue = xQueueCreateStatic(s_lanes[lane].size, sizeof(event_bus_item_t),
+                                                     storage, &s_event_bus_queue_buffer[lane]);
+            if (s_lanes[lane].queue == NULL) {
+                ESP_LOGE(EVENT_BUS_TAG, "Failed to create lane %u", (unsigned)lane);
+            }
+            storage += (size_t)s_lanes[lane].size * sizeof(event_bus_item_t);
+        }
+        s_event_count = xSemaphoreCreateCountingStatic(EVENT_BUS_QUEUE_SIZE, 0U, &s_event_bus_count_buffer);
+    }
+}
+
+/**
+ * @brief Get the priority lane of an event type.
+ *
+ * @param type Event type.
+ *
+ * @return The lane the event is queued in, EVENT_BUS_LANE_TELEMETRY for
+ *         unknown types.
+ */
+event_bus_lane_t event_bus_get_lane(event_bus_event_t type)
+{
+    event_bus_lane_t lane = EVENT_BUS_LANE_TELEMETRY;
+
+    if (type < EVT_COUNT) {
+        lane = s_event_lanes[type];
+    }
+
+    return lane;
+}
+
+/**
+ * @brief Mark a payload-less event as pending.
+ *
+ * Payload-less events only tell subscribers to re-read shared state, so
+ * one queued instance is enough. The pending bit is cleared when the
+ * event is dequeued, before its callbacks run, so a change made after
+ * that point is never lost.
+ *
+ * @return true if the same event is already queued and this one is merged.
+ */
+static bool event_bus_coalesce(event_bus_event_t type, event_bus_lane_t lane)
+{
+    bool merged = false;
+    uint32_t bit = 1UL << type;
+
+    portENTER_CRITICAL_SAFE(&s_stats_lock);
+    if ((s_pending_mask & bit) != 0U) {
+        s_lane_stats[lane].coalesced++;
+        s_type_stats[type].coalesced++;
+        merged = true;
+    }
+    else {
+        s_pending_mask |= bit;
+    }
+    portEXIT_CRITICAL_SAFE(&s_stats_lock);
+
+    return merged;
+}
+
+/**
+ * @brief Count an event dropped on a full lane.
+ *
+ * Also clears the pending bit taken by event_bus_coalesce() so the next
+ * publication of the same event is queued again.
+ */
+static void event_bus_count_drop(event_bus_event_t type, event_bus_lane_t lane, bool coalesce)
+{
+    portENTER_CRITICAL_SAFE(&s_stats_lock);
+    s_lane_stats[lane].dropped++;
+    if (type < EVT_COUNT) {
+        s_type_stats[type].dropped++;
+    }
+    if (coalesce == true) {
+        s_pending_mask &= ~(1UL << type);
+    }
+    portEXIT_CRITICAL_SAFE(&s_stats_lock);
+}
+
+/**
+ * @brief Count a queued event and track the lane peak depth.
+ *
+ * @param depth Number of events in the lane right after queuing.
+ */
+static void event_bus_count_publish(event_bus_event_t type, event_bus_lane_t lane, uint32_t depth)
+{
+    portENTER_CRITICAL_SAFE(&s_stats_lock);
+    if (type < EVT_COUNT) {
+        s_type_stats[type].published++;
+    }
+    if (depth > s_lane_stats[lane].depth_peak) {
+        s_lane_stats[lane].depth_peak = depth;
+    }
+    portEXIT_CRITICAL_SAFE(&s_stats_lock);
+}
+
+/**
+ * @brief Get the log2 histogram bucket of a duration.
+ */
+static uint8_t event_bus_hist_bucket(uint32_t duration_us)
+{
+    uint8_t bucket = 0U;
+    uint32_t value = duration_us;
+
+    while ((value > 1U) && (bucket < (EVENT_BUS_HIST_BUCKETS - 1U))) {
+        value >>= 1U;
+        bucket++;
     }
+
+    return bucket;
 }
 
 /**
  * @brief Publish an event to the Event Bus.
  *
- * Adds an event to the queue. If the queue is full, blocks up to
- * EVENT_BUS_PUBLISH_TIMEOUT_MS then drops the event with a warning log.
+ * Adds an event to the queue of its priority lane. Only the payload handle
+ * is queued: the caller's reference on the buffer is handed over to the bus
+ * and released by the consumer once dispatched. If the lane is full, blocks
+ * up to EVENT_BUS_PUBLISH_TIMEOUT_MS then drops the event with a warning
+ * log and releases the payload. An event without payload is merged into an
+ * identical one still waiting in the queue.
+ *
+ * @param type Event type.
+ * @param payload Payload buffer from event_bus_buffer_alloc(), or
+ *        EVENT_BUS_BUFFER_NONE for an event without payload.
+ */
+void event_bus_publish(event_bus_event_t type, event_bus_buffer_t payload)
+{
+    static const TickType_t EVENT_BUS_PUBLISH_TIMEOUT_MS = 100U;
+    event_bus_lane_t lane = event_bus_get_lane(type);
+    bool queued = false;
+    bool coalesce = (payload == EVENT_BUS_BUFFER_NONE) && (type < EVT_COUNT);
+
+    if ((s_event_count != NULL) && (s_lanes[lane].queue != NULL)) {
+        if ((coalesce == true) && (event_bus_coalesce(type, lane) == true)) {
+            /* Already queued, nothing to release */
+            queued = true;
+        }
+        else {
+            event_bus_item_t item;
+            item.message.type = type;
+            item.message.payload = payload;
+            item.publish_us = esp_timer_get_time();
+
+            if (xQueueSend(s_lanes[lane].queue, &item, pdMS_TO_TICKS(EVENT_BUS_PUBLISH_TIMEOUT_MS)) == pdTRUE) {
+                event_bus_count_publish(type, lane, (uint32_t)uxQueueMessagesWaiting(s_lanes[lane].queue));
+                (void)xSemaphoreGive(s_event_count);
+                queued = true;
+            }
+            else {
+                event_bus_count_drop(type, lane, coalesce);
+                ESP_LOGW(EVENT_BUS_TAG, "Lane %u full, event %u dropped", (unsigned)lane, (unsigned)type);
+            }
+        }
+    }
+
+    if (queued == false) {
+        event_bus_buffer_release(payload);
+    }
+}
+
+/**
+ * @brief Publish an event to the Event Bus from an interrupt.
+ *
+ * Never blocks: if the lane is full the event is dropped, counted in the
+ * lane statistics and its payload released. Same ownership and coalescing
+ * rules as event_bus_publish().
  *
- * @param evt_message The event to publish.
+ * @param type Event type.
+ * @param payload Payload buffer, or EVENT_BUS_BUFFER_NONE.
+ * @param[out] higher_priority_task_woken Set to pdTRUE if the dispatcher
+ *        was woken and the ISR should call portYIELD_FROM_ISR(). May be NULL.
  */
-void event_bus_publish(event_bus_message_t evt_message)
+void event_bus_publish_from_isr(event_bus_event_t type, event_bus_buffer_t payload, BaseType_t *higher_priority_task_woken)
 {
-	static const char EVENT_BUS_TAG[] = "EVENT_BUS";
-	static const TickType_t EVENT_BUS_PUBLISH_TIMEOUT_MS = 100U;
-	
-    if (s_event_queue) {
-        if (xQueueSend(s_event_queue, &evt_message, pdMS_TO_TICKS(EVENT_BUS_PUBLISH_TIMEOUT_MS)) != pdTRUE) {
-            ESP_LOGW(EVENT_BUS_TAG, "Queue full, event %u dropped", (unsigned)evt_message.type);
+    event_bus_lane_t lane = event_bus_get_lane(type);
+    bool queued = false;
+    bool coalesce = (payload == EVENT_BUS_BUFFER_NONE) && (type < EVT_COUNT);
+
+    if ((s_event_count != NULL) && (s_lanes[lane].queue != NULL)) {
+        if ((coalesce == true) && (event_bus_coalesce(type, lane) == true)) {
+            queued = true;
+        }
+        else {
+            event_bus_item_t item;
+            item.message.type = type;
+            item.message.payload = payload;
+            item.publish_us = esp_timer_get_time();
+
+            if (xQueueSendFromISR(s_lanes[lane].queue, &item, higher_priority_task_woken) == pdTRUE) {
+                event_bus_count_publish(type, lane, (uint32_t)uxQueueMessagesWaitingFromISR(s_lanes[lane].queue));
+                (void)xSemaphoreGiveFromISR(s_event_count, higher_priority_task_woken);
+                queued = true;
+            }
+            else {
+                event_bus_count_drop(type, lane, coalesce);
+            }
         }
     }
+
+    if (queued == false) {
+        event_bus_buffer_release(payload);
+    }
 }
 
 /**
  * @brief Wait for the next event from the Event Bus.
  *
- * Blocks until an event is available in the queue, unless a timeout is specified.
- * This function is typically called from a dedicated dispatcher task.
+ * Blocks until an event is available in any lane, unless a timeout is
+ * specified, then returns the oldest event of the highest priority
+ * non-empty lane. This function is typically called from a dedicated
+ * dispatcher task.
  *
  * @param timeout Maximum time to wait (FreeRTOS ticks).
- *        - portMAX_DELAY: Wait forever  
- *        - 0: Non-blocking  
+ *        - portMAX_DELAY: Wait forever
+ *        - 0: Non-blocking
  *
  * @return The received event, or EVT_NONE if a timeout occurs or if the queue
- *         is not initialized.
+ *         is not initialized. The caller owns the payload reference and must
+ *         release it with event_bus_buffer_release().
  */
 event_bus_message_t event_bus_wait(TickType_t timeout)
 {
     event_bus_message_t evt_message;
     evt_message.type = EVT_NONE;
-    evt_message.payload_size = 0U;
-    if (s_event_queue) {
-        xQueueReceive(s_event_queue, &evt_message, timeout);
+    evt_message.payload = EVENT_BUS_BUFFER_NONE;
+
+    if ((s_event_count != NULL) && (xSemaphoreTake(s_event_count, timeout) == pdTRUE)) {
+        event_bus_item_t item;
+
+        for (uint8_t lane = 0U; lane < EVENT_BUS_LANE_COUNT; lane++) {
+            if ((s_lanes[lane].queue != NULL) && (xQueueReceive(s_lanes[lane].queue, &item, 0U) == pdTRUE)) {
+                int64_t latency = esp_timer_get_time() - item.publish_us;
+                uint32_t latency_us = (latency > (int64_t)UINT32_MAX) ? UINT32_MAX : (uint32_t)latency;
+                event_bus_lane_stats_t *stats = &s_lane_stats[lane];
+
+                portENTER_CRITICAL(&s_stats_lock);
+                if (item.message.type < EVT_COUNT) {
+                    event_bus_type_stats_t *type_stats = &s_type_stats[item.message.type];
+                    if (item.message.payload == EVENT_BUS_BUFFER_NONE) {
+                        s_pending_mask &= ~(1UL << item.message.type);
+                    }
+                    type_stats->dispatched++;
+                    type_stats->latency_hist[event_bus_hist_bucket(latency_us)]++;
+                    type_stats->latency_sum_us += latency_us;
+                    if (latency_us > type_stats->latency_max_us) {
+                        type_stats->latency_max_us = latency_us;
+                    }
+                }
+                stats->dispatched++;
+                stats->latency_sum_us += latency_us;
+                if (latency_us > stats->latency_max_us) {
+                    stats->latency_max_us = latency_us;
+                }
+                if (latency_us > stats->budget_us) {
+                    stats->budget_overruns++;
+                }
+                portEXIT_CRITICAL(&s_stats_lock);
+
+                evt_message = item.message;
+                break;
+            }
+        }
     }
+
     return evt_message;
 }
+
+/**
+ * @brief Get a snapshot of the latency counters of a lane.
+ *
+ * @param lane Lane to read.
+ * @param[out] stats Destination of the snapshot.
+ *
+ * @return true on success, false if the lane or the pointer is invalid.
+ */
+bool event_bus_get_lane_stats(event_bus_lane_t lane, event_bus_lane_stats_t *stats)
+{
+    bool ret = false;
+
+    if ((lane < EVENT_BUS_LANE_COUNT) && (stats != NULL)) {
+        portENTER_CRITICAL(&s_stats_lock);
+        *stats = s_lane_stats[lane];
+        portEXIT_CRITICAL(&s_stats_lock);
+        ret = true;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Get the number of events currently queued on a lane.
+ *
+ * @param lane Lane to read.
+ *
+ * @return Queued events, 0 if the lane is invalid or not created yet.
+ */
+uint32_t event_bus_get_lane_depth(event_bus_lane_t lane)
+{
+    uint32_t depth = 0U;
+
+    if ((lane < EVENT_BUS_LANE_COUNT) && (s_lanes[lane].queue != NULL)) {
+        depth = (uint32_t)uxQueueMessagesWaiting(s_lanes[lane].queue);
+    }
+
+    return depth;
+}
+
+/**
+ * @brief Get a snapshot of the counters and histograms of an event type.
+ *
+ * @param type Event type.
+ * @param[out] stats Destination of the snapshot.
+ *
+ * @return true on success, false if the type or the pointer is invalid.
+ */
+bool event_bus_get_type_stats(event_bus_event_t type, event_bus_type_stats_t *stats)
+{
+    bool ret = false;
+
+    if ((type < EVT_COUNT) && (stats != NULL)) {
+        portENTER_CRITICAL(&s_stats_lock);
+        *stats = s_type_stats[type];
+        portEXIT_CRITICAL(&s_stats_lock);
+        ret = true;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Record the runtime of one subscriber callback.
+ *
+ * Called by the dispatcher around each callback invocation.
+ *
+ * @param type Event type the callback handled.
+ * @param runtime_us Callback runtime.
+ */
+void event_bus_record_callback(event_bus_event_t type, uint32_t runtime_us)
+{
+    if (type < EVT_COUNT) {
+        event_bus_type_stats_t *stats = &s_type_stats[type];
+
+        portENTER_CRITICAL(&s_stats_lock);
+        stats->callback_hist[event_bus_hist_bucket(runtime_us)]++;
+        if (runtime_us > stats->callback_max_us) {
+            stats->callback_max_us = runtime_us;
+        }
+        portEXIT_CRITICAL(&s_stats_lock);
+    }
+}
+
+/**
+ * @brief Append the non-empty buckets of a histogram as "bucket:count".
+ *
+ * @return Number of characters written, excluding the terminator.
+ */
+static size_t event_bus_format_hist(char *buf, size_t size, const char *name, const uint32_t *hist)
+{
+    size_t len = 0U;
+    int ret = snprintf(buf, size, "    %s log2(us)", name);
+
+    if (ret > 0) {
+        len = ((size_t)ret < size) ? (size_t)ret : (size - 1U);
+    }
+    for (uint8_t i = 0U; (i < EVENT_BUS_HIST_BUCKETS) && (len < (size - 1U)); i++) {
+        if (hist[i] != 0U) {
+            ret = snprintf(&buf[len], size - len, " %u:%lu", (unsigned)i, (unsigned long)hist[i]);
+            if (ret > 0) {
+                len += ((size_t)ret < (size - len)) ? (size_t)ret : (size - len - 1U);
+            }
+        }
+    }
+
+    return len;
+}
+
+/**
+ * @brief Format one line of the statistics report.
+ *
+ * The report is produced line by line so callers can stream it over UART
+ * or HTTP with a small buffer. Lines are not newline terminated.
+ *
+ * @param line Line index, starting at 0.
+ * @param[out] buf Destination, always null-terminated when size > 0.
+ * @param size Size of buf.
+ *
+ * @return Number of characters written, 0 once line is past the end.
+ */
+size_t event_bus_stats_format_line(uint16_t line, char *buf, size_t size)
+{
+    size_t len = 0U;
+    int ret = 0;
+
+    if ((buf != NULL) && (size > 0U) && (line < EVENT_BUS_STATS_LINE_COUNT)) {
+        if (line == 0U) {
+            ret = snprintf(buf, size, "lane dispatched dropped coalesced depth_peak lat_max_us lat_avg_us overruns budget_us");
+        }
+        else if (line <= EVENT_BUS_LANE_COUNT) {
+            event_bus_lane_stats_t lane;
+            (void)event_bus_get_lane_stats((event_bus_lane_t)(line - 1U), &lane);
+            uint32_t avg = (lane.dispatched > 0U) ? (uint32_t)(lane.latency_sum_us / lane.dispatched) : 0U;
+            ret = snprintf(buf, size, "%u %lu %lu %lu %lu %lu %lu %lu %lu", (unsigned)(line - 1U),
+                           (unsigned long)lane.dispatched, (unsigned long)lane.dropped,
+                           (unsigned long)lane.coalesced, (unsigned long)lane.depth_peak,
+                           (unsigned long)lane.latency_max_us, (unsigned long)avg,
+                           (unsigned long)lane.budget_overruns, (unsigned long)lane.budget_us);
+        }
+        else if (line == (EVENT_BUS_LANE_COUNT + 1U)) {
+            ret = snprintf(buf, size, "event lane published dispatched dropped coalesced lat_max_us cb_max_us");
+        }
+        else {
+            uint16_t index = line - EVENT_BUS_STATS_FIRST_TYPE_LINE;
+            event_bus_event_t type = (event_bus_event_t)(index / EVENT_BUS_STATS_TYPE_LINES);
+            event_bus_type_stats_t stats;
+            (void)event_bus_get_type_stats(type, &stats);
+
+            switch (index % EVENT_BUS_STATS_TYPE_LINES) {
+                case 0U:
+                    ret = snprintf(buf, size, "%u %u %lu %lu %lu %lu %lu %lu", (unsigned)type,
+                                   (unsigned)event_bus_get_lane(type),
+                                   (unsigned long)stats.published, (unsigned long)stats.dispatched,
+                                   (unsigned long)stats.dropped, (unsigned long)stats.coalesced,
+                                   (unsigned long)stats.latency_max_us, (unsigned long)stats.callback_max_us);
+                    break;
+                case 1U:
+                    len = event_bus_format_hist(buf, size, "latency ", stats.latency_hist);
+                    break;
+                default:
+                    len = event_bus_format_hist(buf, size, "callback", stats.callback_hist);
+                    break;
+            }
+        }
+
+        if (ret > 0) {
+            len = ((size_t)ret < size) ? (size_t)ret : (size - 1U);
+        }
+    }
+
+    return len;
+}
+
+/**
+ * @brief Dump the statistics report to the log (UART).
+ */
+void event_bus_stats_log(void)
+{
+    char line[EVENT_BUS_STATS_LOG_LINE_SIZE];
+
+    for (uint16_t i = 0U; event_bus_stats_format_line(i, line, sizeof(line)) > 0U; i++) {
+        ESP_LOGI(EVENT_BUS_TAG, "%s", line);
+    }
+}
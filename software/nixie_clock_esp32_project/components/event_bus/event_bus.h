@@ -6,11 +6,24 @@
 ******************************************************************/
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
+#include <stdbool.h>
+#include <stddef.h>
 
 /******************************************************************
  * 2. Define declarations (macros then function macros)
 ******************************************************************/
-#define EVENT_BUS_MAX_PAYLOAD_SIZE   (32U)
+/* Payload pool size classes: buffer size and number of buffers */
+#define EVENT_BUS_BUFFER_SMALL_SIZE     (16U)
+#define EVENT_BUS_BUFFER_SMALL_COUNT    (16U)
+#define EVENT_BUS_BUFFER_MEDIUM_SIZE    (64U)
+#define EVENT_BUS_BUFFER_MEDIUM_COUNT   (8U)
+#define EVENT_BUS_BUFFER_LARGE_SIZE     (256U)
+#define EVENT_BUS_BUFFER_LARGE_COUNT    (4U)
+#define EVENT_BUS_MAX_PAYLOAD_SIZE      (EVENT_BUS_BUFFER_LARGE_SIZE)
+
+/* Handle of a pooled payload buffer */
+typedef uint8_t event_bus_buffer_t;
+#define EVENT_BUS_BUFFER_NONE           ((event_bus_buffer_t)0xFFU)
 
 typedef uint8_t event_bus_event_t;
 #define EVT_NONE              ((event_bus_event_t)0U)
@@ -20,16 +33,54 @@ typedef uint8_t event_bus_event_t;
 #define EVT_NTP_CONFIG        ((event_bus_event_t)4U)
 #define EVT_WIFI_CONFIG       ((event_bus_event_t)5U)
 #define EVT_PWM_CONFIG        ((event_bus_event_t)6U)
+#define EVT_TIMER_CLOCK_TICK  ((event_bus_event_t)7U)   /* 1 s clock ticks elapsed, from timer_service */
+#define EVT_TIMER_DISPLAY     ((event_bus_event_t)8U)   /* Display refresh, from timer_service */
+#define EVT_CONFIG_PERSIST    ((event_bus_event_t)9U)   /* Write pending config changes to NVS */
+#define EVT_COUNT             (10U)   /* Number of event types, keep last */
+
+/* Priority lanes, drained strictly in this order */
+typedef uint8_t event_bus_lane_t;
+#define EVENT_BUS_LANE_INPUT        ((event_bus_lane_t)0U)
+#define EVENT_BUS_LANE_TIME         ((event_bus_lane_t)1U)
+#define EVENT_BUS_LANE_CONFIG       ((event_bus_lane_t)2U)
+#define EVENT_BUS_LANE_TELEMETRY    ((event_bus_lane_t)3U)
+#define EVENT_BUS_LANE_COUNT        (4U)
+
+/* Histogram bucket i counts durations in [2^i, 2^(i+1)) us, the last one is open-ended */
+#define EVENT_BUS_HIST_BUCKETS      (20U)
 
 /******************************************************************
  * 3. Typedef definitions (simple typedef, then enum and structs)
 ******************************************************************/
+/* Queued message: only the payload handle travels through the queues */
 typedef struct {
     event_bus_event_t type;
-    uint8_t payload[EVENT_BUS_MAX_PAYLOAD_SIZE];
-    uint8_t payload_size;
+    event_bus_buffer_t payload;     /* EVENT_BUS_BUFFER_NONE if no payload */
 } event_bus_message_t;
 
+typedef struct {
+    uint32_t dispatched;        /* Events handed to the dispatcher */
+    uint32_t dropped;           /* Events dropped because the lane was full */
+    uint32_t coalesced;         /* Payload-less events merged into one already queued */
+    uint32_t depth_peak;        /* Highest number of events queued at once */
+    uint32_t budget_overruns;   /* Events that waited longer than the lane budget */
+    uint32_t latency_max_us;    /* Worst publish-to-dispatch delay */
+    uint64_t latency_sum_us;    /* Sum of delays, divide by dispatched for the mean */
+    uint32_t budget_us;         /* Latency budget of the lane */
+} event_bus_lane_stats_t;
+
+typedef struct {
+    uint32_t published;                             /* Events queued */
+    uint32_t dispatched;                            /* Events handed to the dispatcher */
+    uint32_t dropped;                               /* Events dropped because the lane was full */
+    uint32_t coalesced;                             /* Events merged into one already queued */
+    uint32_t latency_max_us;                        /* Worst publish-to-dispatch delay */
+    uint64_t latency_sum_us;                        /* Sum of delays, divide by dispatched for the mean */
+    uint32_t callback_max_us;                       /* Slowest single subscriber callback */
+    uint32_t latency_hist[EVENT_BUS_HIST_BUCKETS];  /* Publish-to-dispatch delays */
+    uint32_t callback_hist[EVENT_BUS_HIST_BUCKETS]; /* Subscriber callback runtimes */
+} event_bus_type_stats_t;
+
 /******************************************************************
  * 4. Variable definitions (static then global)
 ******************************************************************/
@@ -42,7 +93,21 @@ typedef struct {
  * 6. Functions definitions
 ******************************************************************/
 void event_bus_init(void);
-void event_bus_publish(event_bus_message_t evt_message);
+void event_bus_publish(event_bus_event_t type, event_bus_buffer_t payload);
+void event_bus_publish_from_isr(event_bus_event_t type, event_bus_buffer_t payload, BaseType_t *higher_priority_task_woken);
 event_bus_message_t event_bus_wait(TickType_t timeout);
+event_bus_lane_t event_bus_get_lane(event_bus_event_t type);
+bool event_bus_get_lane_stats(event_bus_lane_t lane, event_bus_lane_stats_t *stats);
+uint32_t event_bus_get_lane_depth(event_bus_lane_t lane);
+bool event_bus_get_type_stats(event_bus_event_t type, event_bus_type_stats_t *stats);
+void event_bus_record_callback(event_bus_event_t type, uint32_t runtime_us);
+size_t event_bus_stats_format_line(uint16_t line, char *buf, size_t size);
+void event_bus_stats_log(void);
+
+event_bus_buffer_t event_bus_buffer_alloc(uint16_t size);
+uint8_t *event_bus_buffer_data(event_bus_buffer_t buf);
+uint16_t event_bus_buffer_size(event_bus_buffer_t buf);
+void event_bus_buffer_retain(event_bus_buffer_t buf);
+void event_bus_buffer_release(event_bus_buffer_t buf);
 
 #endif // EVENT_BUS_H
\ No newline at end of file
@@ -0,0 +1,188 @@
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#ifdef STATIC_ANALYSIS
+#include "../test/common/esp_stub.h"
+#endif
+#include "event_bus.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+#define EVENT_BUS_BUFFER_CLASS_COUNT    (3U)
+#define EVENT_BUS_BUFFER_COUNT          (EVENT_BUS_BUFFER_SMALL_COUNT + EVENT_BUS_BUFFER_MEDIUM_COUNT + \
+                                         EVENT_BUS_BUFFER_LARGE_COUNT)
+
+_Static_assert(EVENT_BUS_BUFFER_COUNT < EVENT_BUS_BUFFER_NONE, "buffer handles must fit below EVENT_BUS_BUFFER_NONE");
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+typedef struct {
+    uint8_t *storage;       /* count * size bytes */
+    uint16_t size;          /* Size of each buffer */
+    uint8_t count;          /* Number of buffers */
+    uint8_t first;          /* Handle of the first buffer of the class */
+} event_bus_buffer_class_t;
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+static const char EVENT_BUS_BUFFER_TAG[] = "EVENT_BUS_BUFFER";
+
+static uint8_t s_small_storage[EVENT_BUS_BUFFER_SMALL_COUNT * EVENT_BUS_BUFFER_SMALL_SIZE];
+static uint8_t s_medium_storage[EVENT_BUS_BUFFER_MEDIUM_COUNT * EVENT_BUS_BUFFER_MEDIUM_SIZE];
+static uint8_t s_large_storage[EVENT_BUS_BUFFER_LARGE_COUNT * EVENT_BUS_BUFFER_LARGE_SIZE];
+
+/* Size classes, sorted by increasing buffer size */
+static const event_bus_buffer_class_t s_classes[EVENT_BUS_BUFFER_CLASS_COUNT] = {
+    { s_small_storage,  EVENT_BUS_BUFFER_SMALL_SIZE,  EVENT_BUS_BUFFER_SMALL_COUNT,  0U },
+    { s_medium_storage, EVENT_BUS_BUFFER_MEDIUM_SIZE, EVENT_BUS_BUFFER_MEDIUM_COUNT, EVENT_BUS_BUFFER_SMALL_COUNT },
+    { s_large_storage,  EVENT_BUS_BUFFER_LARGE_SIZE,  EVENT_BUS_BUFFER_LARGE_COUNT,
+      EVENT_BUS_BUFFER_SMALL_COUNT + EVENT_BUS_BUFFER_MEDIUM_COUNT },
+};
+
+/* Per buffer state, indexed by handle. A zero reference count means free. */
+static uint8_t s_refcount[EVENT_BUS_BUFFER_COUNT];
+static uint16_t s_used_size[EVENT_BUS_BUFFER_COUNT];
+
+/* Taken from tasks and ISRs, always through the _SAFE critical sections */
+static portMUX_TYPE s_pool_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+static const event_bus_buffer_class_t *event_bus_buffer_class(event_bus_buffer_t buf);
+
+/******************************************************************
+ * 6. Functions definitions
+******************************************************************/
+
+/**
+ * @brief Get the size class owning a handle.
+ *
+ * @return The class, NULL if the handle is invalid.
+ */
+static const event_bus_buffer_class_t *event_bus_buffer_class(event_bus_buffer_t buf)
+{
+    const event_bus_buffer_class_t *cls = NULL;
+
+    for (uint8_t i = 0U; i < EVENT_BUS_BUFFER_CLASS_COUNT; i++) {
+        if ((buf >= s_classes[i].first) && (buf < (s_classes[i].first + s_classes[i].count))) {
+            cls = &s_classes[i];
+            break;
+        }
+    }
+
+    return cls;
+}
+
+/**
+ * @brief Allocate a payload buffer from the static pool.
+ *
+ * The smallest size class able to hold size bytes is used, falling back
+ * to larger classes when it is exhausted. The buffer is returned with a
+ * reference count of one, owned by the caller. Safe to call from an ISR.
+ *
+ * @param size Number of payload bytes, 1 to EVENT_BUS_MAX_PAYLOAD_SIZE.
+ *
+ * @return Buffer handle, EVENT_BUS_BUFFER_NONE if the size is invalid or
+ *         the pool is exhausted.
+ */
+event_bus_buffer_t event_bus_buffer_alloc(uint16_t size)
+{
+    event_bus_buffer_t buf = EVENT_BUS_BUFFER_NONE;
+
+    if ((size > 0U) && (size <= EVENT_BUS_MAX_PAYLOAD_SIZE)) {
+        portENTER_CRITICAL_SAFE(&s_pool_lock);
+        for (uint8_t i = 0U; (i < EVENT_BUS_BUFFER_CLASS_COUNT) && (buf == EVENT_BUS_BUFFER_NONE); i++) {
+            if (size <= s_classes[i].size) {
+                for (uint8_t j = s_classes[i].first; j < (s_classes[i].first + s_classes[i].count); j++) {
+                    if (s_refcount[j] == 0U) {
+                        s_refcount[j] = 1U;
+                        s_used_size[j] = size;
+                        buf = j;
+                        break;
+                    }
+                }
+            }
+        }
+        portEXIT_CRITICAL_SAFE(&s_pool_lock);
+
+        if ((buf == EVENT_BUS_BUFFER_NONE) && (xPortInIsrContext() == pdFALSE)) {
+            ESP_LOGW(EVENT_BUS_BUFFER_TAG, "No free buffer for %u bytes", (unsigned)size);
+        }
+    }
+
+    return buf;
+}
+
+/**
+ * @brief Get the data of a buffer.
+ *
+ * @return Pointer to the payload bytes, NULL for EVENT_BUS_BUFFER_NONE.
+ */
+uint8_t *event_bus_buffer_data(event_bus_buffer_t buf)
+{
+    uint8_t *data = NULL;
+    const event_bus_buffer_class_t *cls = event_bus_buffer_class(buf);
+
+    if (cls != NULL) {
+        data = &cls->storage[(uint32_t)(buf - cls->first) * cls->size];
+    }
+
+    return data;
+}
+
+/**
+ * @brief Get the payload size requested when the buffer was allocated.
+ *
+ * @return Size in bytes, 0 for EVENT_BUS_BUFFER_NONE.
+ */
+uint16_t event_bus_buffer_size(event_bus_buffer_t buf)
+{
+    uint16_t size = 0U;
+
+    if (buf < EVENT_BUS_BUFFER_COUNT) {
+        size = s_used_size[buf];
+    }
+
+    return size;
+}
+
+/**
+ * @brief Take an additional reference on a buffer.
+ *
+ * Internal to the dispatcher, which takes one per pooled or dedicated
+ * job it hands the payload to. Subscriber callbacks only get the payload
+ * data, valid during the call, and must copy what they need.
+ */
+void event_bus_buffer_retain(event_bus_buffer_t buf)
+{
+    if (buf < EVENT_BUS_BUFFER_COUNT) {
+        portENTER_CRITICAL_SAFE(&s_pool_lock);
+        if ((s_refcount[buf] > 0U) && (s_refcount[buf] < UINT8_MAX)) {
+            s_refcount[buf]++;
+        }
+        portEXIT_CRITICAL_SAFE(&s_pool_lock);
+    }
+}
+
+/**
+ * @brief Drop a reference on a buffer.
+ *
+ * The buffer goes back to the pool when its last reference is released.
+ * Releasing EVENT_BUS_BUFFER_NONE has no effect.
+ */
+void event_bus_buffer_release(event_bus_buffer_t buf)
+{
+    if (buf < EVENT_BUS_BUFFER_COUNT) {
+        portENTER_CRITICAL_SAFE(&s_pool_lock);
+        if (s_refcount[buf] > 0U) {
+            s_refcount[buf]--;
+        }
+        portEXIT_CRITICAL_SAFE(&s_pool_lock);
+    }
+}
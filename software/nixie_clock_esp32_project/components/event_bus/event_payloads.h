@@ -0,0 +1,107 @@
+#ifndef EVENT_PAYLOADS_H
+#define EVENT_PAYLOADS_H
+
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "event_bus.h"
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+/**
+ * Typed event payloads, one line per event carrying data.
+ *
+ * X(event, name, type, size)
+ * - event: event id, payload-less events are not listed
+ * - name:  helper prefix, generates evt_<name>_pack/_unpack/_publish/_publish_from_isr
+ * - type:  packed payload struct
+ * - size:  wire size in bytes, checked against sizeof(type) at compile time
+ */
+#define EVENT_PAYLOADS(X) \
+    X(EVT_CLOCK_NTP_CONFIG,  clock_time,   evt_clock_time_t,   3U) \
+    X(EVT_CLOCK_GPIO_CONFIG, button,       evt_button_t,       5U) \
+    X(EVT_TIMER_CLOCK_TICK,  timer_tick,   evt_timer_tick_t,   2U)
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+/* EVT_CLOCK_NTP_CONFIG: time received from NTP */
+typedef struct __attribute__((packed)) {
+    uint8_t hours;
+    uint8_t minutes;
+    uint8_t seconds;
+} evt_clock_time_t;
+
+/* EVT_CLOCK_GPIO_CONFIG: button or rotary encoder action */
+typedef struct __attribute__((packed)) {
+    uint8_t id;             /* buttons_type_t */
+    uint8_t pressed;        /* button_press_t */
+    uint8_t state;          /* button_state_t */
+    uint8_t updateValue;    /* rotary_encoder_event_t */
+    uint8_t steps;          /* Detents for rotary encoder events */
+} evt_button_t;
+
+/* EVT_TIMER_CLOCK_TICK: periods elapsed since the previous tick event */
+typedef struct __attribute__((packed)) {
+    uint16_t ticks;
+} evt_timer_tick_t;
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+
+/******************************************************************
+ * 6. Functions definitions (generated inline helpers)
+******************************************************************/
+#define EVENT_PAYLOAD_HELPERS(event, name, type, size) \
+    _Static_assert(sizeof(type) == (size), #type " does not match its wire size"); \
+    _Static_assert(sizeof(type) <= EVENT_BUS_MAX_PAYLOAD_SIZE, #type " does not fit a bus buffer"); \
+    _Static_assert((event) < EVT_COUNT, #type " is bound to an unknown event"); \
+    /* Copy data into a new pooled buffer, EVENT_BUS_BUFFER_NONE if the pool is empty */ \
+    static inline event_bus_buffer_t evt_##name##_pack(const type *data) \
+    { \
+        event_bus_buffer_t buf = event_bus_buffer_alloc((uint16_t)sizeof(type)); \
+        uint8_t *dst = event_bus_buffer_data(buf); \
+        if (dst != NULL) { \
+            (void)memcpy(dst, data, sizeof(type)); \
+        } \
+        return buf; \
+    } \
+    /* Copy a received payload out, false if its size does not match */ \
+    static inline bool evt_##name##_unpack(const uint8_t *payload, uint16_t payload_size, type *out) \
+    { \
+        bool ok = (payload != NULL) && (payload_size == (uint16_t)sizeof(type)); \
+        if (ok == true) { \
+            (void)memcpy(out, payload, sizeof(type)); \
+        } \
+        return ok; \
+    } \
+    /* Pack and publish on the event bound to the type */ \
+    static inline bool evt_##name##_publish(const type *data) \
+    { \
+        event_bus_buffer_t buf = evt_##name##_pack(data); \
+        if (buf != EVENT_BUS_BUFFER_NONE) { \
+            event_bus_publish((event), buf); \
+        } \
+        return (buf != EVENT_BUS_BUFFER_NONE); \
+    } \
+    static inline bool evt_##name##_publish_from_isr(const type *data, BaseType_t *higher_priority_task_woken) \
+    { \
+        event_bus_buffer_t buf = evt_##name##_pack(data); \
+        if (buf != EVENT_BUS_BUFFER_NONE) { \
+            event_bus_publish_from_isr((event), buf, higher_priority_task_woken); \
+        } \
+        return (buf != EVENT_BUS_BUFFER_NONE); \
+    }
+
+EVENT_PAYLOADS(EVENT_PAYLOAD_HELPERS)
+
+#endif // EVENT_PAYLOADS_H
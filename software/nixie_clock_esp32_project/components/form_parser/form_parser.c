@@ -0,0 +1,197 @@
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#include "form_parser.h"
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+#define FORM_PARSER_NOT_HEX              (0xFFU)
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+static uint8_t form_parser_hex(char c);
+static void form_parser_put(form_parser_t *p, char c);
+static void form_parser_flush_escape(form_parser_t *p);
+static void form_parser_emit(form_parser_t *p);
+static void form_parser_char(form_parser_t *p, char c);
+
+/******************************************************************
+ * 6. Functions definitions
+******************************************************************/
+
+static uint8_t form_parser_hex(char c)
+{
+    uint8_t value = FORM_PARSER_NOT_HEX;
+
+    if ((c >= '0') && (c <= '9')) {
+        value = (uint8_t)(c - '0');
+    }
+    else if ((c >= 'A') && (c <= 'F')) {
+        value = (uint8_t)(c - 'A' + 10);
+    }
+    else if ((c >= 'a') && (c <= 'f')) {
+        value = (uint8_t)(c - 'a' + 10);
+    }
+    else {
+        /* Not a hex digit */
+    }
+
+    return value;
+}
+
+/**
+ * @brief Append a decoded character to the current key or value.
+ */
+static void form_parser_put(form_parser_t *p, char c)
+{
+    if (p->in_value == true) {
+        if (p->value_len < (FORM_PARSER_VALUE_SIZE - 1U)) {
+            p->value[p->value_len++] = c;
+        }
+        else {
+            p->status |= FORM_PARSER_WARN_TRUNCATED;
+        }
+    }
+    else {
+        if (p->key_len < (FORM_PARSER_KEY_SIZE - 1U)) {
+            p->key[p->key_len++] = c;
+        }
+        else {
+            p->status |= FORM_PARSER_WARN_TRUNCATED;
+        }
+    }
+}
+
+/**
+ * @brief Keep an incomplete %XX sequence as literal text.
+ */
+static void form_parser_flush_escape(form_parser_t *p)
+{
+    if (p->escape_len > 0U) {
+        form_parser_put(p, '%');
+        if (p->escape_len > 1U) {
+            form_parser_put(p, p->escape_hi);
+        }
+        p->escape_len = 0U;
+        p->status |= FORM_PARSER_WARN_INVALID_SEQ;
+    }
+}
+
+/**
+ * @brief Report the current pair and start the next one.
+ *
+ * Pairs without a key, as in "a=1&&b=2", are skipped.
+ */
+static void form_parser_emit(form_parser_t *p)
+{
+    form_parser_flush_escape(p);
+
+    if ((p->key_len > 0U) && (p->aborted == false)) {
+        p->key[p->key_len] = '\0';
+        p->value[p->value_len] = '\0';
+        p->aborted = (p->cb(p->ctx, p->key, p->value, p->status) == false);
+    }
+
+    p->key_len = 0U;
+    p->value_len = 0U;
+    p->in_value = false;
+    p->status = FORM_PARSER_OK;
+}
+
+static void form_parser_char(form_parser_t *p, char c)
+{
+    bool consumed = false;
+
+    if (p->escape_len > 0U) {
+        if (form_parser_hex(c) == FORM_PARSER_NOT_HEX) {
+            /* Malformed sequence, c is handled as a normal character */
+            form_parser_flush_escape(p);
+        }
+        else if (p->escape_len == 1U) {
+            p->escape_hi = c;
+            p->escape_len = 2U;
+            consumed = true;
+        }
+        else {
+            p->escape_len = 0U;
+            form_parser_put(p, (char)((form_parser_hex(p->escape_hi) << 4) | form_parser_hex(c)));
+            consumed = true;
+        }
+    }
+
+    if (consumed == true) {
+        /* Part of a %XX sequence */
+    }
+    else if (c == '&') {
+        form_parser_emit(p);
+    }
+    else if ((c == '=') && (p->in_value == false)) {
+        p->in_value = true;
+    }
+    else if (c == '%') {
+        p->escape_len = 1U;
+    }
+    else if (c == '+') {
+        form_parser_put(p, ' ');
+    }
+    else {
+        form_parser_put(p, c);
+    }
+}
+
+/**
+ * @brief Initialize a parser.
+ *
+ * @param p Parser state.
+ * @param cb Called for each key=value pair.
+ * @param ctx Argument of cb.
+ */
+void form_parser_init(form_parser_t *p, form_parser_cb_t cb, void *ctx)
+{
+    p->cb = cb;
+    p->ctx = ctx;
+    p->key_len = 0U;
+    p->value_len = 0U;
+    p->in_value = false;
+    p->escape_len = 0U;
+    p->status = FORM_PARSER_OK;
+    p->aborted = false;
+}
+
+/**
+ * @brief Parse the next chunk of the body.
+ *
+ * Chunks may split pairs and %XX sequences anywhere.
+ *
+ * @return false once the callback has stopped the parsing.
+ */
+bool form_parser_feed(form_parser_t *p, const char *data, size_t len)
+{
+    for (size_t i = 0U; (i < len) && (p->aborted == false); i++) {
+        form_parser_char(p, data[i]);
+    }
+
+    return (p->aborted == false);
+}
+
+/**
+ * @brief Report the last pair at the end of the body.
+ *
+ * @return false if the callback stopped the parsing.
+ */
+bool form_parser_finish(form_parser_t *p)
+{
+    form_parser_emit(p);
+
+    return (p->aborted == false);
+}
@@ -0,0 +1,64 @@
+#ifndef FORM_PARSER_H
+#define FORM_PARSER_H
+
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+#define FORM_PARSER_KEY_SIZE             (16U)   /* Longest decoded key + 1 */
+#define FORM_PARSER_VALUE_SIZE           (64U)   /* Longest decoded value + 1 */
+
+/* Warnings about a pair, the pair is still reported */
+typedef uint8_t form_parser_status_t;
+#define FORM_PARSER_OK                   ((form_parser_status_t)0x00U)
+#define FORM_PARSER_WARN_TRUNCATED       ((form_parser_status_t)0x01U)   /* Key or value did not fit */
+#define FORM_PARSER_WARN_INVALID_SEQ     ((form_parser_status_t)0x02U)   /* Malformed %XX kept as is */
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+/* Called once per key=value pair, returns false to stop parsing */
+typedef bool (*form_parser_cb_t)(void *ctx, const char *key, const char *value, form_parser_status_t status);
+
+/**
+ * Streaming application/x-www-form-urlencoded parser.
+ *
+ * The body is fed in chunks of any size and walked once. Keys and values
+ * are URL-decoded as they arrive into fixed buffers, no heap is used.
+ */
+typedef struct {
+    form_parser_cb_t cb;
+    void *ctx;
+    char key[FORM_PARSER_KEY_SIZE];
+    char value[FORM_PARSER_VALUE_SIZE];
+    uint8_t key_len;
+    uint8_t value_len;
+    bool in_value;                  /* '=' seen for the current pair */
+    uint8_t escape_len;             /* Characters of a %XX sequence read so far */
+    char escape_hi;                 /* First hex digit of a %XX sequence */
+    form_parser_status_t status;    /* Warnings of the current pair */
+    bool aborted;                   /* Callback returned false */
+} form_parser_t;
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+
+/******************************************************************
+ * 6. Functions definitions (public API in .c)
+******************************************************************/
+void form_parser_init(form_parser_t *p, form_parser_cb_t cb, void *ctx);
+bool form_parser_feed(form_parser_t *p, const char *data, size_t len);
+bool form_parser_finish(form_parser_t *p);
+
+#endif // FORM_PARSER_H
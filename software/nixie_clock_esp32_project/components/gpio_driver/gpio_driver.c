@@ -26,17 +26,112 @@
 /******************************************************************
  * 5. Functions prototypes (static only)
 ******************************************************************/
+static void my_gpio_btn_isr(void *arg);
+static void my_gpio_debounce_cb(void *arg);
+static void my_gpio_long_press_cb(void *arg);
+static esp_err_t my_gpio_btn_timers_create(my_gpio_btn_t *btn);
 
 /******************************************************************
  * 6. Functions definitions
 ******************************************************************/
 
+/**
+ * @brief Edge ISR of a debounced button
+ *
+ * Every edge restarts the debounce timer, the level is only sampled once
+ * it has been stable for debounce_ms.
+ *
+ * @param[in] arg Button structure
+ */
+static void IRAM_ATTR my_gpio_btn_isr(void *arg)
+{
+    my_gpio_btn_t *btn = (my_gpio_btn_t *)arg;
+
+    (void)esp_timer_stop(btn->debounce_timer);
+    (void)esp_timer_start_once(btn->debounce_timer, (uint64_t)btn->debounce_ms * 1000U);
+}
+
+/**
+ * @brief Debounce expiry: the level is stable, report a press or release
+ *
+ * A press arms the long press timer. A release disarms it and reports a
+ * long press if the timer already fired, a short press otherwise.
+ *
+ * @param[in] arg Button structure
+ */
+static void my_gpio_debounce_cb(void *arg)
+{
+    my_gpio_btn_t *btn = (my_gpio_btn_t *)arg;
+    button_state_t state = (button_state_t)gpio_get_level(btn->pin);
+
+    if (state != btn->previous_state) {
+        if (state == BUTTON_STATE_PRESS) {
+            btn->press_type = BUTTON_SHORT_PRESS;
+            (void)esp_timer_start_once(btn->long_press_timer, (uint64_t)BUTTON_LONG_PRESS_MS * 1000U);
+        }
+        else {
+            (void)esp_timer_stop(btn->long_press_timer);
+        }
+
+        btn->previous_state = state;
+        btn->on_change(btn->cb_arg, state, btn->press_type);
+    }
+}
+
+/**
+ * @brief Long press expiry: the button is still held after BUTTON_LONG_PRESS_MS
+ *
+ * @param[in] arg Button structure
+ */
+static void my_gpio_long_press_cb(void *arg)
+{
+    my_gpio_btn_t *btn = (my_gpio_btn_t *)arg;
+
+    btn->press_type = BUTTON_LONG_PRESS;
+    btn->on_change(btn->cb_arg, BUTTON_STATE_PRESS, BUTTON_LONG_PRESS);
+}
+
+/**
+ * @brief Create the one-shot debounce and long press timers of a button
+ *
+ * @param[in,out] btn Button structure
+ * @return ESP_OK, or the esp_timer error
+ */
+static esp_err_t my_gpio_btn_timers_create(my_gpio_btn_t *btn)
+{
+    esp_err_t err = ESP_OK;
+    esp_timer_create_args_t args = {
+        .arg = btn,
+        .dispatch_method = ESP_TIMER_TASK,
+        .skip_unhandled_events = false,
+    };
+
+    if (btn->debounce_timer == NULL) {
+        args.callback = my_gpio_debounce_cb;
+        args.name = "btn_debounce";
+        err = esp_timer_create(&args, &btn->debounce_timer);
+    }
+
+    if ((err == ESP_OK) && (btn->long_press_timer == NULL)) {
+        args.callback = my_gpio_long_press_cb;
+        args.name = "btn_long_press";
+        err = esp_timer_create(&args, &btn->long_press_timer);
+    }
+
+    return err;
+}
+
 /**
  * @brief Initialize a GPIO button
  *
  * Configures the GPIO pin as input with pull-up or pull-down according
  * to the button configuration and initializes its runtime state.
  *
+ * If on_change is set, the button is fully interrupt driven: edges are
+ * debounced and long presses timed by one-shot esp_timers, and on_change
+ * is called on each debounced press, release and long press. Otherwise
+ * isr_handler, if any, gets the raw edges.
+ *
  * @param[in,out] btn Pointer to the button structure to initialize
  * @return
  *      - ESP_OK: Initialization successful
@@ -53,7 +148,7 @@ esp_err_t my_gpio_init(my_gpio_btn_t *btn) {
         io_conf.mode = GPIO_MODE_INPUT;
         io_conf.pull_up_en = (btn->pull == MY_GPIO_PULL_UP) ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE;
         io_conf.pull_down_en = (btn->pull == MY_GPIO_PULL_DOWN) ? GPIO_PULLDOWN_ENABLE : GPIO_PULLDOWN_DISABLE;
-        io_conf.intr_type = btn->intr_type;
+        io_conf.intr_type = (btn->on_change != NULL) ? GPIO_INTR_ANYEDGE : btn->intr_type;
         err = gpio_config(&io_conf);
         
         /* Install ISR service only once */
@@ -66,61 +161,24 @@ esp_err_t my_gpio_init(my_gpio_btn_t *btn) {
             }
         }
         
-        if ((err == ESP_OK) && (btn->intr_type != GPIO_INTR_DISABLE)) {
-            gpio_isr_handler_add(btn->pin, btn->isr_handler, (void*) btn->pin);
-        }
-        
         if (err == ESP_OK) {
             btn->previous_state = gpio_get_level(btn->pin);
-            btn->last_change_ms = 0;
+            btn->press_type = BUTTON_SHORT_PRESS;
         }
-    }
-    
-    return err;
-}
 
-/**
- * @brief Read the current state of a button and detect press type
- *
- * Reads the physical GPIO state, applies debounce filtering,
- * and determines whether the press is short or long.
- *
- * @param[in,out] btn Pointer to the button structure
- * @return
- *      - BUTTON_STATE_RELEASE: button released
- *      - BUTTON_STATE_PRESS: button pressed
- *
- * Updates the button structure:
- *      - previous_state: last physical state
- *      - press_type: detected press type (short or long)
- */
-button_state_t my_gpio_read_btn(my_gpio_btn_t *btn) {
-    button_state_t state = BUTTON_STATE_RELEASE;
-    uint64_t now = (uint64_t)(esp_timer_get_time() / 1000);
-
-    if (btn != NULL) {
-        state = gpio_get_level(btn->pin);
-        btn->press_type = BUTTON_SHORT_PRESS;
-
-        if (state != btn->previous_state) {
-            if ((now - btn->last_change_ms) > (uint64_t)btn->debounce_ms) {
-                
-                if ((state == (button_state_t)BUTTON_STATE_PRESS) && (btn->previous_state == (button_state_t)BUTTON_STATE_RELEASE)) {
-                    btn->press_start_ms = now;
-                }
-
-                if ((state == (button_state_t)BUTTON_STATE_RELEASE) && (btn->previous_state == (button_state_t)BUTTON_STATE_PRESS)) {
-                    uint64_t duration = now - btn->press_start_ms;
-                    btn->press_type = (duration >= (uint64_t)BUTTON_LONG_PRESS_MS) ? (button_press_t)BUTTON_LONG_PRESS : (button_press_t)BUTTON_SHORT_PRESS;
-                }
-
-                btn->previous_state = state;
-                btn->last_change_ms = now;
-            } else {
-                state = btn->previous_state;
+        if ((err == ESP_OK) && (btn->on_change != NULL)) {
+            err = my_gpio_btn_timers_create(btn);
+            if (err == ESP_OK) {
+                err = gpio_isr_handler_add(btn->pin, my_gpio_btn_isr, btn);
             }
         }
+        else if ((err == ESP_OK) && (btn->intr_type != GPIO_INTR_DISABLE)) {
+            gpio_isr_handler_add(btn->pin, btn->isr_handler, (void*) btn->pin);
+        }
+        else {
+            /* Polled input */
+        }
     }
-
-    return state;
+    
+    return err;
 }
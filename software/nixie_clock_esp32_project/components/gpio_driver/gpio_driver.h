@@ -4,8 +4,10 @@
 /******************************************************************
  * 1. Included files (microcontroller ones then user defined ones)
 ******************************************************************/
+#include <stdbool.h>
 #include "driver/gpio.h"
 #include "esp_err.h"
+#include "esp_timer.h"
 
 /******************************************************************
  * 2. Define declarations (macros then function macros)
@@ -27,17 +29,22 @@ typedef uint8_t my_gpio_pull_t;
  * 3. Typedef definitions (simple typedef, then enum and structs)
 ******************************************************************/
 
+/* Debounced button change, called from the esp_timer task */
+typedef void (*my_gpio_btn_cb_t)(void *arg, button_state_t state, button_press_t press_type);
+
 /* Button structure with debounce */
 typedef struct {
     gpio_num_t pin;
     my_gpio_pull_t pull;
     button_state_t previous_state;
     button_press_t press_type;
-    uint64_t last_change_ms;
-    uint64_t press_start_ms;
     uint32_t debounce_ms;
     gpio_int_type_t intr_type;
-    gpio_isr_t isr_handler;
+    gpio_isr_t isr_handler;             /* Raw edge handler, used when on_change is NULL */
+    my_gpio_btn_cb_t on_change;         /* Debounced button handler, NULL for a raw input */
+    void *cb_arg;                       /* Argument of on_change */
+    esp_timer_handle_t debounce_timer;
+    esp_timer_handle_t long_press_timer;
 } my_gpio_btn_t;
 
 /******************************************************************
@@ -52,6 +59,5 @@ typedef struct {
  * 6. Functions definitions
 ******************************************************************/
 esp_err_t my_gpio_init(my_gpio_btn_t *btn);
-button_state_t my_gpio_read_btn(my_gpio_btn_t *btn);
 
 #endif // GPIO_DRIVER_H
\ No newline at end of file
@@ -5,36 +5,40 @@
 #include "../test/common/esp_stub.h"
 #endif
 #include "freertos/FreeRTOS.h"
+#include <stdatomic.h>
 #include "freertos/task.h"
-#include "esp_task_wdt.h"
 #include "esp_log.h"
 #include "gpio_task.h"
 #include "../gpio_driver/gpio_driver.h"
 #include "../rotary_encoder/rotary_encoder.h"
-#include "../event_bus/event_bus.h"
+#include "../event_bus/event_payloads.h"
 #include "esp_timer.h"
+#include "../mem_budget/mem_budget.h"
 
 /******************************************************************
  * 2. Define declarations (macros then function macros)
 ******************************************************************/
-#define GPIOTASK_ENCODER_QUEUE_SIZE        (50U)
+#define GPIOTASK_PRIORITY                  (3U)
+
+/* Rotary encoder acceleration curve: detent interval -> steps per detent */
+#define GPIOTASK_ACCEL_FAST_US             (25000U)
+#define GPIOTASK_ACCEL_FAST_STEPS          (5U)
+#define GPIOTASK_ACCEL_MEDIUM_US           (60000U)
+#define GPIOTASK_ACCEL_MEDIUM_STEPS        (2U)
 
 /******************************************************************
  * 3. Typedef definitions (simple typedef, then enum and structs)
 ******************************************************************/
-typedef struct {
-    button_state_t a;
-    button_state_t b;
-} gpio_event_t;
 
 /******************************************************************
  * 4. Variable definitions (static then global)
 ******************************************************************/
+/* Encoder channels start as plain inputs, edges are enabled once the decoder is ready */
 static my_gpio_btn_t rotaryEncoderChanA = {
     .pin = GPIO_NUM_5,
     .pull = MY_GPIO_PULL_NONE,
     .debounce_ms = 10,
-    .intr_type = GPIO_INTR_ANYEDGE,
+    .intr_type = GPIO_INTR_DISABLE,
     .isr_handler = NULL,
  };
 
@@ -42,53 +46,151 @@ static my_gpio_btn_t rotaryEncoderChanA = {
     .pin = GPIO_NUM_4,
     .pull = MY_GPIO_PULL_NONE,
     .debounce_ms = 10,
+    .intr_type = GPIO_INTR_DISABLE,
+    .isr_handler = NULL,
+};
+
+static my_gpio_btn_t rotaryEncoderSwitch = {
+    .pin = GPIO_NUM_3,
+    .pull = MY_GPIO_PULL_UP,
+    .debounce_ms = 50,
     .intr_type = GPIO_INTR_ANYEDGE,
     .isr_handler = NULL,
+    .on_change = NULL,
 };
 
+static StackType_t gpio_task_stack[MEM_BUDGET_GPIO_TASK_STACK_SIZE];
+static StaticTask_t gpio_task_tcb;
+static TaskHandle_t gpio_task_handle = NULL;
+
+/* Rotary encoder, decoded and accelerated in the ISR */
+static const DRAM_ATTR rotary_encoder_accel_point_t encoder_accel_curve[] = {
+    { GPIOTASK_ACCEL_FAST_US,   GPIOTASK_ACCEL_FAST_STEPS },
+    { GPIOTASK_ACCEL_MEDIUM_US, GPIOTASK_ACCEL_MEDIUM_STEPS },
+};
+static rotary_encoder_decoder_t encoder_decoder;
+static rotary_encoder_accel_t encoder_accel;
+static atomic_int_fast32_t encoder_detents = 0;     /* Pending steps, scaled by the acceleration curve */
+
 /******************************************************************
  * 5. Functions prototypes (static only)
 ******************************************************************/
 static void gpio_task(void *arg);
-static QueueHandle_t gpio_evt_queue = NULL;
+static void gpio_task_publish_detents(void);
+static void gpio_task_switch_callback(void *arg, button_state_t state, button_press_t press_type);
+static esp_err_t gpio_task_enable_encoder_isr(my_gpio_btn_t *chan);
+static void gpio_task_publish(buttons_type_t id, button_press_t pressed, button_state_t state,
+                              rotary_encoder_event_t update, uint8_t steps);
 
 /******************************************************************
  * 6. Functions definitions
 ******************************************************************/
 
+/**
+ * @brief Publish a button or rotary encoder event on the bus.
+ */
+static void gpio_task_publish(buttons_type_t id, button_press_t pressed, button_state_t state,
+                              rotary_encoder_event_t update, uint8_t steps)
+{
+    evt_button_t event = { id, pressed, state, update, steps };
+
+    (void)evt_button_publish(&event);
+}
+
 /**
  * @brief ISR for rotary encoder channels A and B.
  *
- * Debounces input, rejects duplicate states, and sends valid events to a queue.
+ * Runs the quadrature decoder on every edge. Completed detents are scaled
+ * by the rotation speed, added to an atomic counter and the GPIO task is
+ * notified, so nothing is queued per edge and a fast spin cannot overflow
+ * anything.
  *
  * @param[in] arg Unused argument.
  */
 static void IRAM_ATTR gpio_isr_handler(void* arg)
 {
     (void)arg;
-    static uint8_t previous_state = 0xFFU;
+    BaseType_t higher_priority_task_woken = pdFALSE;
 
-    gpio_event_t evt;
-    evt.a = gpio_get_level(rotaryEncoderChanA.pin);
-    evt.b = gpio_get_level(rotaryEncoderChanB.pin);
+    uint8_t levels = (uint8_t)((gpio_get_level(rotaryEncoderChanA.pin) << 1) | gpio_get_level(rotaryEncoderChanB.pin));
+    int8_t detent = rotary_encoder_decode(&encoder_decoder, levels);
 
-    uint8_t state = (evt.a << 1) | evt.b;
+    if (detent != 0) {
+        uint8_t steps = rotary_encoder_accel_steps(&encoder_accel, detent, esp_timer_get_time());
+        (void)atomic_fetch_add_explicit(&encoder_detents, (int_fast32_t)detent * (int_fast32_t)steps,
+                                        memory_order_relaxed);
+        vTaskNotifyGiveFromISR(gpio_task_handle, &higher_priority_task_woken);
+    }
+
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
 
-    if (state != previous_state) {
-        previous_state = state;
-        if (gpio_evt_queue != NULL) {
-            xQueueSendFromISR(gpio_evt_queue, &evt, NULL);
-        }
+/**
+ * @brief Publish the detents counted by the ISR since the last call.
+ *
+ * One EVT_CLOCK_GPIO_CONFIG event carries all pending detents of the
+ * same direction in its steps field.
+ */
+static void gpio_task_publish_detents(void)
+{
+    static const char GPIO_TASK_TAG[] = "GPIO_TASK";
+    int_fast32_t detents = atomic_exchange_explicit(&encoder_detents, 0, memory_order_relaxed);
+    rotary_encoder_event_t update = (detents > 0) ? ROTARY_ENCODER_EVENT_INCREMENT : ROTARY_ENCODER_EVENT_DECREMENT;
+    int_fast32_t steps = (detents > 0) ? detents : -detents;
+
+    if (steps > (int_fast32_t)UINT8_MAX) {
+        /* Cannot happen at a human spin rate, keep the remainder for the next call */
+        (void)atomic_fetch_add_explicit(&encoder_detents, detents - ((detents > 0) ? UINT8_MAX : -UINT8_MAX),
+                                        memory_order_relaxed);
+        steps = UINT8_MAX;
+    }
+
+    if (steps != 0) {
+        ESP_LOGI(GPIO_TASK_TAG, "%s x%d", (update == ROTARY_ENCODER_EVENT_INCREMENT) ?
+                 "ROTARY_ENCODER_EVENT_INCREMENT" : "ROTARY_ENCODER_EVENT_DECREMENT", (int)steps);
+        gpio_task_publish(BUTTON_ROTARY_ENCODER, 0U, BUTTON_STATE_RELEASE, update, (uint8_t)steps);
     }
 }
 
+/**
+ * @brief Debounced rotary switch change, called by the GPIO driver.
+ *
+ * Runs in the esp_timer task on each press, release and long press.
+ */
+static void gpio_task_switch_callback(void *arg, button_state_t state, button_press_t press_type)
+{
+    (void)arg;
+
+    gpio_task_publish(BUTTON_ROTARY_SWITCH_1, press_type, state, ROTARY_ENCODER_EVENT_NONE, 0U);
+}
+
+/**
+ * @brief Enable the edge interrupt of an encoder channel.
+ *
+ * Only called once the decoder and the acceleration tracker are
+ * initialized, so the ISR never sees them half set up.
+ */
+static esp_err_t gpio_task_enable_encoder_isr(my_gpio_btn_t *chan)
+{
+    esp_err_t err = ESP_OK;
+
+    chan->isr_handler = gpio_isr_handler;
+    err = gpio_isr_handler_add(chan->pin, chan->isr_handler, NULL);
+    if (err == ESP_OK) {
+        chan->intr_type = GPIO_INTR_ANYEDGE;
+        err = gpio_set_intr_type(chan->pin, chan->intr_type);
+    }
+
+    return err;
+}
+
 /**
  * @brief Main GPIO task.
  *
- * Initializes buttons and rotary encoder GPIOs, then loops:
- * - Reads rotary switch and encoder pins
- * - Detects state changes and sends events to event bus
- * - Logs actions for debugging
+ * Initializes buttons and rotary encoder GPIOs, then sleeps until the
+ * ISR notifies a rotary encoder detent and publishes it on the event bus.
+ * The rotary switch is handled by the GPIO driver timers, so the task never
+ * wakes up on its own and is not registered with the task watchdog.
  *
  * @param[in] arg Task argument (unused)
  */
@@ -97,20 +199,11 @@ static void gpio_task(void *arg)
     static const char GPIO_TASK_TAG[] = "GPIO_TASK";
     (void)arg;
 
-    my_gpio_btn_t rotaryEncoderSwitch = {
-        .pin = GPIO_NUM_3,
-        .pull = MY_GPIO_PULL_UP,
-        .debounce_ms = 50,
-        .intr_type = GPIO_INTR_DISABLE,
-        .isr_handler = NULL,
-    };
-
-    /* Add task watchdog */
-    esp_task_wdt_add(NULL);
+    /* The ISR notifies this task, set the handle before enabling it */
+    gpio_task_handle = xTaskGetCurrentTaskHandle();
 
     /* Set isr handler after its defined */
-    rotaryEncoderChanA.isr_handler = gpio_isr_handler;
-    rotaryEncoderChanB.isr_handler = gpio_isr_handler;
+    rotaryEncoderSwitch.on_change = gpio_task_switch_callback;
 
     if (my_gpio_init(&rotaryEncoderSwitch) != ESP_OK) {
         ESP_LOGE(GPIO_TASK_TAG, "Failed to initialize rotaryEncoderSwitch!");
@@ -124,90 +217,22 @@ static void gpio_task(void *arg)
         ESP_LOGE(GPIO_TASK_TAG, "Failed to initialize rotaryEncoderChanB!");
     }
 
-    /* Create queue before ISR can fire */
-    gpio_evt_queue = xQueueCreate(GPIOTASK_ENCODER_QUEUE_SIZE, sizeof(gpio_event_t));
+    rotary_encoder_accel_init(&encoder_accel, encoder_accel_curve,
+                              (uint8_t)(sizeof(encoder_accel_curve) / sizeof(encoder_accel_curve[0])));
+    rotary_encoder_decoder_init(&encoder_decoder,
+        (uint8_t)((gpio_get_level(rotaryEncoderChanA.pin) << 1) | gpio_get_level(rotaryEncoderChanB.pin)));
 
-    /* Initialize state_last_ variables */
-    button_state_t state_last_rotaryChanA = my_gpio_read_btn(&rotaryEncoderChanA);
-    button_state_t state_last_rotaryChanB = my_gpio_read_btn(&rotaryEncoderChanB);
-    button_state_t state_last_rotarySwitch = my_gpio_read_btn(&rotaryEncoderSwitch);
-    if (gpio_evt_queue == NULL) {
-        ESP_LOGE(GPIO_TASK_TAG, "Failed to create GPIO event queue!");
+    /* The ISR owns the decoder state from here on */
+    if ((gpio_task_enable_encoder_isr(&rotaryEncoderChanA) != ESP_OK) ||
+        (gpio_task_enable_encoder_isr(&rotaryEncoderChanB) != ESP_OK)) {
+        ESP_LOGE(GPIO_TASK_TAG, "Failed to enable rotary encoder interrupts!");
     }
 
     while(1) {
-        /* Reset watchdog */
-        esp_task_wdt_reset();
-
-        button_state_t state_rotarySwitch = my_gpio_read_btn(&rotaryEncoderSwitch);
-
-        /* Avoid sending event when no changes */
-        if (state_last_rotarySwitch != state_rotarySwitch) {
-
-            event_bus_message_t evt_message;
-            evt_message.type = EVT_CLOCK_GPIO_CONFIG;
-            evt_message.payload_size = 5U;
-            evt_message.payload[0U] = (buttons_type_t)BUTTON_ROTARY_SWITCH_1;
-            evt_message.payload[1U] = (button_press_t)rotaryEncoderSwitch.press_type;
-            evt_message.payload[2U] = (button_state_t)state_rotarySwitch;
-            evt_message.payload[3U] = 0U;
-            evt_message.payload[4U] = 0U;
-            event_bus_publish(evt_message);
-
-            state_last_rotarySwitch = state_rotarySwitch;
-        }
-
-        gpio_event_t evt_encoder;
-        static int8_t accumulator = 0;
-
-        /* Drain the queue and accumulate */
-        while (xQueueReceive(gpio_evt_queue, &evt_encoder, 0) == pdTRUE)
-        {
-            rotary_encoder_event_t ev = process_rotary_encoder(
-                state_last_rotaryChanA, state_last_rotaryChanB,
-                evt_encoder.a, evt_encoder.b);
-
-            if (ev == ROTARY_ENCODER_EVENT_INCREMENT) {
-                accumulator++;
-            } else if (ev == ROTARY_ENCODER_EVENT_DECREMENT) {
-                accumulator--;
-            } else {
-                /* ROTARY_ENCODER_EVENT_NONE */
-            }
-            state_last_rotaryChanA = evt_encoder.a;
-            state_last_rotaryChanB = evt_encoder.b;
-        }
-
-        int8_t steps = accumulator / 4;
-        accumulator = accumulator % 4;
-
-        if (steps > 0) {
-            ESP_LOGI(GPIO_TASK_TAG, "ROTARY_ENCODER_EVENT_INCREMENT: %d steps", steps);
-            event_bus_message_t evt_message;
-            evt_message.type = EVT_CLOCK_GPIO_CONFIG;
-            evt_message.payload_size = 5U;
-            evt_message.payload[0U] = (buttons_type_t)BUTTON_ROTARY_ENCODER;
-            evt_message.payload[1U] = 0U;
-            evt_message.payload[2U] = (button_state_t)BUTTON_STATE_RELEASE;
-            evt_message.payload[3U] = (uint8_t)ROTARY_ENCODER_EVENT_INCREMENT;
-            evt_message.payload[4U] = (uint8_t)steps;
-            event_bus_publish(evt_message);
-        } else if (steps < 0) {
-            ESP_LOGI(GPIO_TASK_TAG, "ROTARY_ENCODER_EVENT_DECREMENT: %d steps", -steps);
-            event_bus_message_t evt_message;
-            evt_message.type = EVT_CLOCK_GPIO_CONFIG;
-            evt_message.payload_size = 5U;
-            evt_message.payload[0U] = (buttons_type_t)BUTTON_ROTARY_ENCODER;
-            evt_message.payload[1U] = 0U;
-            evt_message.payload[2U] = (button_state_t)BUTTON_STATE_RELEASE;
-            evt_message.payload[3U] = (uint8_t)ROTARY_ENCODER_EVENT_DECREMENT;
-            evt_message.payload[4U] = (uint8_t)(-steps);    
-            event_bus_publish(evt_message);
-        } else {
-            /* steps == 0 */
-        }
-
-        vTaskDelay(pdMS_TO_TICKS(10));
+        /* Sleep until a detent completes */
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        gpio_task_publish_detents();
     }
 }
 
@@ -218,12 +243,13 @@ static void gpio_task(void *arg)
  */
 void gpio_task_start(void)
 {
-    xTaskCreate(
-        gpio_task,     /* Task function */
-        "gpio_task",   /* Task name (for debugging) */
-        4096,          /* Stack size in bytes */
-        NULL,          /* Parameter passed to the task */
-        3U,            /* Task priority */
-        NULL           /* Task handle (optional) */
+    (void)xTaskCreateStatic(
+        gpio_task,                          /* Task function */
+        "gpio_task",                        /* Task name (for debugging) */
+        MEM_BUDGET_GPIO_TASK_STACK_SIZE,    /* Stack size in bytes */
+        NULL,                               /* Parameter passed to the task */
+        GPIOTASK_PRIORITY,                  /* Task priority */
+        gpio_task_stack,                    /* Stack buffer */
+        &gpio_task_tcb                      /* Task control block */
     );
 }
@@ -19,14 +19,6 @@ typedef uint8_t buttons_type_t;
 /******************************************************************
  * 3. Typedef definitions (simple typedef, then enum and structs)
 ******************************************************************/
-/* Event struct shared between tasks */
-typedef struct {
-    buttons_type_t id;
-    button_press_t pressed;
-    button_state_t state;
-    rotary_encoder_event_t updateValue;
-    uint8_t steps;
-} button_event_t;
 
 /******************************************************************
  * 4. Variable definitions (static then global)
@@ -7,6 +7,7 @@
 #include "hv5622.h"
 #include "driver/spi_master.h"
 #include "driver/gpio.h"
+#include "../metrics/metrics.h"
 
 /******************************************************************
  * 2. Define declarations (macros then function macros)
@@ -90,4 +91,5 @@ void hv5622_send64(uint64_t data)
     /* latch */
     gpio_set_level(HV5622_PIN_LE, 0);
     gpio_set_level(HV5622_PIN_LE, 1);
+    metrics_inc(METRICS_SPI_FRAMES);
 }
\ No newline at end of file
@@ -0,0 +1,342 @@
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#include <limits.h>
+#include <string.h>
+#include "json_stream.h"
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+#define JSON_IS_DIGIT(c)     (((c) >= '0') && ((c) <= '9'))
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+/* Parser cursor over a mutable buffer, strings are decoded in place */
+typedef struct {
+    char *src;
+    size_t len;
+    size_t pos;
+} json_parser_t;
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+static void json_skip_ws(json_parser_t *p);
+static bool json_accept(json_parser_t *p, char c);
+static bool json_accept_literal(json_parser_t *p, const char *literal);
+static int json_hex_value(char c);
+static size_t json_utf8_encode(char *dst, uint32_t code);
+static json_status_t json_parse_string(json_parser_t *p, const char **out);
+static json_status_t json_parse_number(json_parser_t *p, long *out);
+static json_status_t json_parse_value(json_parser_t *p, json_value_t *value);
+
+/******************************************************************
+ * 6. Functions definitions
+******************************************************************/
+
+static void json_skip_ws(json_parser_t *p)
+{
+    while ((p->pos < p->len) &&
+           ((p->src[p->pos] == ' ') || (p->src[p->pos] == '\t') ||
+            (p->src[p->pos] == '\n') || (p->src[p->pos] == '\r'))) {
+        p->pos++;
+    }
+}
+
+/**
+ * @brief Consume c if it is the next character.
+ */
+static bool json_accept(json_parser_t *p, char c)
+{
+    bool accepted = (p->pos < p->len) && (p->src[p->pos] == c);
+
+    if (accepted == true) {
+        p->pos++;
+    }
+
+    return accepted;
+}
+
+static bool json_accept_literal(json_parser_t *p, const char *literal)
+{
+    size_t n = strlen(literal);
+    bool accepted = ((p->len - p->pos) >= n) && (memcmp(&p->src[p->pos], literal, n) == 0);
+
+    if (accepted == true) {
+        p->pos += n;
+    }
+
+    return accepted;
+}
+
+static int json_hex_value(char c)
+{
+    int value = -1;
+
+    if (JSON_IS_DIGIT(c)) {
+        value = c - '0';
+    }
+    else if ((c >= 'a') && (c <= 'f')) {
+        value = c - 'a' + 10;
+    }
+    else if ((c >= 'A') && (c <= 'F')) {
+        value = c - 'A' + 10;
+    }
+    else {
+        /* Not a hex digit */
+    }
+
+    return value;
+}
+
+/**
+ * @brief Encode a BMP code point as UTF-8, at most 3 bytes.
+ */
+static size_t json_utf8_encode(char *dst, uint32_t code)
+{
+    size_t n = 0U;
+
+    if (code < 0x80U) {
+        dst[n++] = (char)code;
+    }
+    else if (code < 0x800U) {
+        dst[n++] = (char)(0xC0U | (code >> 6));
+        dst[n++] = (char)(0x80U | (code & 0x3FU));
+    }
+    else {
+        dst[n++] = (char)(0xE0U | (code >> 12));
+        dst[n++] = (char)(0x80U | ((code >> 6) & 0x3FU));
+        dst[n++] = (char)(0x80U | (code & 0x3FU));
+    }
+
+    return n;
+}
+
+/**
+ * @brief Decode a string in place and null-terminate it.
+ *
+ * The decoded string is never longer than its escaped form, so it is
+ * written over the source starting at the opening quote.
+ */
+static json_status_t json_parse_string(json_parser_t *p, const char **out)
+{
+    json_status_t status = JSON_OK;
+    size_t write = p->pos;
+    bool done = false;
+
+    *out = &p->src[write];
+    p->pos++;   /* Opening quote */
+
+    while ((status == JSON_OK) && (done == false)) {
+        char c = (p->pos < p->len) ? p->src[p->pos] : '\0';
+
+        if ((p->pos >= p->len) || ((unsigned char)c < 0x20U)) {
+            status = JSON_ERR_SYNTAX;
+        }
+        else if (c == '"') {
+            p->src[write] = '\0';
+            p->pos++;
+            done = true;
+        }
+        else if (c != '\\') {
+            p->src[write++] = c;
+            p->pos++;
+        }
+        else if ((p->pos + 1U) >= p->len) {
+            status = JSON_ERR_SYNTAX;
+        }
+        else {
+            char e = p->src[p->pos + 1U];
+            p->pos += 2U;
+
+            switch (e) {
+                case '"':  p->src[write++] = '"';  break;
+                case '\\': p->src[write++] = '\\'; break;
+                case '/':  p->src[write++] = '/';  break;
+                case 'b':  p->src[write++] = '\b'; break;
+                case 'f':  p->src[write++] = '\f'; break;
+                case 'n':  p->src[write++] = '\n'; break;
+                case 'r':  p->src[write++] = '\r'; break;
+                case 't':  p->src[write++] = '\t'; break;
+                case 'u': {
+                    uint32_t code = 0U;
+                    for (uint8_t i = 0U; (status == JSON_OK) && (i < 4U); i++) {
+                        int digit = (p->pos < p->len) ? json_hex_value(p->src[p->pos]) : -1;
+                        if (digit < 0) {
+                            status = JSON_ERR_SYNTAX;
+                        }
+                        else {
+                            code = (code << 4) | (uint32_t)digit;
+                            p->pos++;
+                        }
+                    }
+                    if ((status == JSON_OK) && ((code == 0U) || ((code >= 0xD800U) && (code <= 0xDFFFU)))) {
+                        /* NUL would truncate the string, surrogate pairs are not decoded */
+                        status = JSON_ERR_UNSUPPORTED;
+                    }
+                    if (status == JSON_OK) {
+                        write += json_utf8_encode(&p->src[write], code);
+                    }
+                    break;
+                }
+                default:
+                    status = JSON_ERR_SYNTAX;
+                    break;
+            }
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief Parse an integer, fractions and exponents are not supported.
+ */
+static json_status_t json_parse_number(json_parser_t *p, long *out)
+{
+    json_status_t status = JSON_OK;
+    bool negative = json_accept(p, '-');
+    size_t first = p->pos;
+    long value = 0;
+
+    while ((status == JSON_OK) && (p->pos < p->len) && JSON_IS_DIGIT(p->src[p->pos])) {
+        long digit = (long)(p->src[p->pos] - '0');
+        if (value > ((LONG_MAX - digit) / 10L)) {
+            status = JSON_ERR_RANGE;
+        }
+        else {
+            value = (value * 10L) + digit;
+            p->pos++;
+        }
+    }
+
+    if (status != JSON_OK) {
+        /* Overflow */
+    }
+    else if ((p->pos == first) || ((p->src[first] == '0') && ((p->pos - first) > 1U))) {
+        /* No digits, or a leading zero */
+        status = JSON_ERR_SYNTAX;
+    }
+    else if ((p->pos < p->len) &&
+             ((p->src[p->pos] == '.') || (p->src[p->pos] == 'e') || (p->src[p->pos] == 'E'))) {
+        status = JSON_ERR_UNSUPPORTED;
+    }
+    else {
+        *out = negative ? -value : value;
+    }
+
+    return status;
+}
+
+static json_status_t json_parse_value(json_parser_t *p, json_value_t *value)
+{
+    json_status_t status = JSON_OK;
+    char c = (p->pos < p->len) ? p->src[p->pos] : '\0';
+
+    (void)memset(value, 0, sizeof(*value));
+
+    if (c == '"') {
+        value->type = JSON_VALUE_STRING;
+        status = json_parse_string(p, &value->str);
+    }
+    else if ((c == '-') || JSON_IS_DIGIT(c)) {
+        value->type = JSON_VALUE_NUMBER;
+        status = json_parse_number(p, &value->number);
+    }
+    else if (json_accept_literal(p, "true") == true) {
+        value->type = JSON_VALUE_BOOL;
+        value->boolean = true;
+    }
+    else if (json_accept_literal(p, "false") == true) {
+        value->type = JSON_VALUE_BOOL;
+        value->boolean = false;
+    }
+    else if (json_accept_literal(p, "null") == true) {
+        value->type = JSON_VALUE_NULL;
+    }
+    else if ((c == '{') || (c == '[')) {
+        status = JSON_ERR_UNSUPPORTED;
+    }
+    else {
+        status = JSON_ERR_SYNTAX;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Parse a flat JSON object and report each member.
+ *
+ * The buffer is modified: strings are unescaped in place, so keys and
+ * string values passed to cb stay valid until the buffer is reused. No
+ * heap is used. Members are reported as they are parsed, so cb may have
+ * run for the first members when an error is found later on.
+ *
+ * @param src Document, modified in place.
+ * @param len Length of the document, a trailing null is not required.
+ * @param cb Called for each member, returns false to stop parsing.
+ * @param ctx Argument of cb.
+ *
+ * @return JSON_OK if the whole document is a valid flat object.
+ */
+json_status_t json_parse_object(char *src, size_t len, json_member_cb_t cb, void *ctx)
+{
+    json_parser_t p = { src, len, 0U };
+    json_status_t status = JSON_OK;
+    bool more = false;
+
+    json_skip_ws(&p);
+    if (json_accept(&p, '{') == false) {
+        status = JSON_ERR_SYNTAX;
+    }
+    else {
+        json_skip_ws(&p);
+        more = (json_accept(&p, '}') == false);
+    }
+
+    while ((status == JSON_OK) && (more == true)) {
+        const char *key = NULL;
+        json_value_t value;
+
+        json_skip_ws(&p);
+        status = ((p.pos < p.len) && (p.src[p.pos] == '"')) ? json_parse_string(&p, &key) : JSON_ERR_SYNTAX;
+        if (status == JSON_OK) {
+            json_skip_ws(&p);
+            status = json_accept(&p, ':') ? JSON_OK : JSON_ERR_SYNTAX;
+        }
+        if (status == JSON_OK) {
+            json_skip_ws(&p);
+            status = json_parse_value(&p, &value);
+        }
+        if (status == JSON_OK) {
+            json_skip_ws(&p);
+            if (json_accept(&p, '}') == true) {
+                more = false;
+            }
+            else if (json_accept(&p, ',') == false) {
+                status = JSON_ERR_SYNTAX;
+            }
+            else {
+                /* Next member */
+            }
+        }
+        if ((status == JSON_OK) && (cb(ctx, key, &value) == false)) {
+            status = JSON_ERR_ABORTED;
+        }
+    }
+
+    if (status == JSON_OK) {
+        json_skip_ws(&p);
+        if ((p.pos < p.len) && (p.src[p.pos] != '\0')) {
+            status = JSON_ERR_SYNTAX;
+        }
+    }
+
+    return status;
+}
@@ -0,0 +1,89 @@
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+#define JSON_WRITER_MAX_DEPTH        (8U)    /* Nested objects and arrays */
+
+typedef uint8_t json_value_type_t;
+#define JSON_VALUE_STRING            ((json_value_type_t)0U)
+#define JSON_VALUE_NUMBER            ((json_value_type_t)1U)
+#define JSON_VALUE_BOOL              ((json_value_type_t)2U)
+#define JSON_VALUE_NULL              ((json_value_type_t)3U)
+
+typedef uint8_t json_status_t;
+#define JSON_OK                      ((json_status_t)0U)
+#define JSON_ERR_SYNTAX              ((json_status_t)1U)    /* Malformed document */
+#define JSON_ERR_UNSUPPORTED         ((json_status_t)2U)    /* Nested value, fraction, exponent or surrogate */
+#define JSON_ERR_RANGE               ((json_status_t)3U)    /* Number does not fit a long */
+#define JSON_ERR_ABORTED             ((json_status_t)4U)    /* Member callback returned false */
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+/* Writer output, called whenever the buffer is full and on json_writer_finish() */
+typedef bool (*json_flush_t)(void *ctx, const char *data, size_t len);
+
+/**
+ * Streaming JSON writer.
+ *
+ * Output is staged in a caller supplied buffer and handed to the flush
+ * callback in pieces, no heap is used. Commas are inserted automatically.
+ */
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;
+    json_flush_t flush;
+    void *ctx;
+    uint8_t depth;
+    bool has_members[JSON_WRITER_MAX_DEPTH];    /* A comma is needed before the next value */
+    bool after_key;                             /* Next value belongs to a key, no comma */
+    bool error;                                 /* Flush failed or nesting overflowed */
+} json_writer_t;
+
+/* Member of a parsed object, strings point into the parsed buffer */
+typedef struct {
+    json_value_type_t type;
+    const char *str;        /* JSON_VALUE_STRING, null-terminated */
+    long number;            /* JSON_VALUE_NUMBER, integers only */
+    bool boolean;           /* JSON_VALUE_BOOL */
+} json_value_t;
+
+typedef bool (*json_member_cb_t)(void *ctx, const char *key, const json_value_t *value);
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+
+/******************************************************************
+ * 6. Functions definitions (public API in .c)
+******************************************************************/
+void json_writer_init(json_writer_t *w, char *buf, size_t size, json_flush_t flush, void *ctx);
+void json_object_begin(json_writer_t *w);
+void json_object_end(json_writer_t *w);
+void json_array_begin(json_writer_t *w);
+void json_array_end(json_writer_t *w);
+void json_key(json_writer_t *w, const char *key);
+void json_string(json_writer_t *w, const char *value);
+void json_int(json_writer_t *w, long value);
+void json_uint(json_writer_t *w, unsigned long value);
+void json_bool(json_writer_t *w, bool value);
+void json_null(json_writer_t *w);
+bool json_writer_finish(json_writer_t *w);
+
+json_status_t json_parse_object(char *src, size_t len, json_member_cb_t cb, void *ctx);
+
+#endif // JSON_STREAM_H
@@ -0,0 +1,248 @@
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "json_stream.h"
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+#define JSON_WRITER_NUMBER_SIZE      (24U)   /* Fits any 64-bit long */
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+static void json_put(json_writer_t *w, const char *data, size_t len);
+static void json_put_char(json_writer_t *w, char c);
+static void json_value_begin(json_writer_t *w);
+static void json_put_string(json_writer_t *w, const char *value);
+static void json_container_begin(json_writer_t *w, char open);
+static void json_container_end(json_writer_t *w, char close);
+
+/******************************************************************
+ * 6. Functions definitions
+******************************************************************/
+
+/**
+ * @brief Append raw bytes, flushing the buffer when it is full.
+ */
+static void json_put(json_writer_t *w, const char *data, size_t len)
+{
+    size_t done = 0U;
+
+    while ((w->error == false) && (done < len)) {
+        if (w->len == w->size) {
+            w->error = (w->flush(w->ctx, w->buf, w->len) == false);
+            w->len = 0U;
+        }
+        if (w->error == false) {
+            size_t chunk = w->size - w->len;
+            if (chunk > (len - done)) {
+                chunk = len - done;
+            }
+            (void)memcpy(&w->buf[w->len], &data[done], chunk);
+            w->len += chunk;
+            done += chunk;
+        }
+    }
+}
+
+static void json_put_char(json_writer_t *w, char c)
+{
+    json_put(w, &c, 1U);
+}
+
+/**
+ * @brief Separate a value from the previous one when needed.
+ */
+static void json_value_begin(json_writer_t *w)
+{
+    if (w->after_key == true) {
+        w->after_key = false;
+    }
+    else if (w->has_members[w->depth] == true) {
+        json_put_char(w, ',');
+    }
+    else {
+        /* First value of the container */
+    }
+    w->has_members[w->depth] = true;
+}
+
+/**
+ * @brief Append a quoted and escaped string.
+ */
+static void json_put_string(json_writer_t *w, const char *value)
+{
+    static const char hex[] = "0123456789abcdef";
+    size_t start = 0U;
+    size_t i = 0U;
+
+    json_put_char(w, '"');
+    for (i = 0U; value[i] != '\0'; i++) {
+        unsigned char c = (unsigned char)value[i];
+
+        if ((c == (unsigned char)'"') || (c == (unsigned char)'\\') || (c < 0x20U)) {
+            json_put(w, &value[start], i - start);
+            start = i + 1U;
+
+            if (c == (unsigned char)'"') {
+                json_put(w, "\\\"", 2U);
+            }
+            else if (c == (unsigned char)'\\') {
+                json_put(w, "\\\\", 2U);
+            }
+            else if (c == (unsigned char)'\n') {
+                json_put(w, "\\n", 2U);
+            }
+            else {
+                char esc[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0x0FU] };
+                json_put(w, esc, sizeof(esc));
+            }
+        }
+    }
+    json_put(w, &value[start], i - start);
+    json_put_char(w, '"');
+}
+
+static void json_container_begin(json_writer_t *w, char open)
+{
+    json_value_begin(w);
+    if ((w->depth + 1U) < JSON_WRITER_MAX_DEPTH) {
+        w->depth++;
+        w->has_members[w->depth] = false;
+        json_put_char(w, open);
+    }
+    else {
+        w->error = true;
+    }
+}
+
+static void json_container_end(json_writer_t *w, char close)
+{
+    if (w->depth > 0U) {
+        w->depth--;
+        json_put_char(w, close);
+    }
+    else {
+        w->error = true;
+    }
+}
+
+/**
+ * @brief Initialize a writer.
+ *
+ * @param w Writer state.
+ * @param buf Staging buffer, at least one byte.
+ * @param size Size of buf.
+ * @param flush Output callback, returns false to abort the document.
+ * @param ctx Argument of flush.
+ */
+void json_writer_init(json_writer_t *w, char *buf, size_t size, json_flush_t flush, void *ctx)
+{
+    w->buf = buf;
+    w->size = size;
+    w->len = 0U;
+    w->flush = flush;
+    w->ctx = ctx;
+    w->depth = 0U;
+    w->has_members[0] = false;
+    w->after_key = false;
+    w->error = (buf == NULL) || (size == 0U) || (flush == NULL);
+}
+
+void json_object_begin(json_writer_t *w)
+{
+    json_container_begin(w, '{');
+}
+
+void json_object_end(json_writer_t *w)
+{
+    json_container_end(w, '}');
+}
+
+void json_array_begin(json_writer_t *w)
+{
+    json_container_begin(w, '[');
+}
+
+void json_array_end(json_writer_t *w)
+{
+    json_container_end(w, ']');
+}
+
+/**
+ * @brief Start an object member, the next call writes its value.
+ */
+void json_key(json_writer_t *w, const char *key)
+{
+    json_value_begin(w);
+    json_put_string(w, key);
+    json_put_char(w, ':');
+    w->after_key = true;
+}
+
+void json_string(json_writer_t *w, const char *value)
+{
+    json_value_begin(w);
+    json_put_string(w, (value != NULL) ? value : "");
+}
+
+void json_int(json_writer_t *w, long value)
+{
+    char number[JSON_WRITER_NUMBER_SIZE];
+    int len = snprintf(number, sizeof(number), "%ld", value);
+
+    json_value_begin(w);
+    json_put(w, number, (size_t)len);
+}
+
+void json_uint(json_writer_t *w, unsigned long value)
+{
+    char number[JSON_WRITER_NUMBER_SIZE];
+    int len = snprintf(number, sizeof(number), "%lu", value);
+
+    json_value_begin(w);
+    json_put(w, number, (size_t)len);
+}
+
+void json_bool(json_writer_t *w, bool value)
+{
+    json_value_begin(w);
+    if (value == true) {
+        json_put(w, "true", 4U);
+    }
+    else {
+        json_put(w, "false", 5U);
+    }
+}
+
+void json_null(json_writer_t *w)
+{
+    json_value_begin(w);
+    json_put(w, "null", 4U);
+}
+
+/**
+ * @brief Flush the remaining output.
+ *
+ * @return true if the whole document was written and is complete.
+ */
+bool json_writer_finish(json_writer_t *w)
+{
+    if ((w->error == false) && (w->len > 0U)) {
+        w->error = (w->flush(w->ctx, w->buf, w->len) == false);
+        w->len = 0U;
+    }
+
+    return (w->error == false) && (w->depth == 0U);
+}
@@ -0,0 +1,62 @@
+#ifndef MEM_BUDGET_H
+#define MEM_BUDGET_H
+
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+/**
+ * RAM budget of the RTOS objects, all sizes in one place.
+ *
+ * Tasks, queues and semaphores are created with the FreeRTOS *Static
+ * API from buffers sized here, so they live in .bss and no heap is used
+ * for them at startup. tools/mem_budget.py reports the resulting budget
+ * after each build.
+ *
+ * Stack sizes are in bytes, queue sizes in items.
+ */
+
+/* Dispatcher */
+#define MEM_BUDGET_DISPATCHER_STACK_SIZE            (4096U)
+#define MEM_BUDGET_DISPATCHER_POOL_WORKERS          (2U)
+#define MEM_BUDGET_DISPATCHER_POOL_STACK_SIZE       (4096U)
+#define MEM_BUDGET_DISPATCHER_POOL_QUEUE_SIZE       (16U)
+#define MEM_BUDGET_DISPATCHER_MAX_DEDICATED         (2U)
+#define MEM_BUDGET_DISPATCHER_DEDICATED_STACK_SIZE  (4096U)
+#define MEM_BUDGET_DISPATCHER_DEDICATED_QUEUE_SIZE  (4U)
+
+/* Event bus lanes */
+#define MEM_BUDGET_EVENT_BUS_INPUT_QUEUE_SIZE       (16U)
+#define MEM_BUDGET_EVENT_BUS_TIME_QUEUE_SIZE        (8U)
+#define MEM_BUDGET_EVENT_BUS_CONFIG_QUEUE_SIZE      (16U)
+#define MEM_BUDGET_EVENT_BUS_TELEMETRY_QUEUE_SIZE   (8U)
+
+/* Application tasks */
+#define MEM_BUDGET_GPIO_TASK_STACK_SIZE             (4096U)
+#define MEM_BUDGET_NTP_SYNC_STACK_SIZE              (4096U)
+
+/* Allocated from the heap by esp_http_server, cannot be static. Handler
+ * buffers larger than a few hundred bytes (OTA chunk and hash context)
+ * are static so image verification fits. */
+#define MEM_BUDGET_HTTPD_STACK_SIZE                 (6144U)
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+
+/******************************************************************
+ * 6. Functions definitions
+******************************************************************/
+
+#endif // MEM_BUDGET_H
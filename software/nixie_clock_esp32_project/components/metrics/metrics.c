@@ -0,0 +1,43 @@
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#include "metrics.h"
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+#define METRICS_DESC(id, name, help)     { (name), (help) },
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+atomic_uint_least32_t metrics_counters[METRICS_COUNTER_COUNT];
+
+/* Gauges start at 0, a gauge whose 0 is a valid value has a companion telling it was never set */
+atomic_int_least32_t metrics_gauges[METRICS_GAUGE_COUNT];
+
+metrics_hist_t metrics_histograms[METRICS_HISTOGRAM_COUNT];
+
+const metrics_desc_t metrics_counter_desc[METRICS_COUNTER_COUNT] = {
+    METRICS_COUNTERS(METRICS_DESC)
+};
+
+const metrics_desc_t metrics_gauge_desc[METRICS_GAUGE_COUNT] = {
+    METRICS_GAUGES(METRICS_DESC)
+};
+
+const metrics_desc_t metrics_histogram_desc[METRICS_HISTOGRAM_COUNT] = {
+    METRICS_HISTOGRAMS(METRICS_DESC)
+};
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+
+/******************************************************************
+ * 6. Functions definitions
+******************************************************************/
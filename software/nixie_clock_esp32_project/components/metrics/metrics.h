@@ -0,0 +1,134 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#include <stdatomic.h>
+#include <stdint.h>
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+/**
+ * Health counters, gauges and histograms, one line per metric.
+ *
+ * X(id, name, help)
+ * - id:   METRICS_<id> index for metrics_inc() / metrics_set() / metrics_observe()
+ * - name: exposition name, counters end with _total
+ * - help: one-line description shown by /metrics
+ *
+ * Updates are single relaxed atomics so they can sit on hot paths and in
+ * callbacks of other tasks, values are only formatted when scraped.
+ */
+#define METRICS_COUNTERS(X) \
+    X(SPI_FRAMES,        "nixie_spi_frames_total",         "Frames shifted into the HV5622 drivers") \
+    X(NTP_SYNCS,         "nixie_ntp_syncs_total",          "Time updates received from NTP") \
+    X(WIFI_DISCONNECTS,  "nixie_wifi_disconnects_total",   "Wi-Fi station disconnections") \
+    X(WIFI_RECONNECTS,   "nixie_wifi_reconnects_total",    "Wi-Fi station reconnection attempts") \
+    X(CONFIG_WRITES,     "nixie_config_writes_total",      "Configuration writes admitted from HTTP") \
+    X(CONFIG_WRITES_MERGED, "nixie_config_writes_merged_total", "Admitted writes merged into a later apply") \
+    X(CONFIG_WRITES_LIMITED_CLIENT, "nixie_config_writes_limited_client_total", "Writes refused with 429, client over its rate") \
+    X(CONFIG_WRITES_LIMITED_GLOBAL, "nixie_config_writes_limited_global_total", "Writes refused with 429, all clients over the rate") \
+    X(CONFIG_APPLIES,    "nixie_config_applies_total",     "Configuration changes applied from HTTP")
+
+#define METRICS_GAUGES(X) \
+    X(NTP_SYNCED,        "nixie_ntp_synced",               "1 once NTP has set the time, the other NTP gauges are 0 before") \
+    X(NTP_OFFSET_S,      "nixie_ntp_offset_seconds",       "Displayed time minus NTP time at the last sync") \
+    X(NTP_LAST_SYNC_S,   "nixie_ntp_last_sync_uptime_seconds", "Uptime at the last NTP sync")
+
+/* Values in us, same log2 buckets as the event bus histograms */
+#define METRICS_HISTOGRAMS(X) \
+    X(DISPLAY_JITTER_US, "nixie_display_frame_jitter_us",  "Distance of display frame intervals from their period")
+
+/* Histogram bucket i counts values in [2^i, 2^(i+1)), the last one is open-ended */
+#define METRICS_HIST_BUCKETS    (20U)
+
+#define METRICS_ENUM(id, name, help)     METRICS_##id,
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+typedef enum {
+    METRICS_COUNTERS(METRICS_ENUM)
+    METRICS_COUNTER_COUNT
+} metrics_counter_t;
+
+typedef enum {
+    METRICS_GAUGES(METRICS_ENUM)
+    METRICS_GAUGE_COUNT
+} metrics_gauge_t;
+
+typedef enum {
+    METRICS_HISTOGRAMS(METRICS_ENUM)
+    METRICS_HISTOGRAM_COUNT
+} metrics_histogram_t;
+
+typedef struct {
+    const char *name;
+    const char *help;
+} metrics_desc_t;
+
+typedef struct {
+    atomic_uint_least32_t buckets[METRICS_HIST_BUCKETS];
+    atomic_uint_least64_t sum;
+} metrics_hist_t;
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+extern atomic_uint_least32_t metrics_counters[METRICS_COUNTER_COUNT];
+extern atomic_int_least32_t metrics_gauges[METRICS_GAUGE_COUNT];
+extern metrics_hist_t metrics_histograms[METRICS_HISTOGRAM_COUNT];
+extern const metrics_desc_t metrics_counter_desc[METRICS_COUNTER_COUNT];
+extern const metrics_desc_t metrics_gauge_desc[METRICS_GAUGE_COUNT];
+extern const metrics_desc_t metrics_histogram_desc[METRICS_HISTOGRAM_COUNT];
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+
+/******************************************************************
+ * 6. Functions definitions (inline helpers)
+******************************************************************/
+static inline void metrics_inc(metrics_counter_t id)
+{
+    (void)atomic_fetch_add_explicit(&metrics_counters[id], 1U, memory_order_relaxed);
+}
+
+static inline uint32_t metrics_counter_get(metrics_counter_t id)
+{
+    return (uint32_t)atomic_load_explicit(&metrics_counters[id], memory_order_relaxed);
+}
+
+static inline void metrics_set(metrics_gauge_t id, int32_t value)
+{
+    atomic_store_explicit(&metrics_gauges[id], value, memory_order_relaxed);
+}
+
+static inline int32_t metrics_gauge_get(metrics_gauge_t id)
+{
+    return (int32_t)atomic_load_explicit(&metrics_gauges[id], memory_order_relaxed);
+}
+
+static inline void metrics_observe(metrics_histogram_t id, uint32_t value)
+{
+    uint8_t bucket = 0U;
+
+    for (uint32_t v = value; (v > 1U) && (bucket < (METRICS_HIST_BUCKETS - 1U)); v >>= 1U) {
+        bucket++;
+    }
+    (void)atomic_fetch_add_explicit(&metrics_histograms[id].buckets[bucket], 1U, memory_order_relaxed);
+    (void)atomic_fetch_add_explicit(&metrics_histograms[id].sum, (uint64_t)value, memory_order_relaxed);
+}
+
+/* Copy the buckets out, buckets and sum are read one by one, not as a whole */
+static inline uint64_t metrics_histogram_get(metrics_histogram_t id, uint32_t buckets[METRICS_HIST_BUCKETS])
+{
+    for (uint8_t i = 0U; i < METRICS_HIST_BUCKETS; i++) {
+        buckets[i] = (uint32_t)atomic_load_explicit(&metrics_histograms[id].buckets[i], memory_order_relaxed);
+    }
+    return (uint64_t)atomic_load_explicit(&metrics_histograms[id].sum, memory_order_relaxed);
+}
+
+#endif // METRICS_H
@@ -9,12 +9,18 @@
 #include "esp_netif_sntp.h"
 #include "esp_task_wdt.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "../clock/clock.h"
+#include "../clock_task/clock_task.h"
 #include "ntp.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "freertos/semphr.h"
 #include "../config/config.h"
 #include "../event_bus/event_bus.h"
+#include "../event_bus/event_payloads.h"
+#include "../mem_budget/mem_budget.h"
+#include "../metrics/metrics.h"
 #include <string.h>
 
 /******************************************************************
@@ -23,6 +29,8 @@
 /* NTP minimum interval in milliseconds is 15000ms */
 #define NTP_INTERVAL_MS         (30000U)
 #define NTP_WAIT_WIFI_MS        (1000U)
+#define NTP_SYNC_TASK_PRIORITY  (2U)
+#define NTP_SECONDS_PER_DAY     (86400)
 
 /******************************************************************
  * 3. Typedef definitions (simple typedef, then enum and structs)
@@ -33,6 +41,9 @@
 ******************************************************************/
 static SemaphoreHandle_t time_sync_done_sem = NULL;
 static TaskHandle_t time_sync_task_handle = NULL;
+static StaticSemaphore_t time_sync_done_sem_buffer;
+static StackType_t time_sync_task_stack[MEM_BUDGET_NTP_SYNC_STACK_SIZE];
+static StaticTask_t time_sync_task_tcb;
 static const char NTP_TAG[] = "NTP";
 
 /******************************************************************
@@ -41,6 +52,7 @@ static const char NTP_TAG[] = "NTP";
 static void time_sync_task(void *arg);
 static void time_sync_notification_cb(struct timeval *tv);
 static void timestamp_to_hms(uint32_t timestamp, myclock_t *clock);
+static void ntp_record_sync(const myclock_t *synced);
 
 /******************************************************************
  * 6. Functions definitions
@@ -62,6 +74,38 @@ static void timestamp_to_hms(uint32_t timestamp, myclock_t *clock)
     clock->seconds = (uint8_t)(t % 60U);
 }
 
+/**
+ * @brief Record the sync in the health metrics.
+ *
+ * The offset is the drift of the displayed clock since the previous
+ * sync, wrapped to half a day either way.
+ *
+ * @param synced Time received from NTP.
+ */
+static void ntp_record_sync(const myclock_t *synced)
+{
+    myclock_t shown;
+
+    if (clock_get_copy(&shown) == true) {
+        int32_t offset = ((((int32_t)shown.hours - (int32_t)synced->hours) * 3600) +
+                          (((int32_t)shown.minutes - (int32_t)synced->minutes) * 60) +
+                          ((int32_t)shown.seconds - (int32_t)synced->seconds));
+        if (offset >= (NTP_SECONDS_PER_DAY / 2)) {
+            offset -= NTP_SECONDS_PER_DAY;
+        }
+        else if (offset < -(NTP_SECONDS_PER_DAY / 2)) {
+            offset += NTP_SECONDS_PER_DAY;
+        }
+        else {
+            /* Already in range */
+        }
+        metrics_set(METRICS_NTP_OFFSET_S, offset);
+    }
+    metrics_set(METRICS_NTP_LAST_SYNC_S, (int32_t)(esp_timer_get_time() / 1000000LL));
+    metrics_set(METRICS_NTP_SYNCED, 1);
+    metrics_inc(METRICS_NTP_SYNCS);
+}
+
 /**
  * @brief Callback invoked on SNTP time update.
  *
@@ -78,17 +122,13 @@ static void time_sync_notification_cb(struct timeval *tv)
     {
         uint32_t now32 = (uint32_t)tv->tv_sec;
         timestamp_to_hms(now32, &clockUpdate);
+        ntp_record_sync(&clockUpdate);
 
         /* Send clock data to evt_bus */
-        event_bus_message_t evt_message;
-        evt_message.payload[0U] = clockUpdate.hours;
-        evt_message.payload[1U] = clockUpdate.minutes;
-        evt_message.payload[2U] = clockUpdate.seconds;
-        evt_message.type = EVT_CLOCK_NTP_CONFIG;
-        evt_message.payload_size = 3U;
-
-        event_bus_publish(evt_message);
-        ESP_LOGI(NTP_TAG, "NTP SYNC");
+        evt_clock_time_t time = { clockUpdate.hours, clockUpdate.minutes, clockUpdate.seconds };
+        if (evt_clock_time_publish(&time) == true) {
+            ESP_LOGI(NTP_TAG, "NTP SYNC");
+        }
     }
     else {
         ESP_LOGE(NTP_TAG, "Invalid SNTP timestamp or NULL pointer");
@@ -166,7 +206,8 @@ static void time_sync_task(void *arg)
     /* Give the semaphore (so ntp_stop() can finish) */
     xSemaphoreGive(time_sync_done_sem);
 
-    vTaskDelete(NULL);
+    /* Parked until ntp_stop() deletes it, so the static stack is free for a restart */
+    vTaskSuspend(NULL);
 }
 
 /**
@@ -178,19 +219,20 @@ static void time_sync_task(void *arg)
 static void ntp_sync_task_start(void)
 {
     if ((time_sync_done_sem == NULL) && (time_sync_task_handle == NULL)) {
-        time_sync_done_sem = xSemaphoreCreateBinary();
+        time_sync_done_sem = xSemaphoreCreateBinaryStatic(&time_sync_done_sem_buffer);
         if (time_sync_done_sem == NULL) {
             ESP_LOGE(NTP_TAG, "Failed to create done semaphore");
         }
         else {
-            BaseType_t ret = xTaskCreate(time_sync_task,
-                                         "time_sync_task",
-                                         4096,
-                                         NULL,
-                                         2U,
-                                         &time_sync_task_handle);
-
-            if (ret != pdPASS) {
+            time_sync_task_handle = xTaskCreateStatic(time_sync_task,
+                                                      "time_sync_task",
+                                                      MEM_BUDGET_NTP_SYNC_STACK_SIZE,
+                                                      NULL,
+                                                      NTP_SYNC_TASK_PRIORITY,
+                                                      time_sync_task_stack,
+                                                      &time_sync_task_tcb);
+
+            if (time_sync_task_handle == NULL) {
                 ESP_LOGE(NTP_TAG, "Failed to create time_sync_task");
             }
         }
@@ -227,7 +269,8 @@ static void ntp_stop(void)
             ESP_LOGE(NTP_TAG, "Semaphore wait failed (should never happen)");
         }
 
-        /* Cleanup */
+        /* Cleanup, the task is suspended or about to be */
+        vTaskDelete(time_sync_task_handle);
         if (time_sync_done_sem != NULL) {
             vSemaphoreDelete(time_sync_done_sem);
             time_sync_done_sem = NULL;
@@ -249,7 +292,7 @@ static void ntp_stop(void)
  * synchronization task depending on the `ntp` parameter.
  * Ensures NTP is not re-started or re-stopped unnecessarily.
  */
-void ntp_callback(uint8_t* payload, uint8_t size) {
+void ntp_callback(uint8_t* payload, uint16_t size) {
     (void)payload;
     (void)size;
     esp_err_t result = ESP_OK;
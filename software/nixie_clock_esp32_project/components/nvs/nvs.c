@@ -15,11 +15,6 @@
 /******************************************************************
  * 2. Define declarations (macros then function macros)
 ******************************************************************/
-#ifdef UNITY_TESTING
-#define NOT_STATIC
-#else
-#define NOT_STATIC static
-#endif
 
 /******************************************************************
  * 3. Typedef definitions (simple typedef, then enum and structs)
@@ -72,7 +67,7 @@ esp_err_t nvs_init(void)
  * @param value The int32_t value to save.
  * @return esp_err_t ESP_OK on success, otherwise an error code.
  */
-NOT_STATIC esp_err_t nvs_save_value(const char *key, uint8_t value)
+esp_err_t nvs_save_value(const char *key, uint8_t value)
 {
     nvs_handle_t handle = 0U;
     esp_err_t err = ESP_FAIL;
@@ -105,7 +100,7 @@ NOT_STATIC esp_err_t nvs_save_value(const char *key, uint8_t value)
  * @param value The null-terminated string to save.
  * @return esp_err_t ESP_OK on success, otherwise an error code.
  */
-NOT_STATIC esp_err_t nvs_save_str(const char * key, const char * value)
+esp_err_t nvs_save_str(const char * key, const char * value)
 {
     nvs_handle_t handle = 0U;
     esp_err_t err = ESP_FAIL;
@@ -144,7 +139,7 @@ NOT_STATIC esp_err_t nvs_save_str(const char * key, const char * value)
  * @param value Pointer to an int32_t variable where the result will be stored.
  * @return esp_err_t ESP_OK on success, otherwise an error code.
  */
-NOT_STATIC esp_err_t nvs_load_value(const char *key, uint8_t *value)
+esp_err_t nvs_load_value(const char *key, uint8_t *value)
 {
     nvs_handle_t handle = 0U;
     esp_err_t ret = ESP_FAIL;
@@ -177,7 +172,7 @@ NOT_STATIC esp_err_t nvs_load_value(const char *key, uint8_t *value)
  *               updated with the actual string length (including null terminator).
  * @return esp_err_t ESP_OK on success, otherwise an error code.
  */
-NOT_STATIC esp_err_t nvs_load_str(const char * key, char * value, size_t * length)
+esp_err_t nvs_load_str(const char * key, char * value, size_t * length)
 {
     nvs_handle_t handle = 0U;
     esp_err_t err = ESP_FAIL;
@@ -206,18 +201,3 @@ NOT_STATIC esp_err_t nvs_load_str(const char * key, char * value, size_t * lengt
 
 esp_err_t nvs_save_init_flag(uint8_t enabled)       { return nvs_save_value("init_flag", enabled); }
 esp_err_t nvs_load_init_flag(uint8_t *enabled)      { return nvs_load_value("init_flag", enabled); }
-
-esp_err_t nvs_save_ntp(uint8_t enabled)             { return nvs_save_value("ntp", enabled); }
-esp_err_t nvs_load_ntp(uint8_t *enabled)            { return nvs_load_value("ntp", enabled); }
-
-esp_err_t nvs_save_mode(uint8_t value)              { return nvs_save_value("mode", value); }
-esp_err_t nvs_load_mode(uint8_t *value)             { return nvs_load_value("mode", value); }
-
-esp_err_t nvs_save_dutycycle(uint8_t value)         { return nvs_save_value("dutycycle", value); }
-esp_err_t nvs_load_dutycycle(uint8_t *value)        { return nvs_load_value("dutycycle", value); }
-
-esp_err_t nvs_save_ssid(const char *value)                         { return nvs_save_str("ssid", value); }
-esp_err_t nvs_load_ssid(char *value, size_t *length)               { return nvs_load_str("ssid", value, length); }
-
-esp_err_t nvs_save_wpa_passphrase(const char *value)               { return nvs_save_str("wpa_passphrase", value); }
-esp_err_t nvs_load_wpa_passphrase(char *value, size_t *length)     { return nvs_load_str("wpa_passphrase", value, length); }
\ No newline at end of file
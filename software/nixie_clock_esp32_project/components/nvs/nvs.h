@@ -34,26 +34,9 @@ esp_err_t nvs_init(void);
 esp_err_t nvs_save_init_flag(uint8_t enabled);
 esp_err_t nvs_load_init_flag(uint8_t *enabled);
 
-esp_err_t nvs_save_ntp(uint8_t enabled);
-esp_err_t nvs_load_ntp(uint8_t *enabled);
-
-esp_err_t nvs_save_mode(uint8_t value);
-esp_err_t nvs_load_mode(uint8_t *value);
-
-esp_err_t nvs_save_dutycycle(uint8_t value);
-esp_err_t nvs_load_dutycycle(uint8_t *value);
-
-esp_err_t nvs_save_ssid(const char *value);
-esp_err_t nvs_load_ssid(char *value, size_t *length);
-
-esp_err_t nvs_save_wpa_passphrase(const char *value);
-esp_err_t nvs_load_wpa_passphrase(char *value, size_t *length);
-
-#ifdef UNITY_TESTING
-esp_err_t nvs_save_str(const char * key, const char * value);
-esp_err_t nvs_load_str(const char * key, char * value, size_t * length);
 esp_err_t nvs_save_value(const char *key, uint8_t value);
 esp_err_t nvs_load_value(const char *key, uint8_t *value);
-#endif
+esp_err_t nvs_save_str(const char * key, const char * value);
+esp_err_t nvs_load_str(const char * key, char * value, size_t * length);
 
 #endif // NVS_H
\ No newline at end of file
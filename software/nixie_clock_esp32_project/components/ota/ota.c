@@ -0,0 +1,241 @@
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#ifdef STATIC_ANALYSIS
+#include "../test/common/esp_stub.h"
+#endif
+#include <string.h>
+#include "esp_log.h"
+#include "ota.h"
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+static const char OTA_TAG[] = "OTA";
+
+/* One update at a time, the partition cannot be shared */
+static bool ota_update_running = false;
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+
+/******************************************************************
+ * 6. Functions definitions
+******************************************************************/
+
+/**
+ * @brief Start an update of the inactive OTA partition.
+ *
+ * Fails with ESP_ERR_OTA_ROLLBACK_INVALID_STATE while the running image
+ * has not passed its health check yet.
+ *
+ * @param update Update state, owned by the caller until finished or aborted.
+ * @param size Image size in bytes.
+ *
+ * @return ESP_OK if the image can be written,
+ *         ESP_ERR_INVALID_STATE if another update is running,
+ *         ESP_ERR_NOT_FOUND if there is no OTA partition,
+ *         ESP_ERR_INVALID_SIZE if the image is empty or does not fit,
+ *         or the esp_ota_begin() error.
+ */
+esp_err_t ota_update_begin(ota_update_t *update, size_t size)
+{
+    esp_err_t ret = ESP_OK;
+
+    update->active = false;
+    update->partition = esp_ota_get_next_update_partition(NULL);
+
+    if (ota_update_running == true) {
+        ret = ESP_ERR_INVALID_STATE;
+    }
+    else if (update->partition == NULL) {
+        ret = ESP_ERR_NOT_FOUND;
+    }
+    else if ((size == 0U) || (size > update->partition->size)) {
+        ret = ESP_ERR_INVALID_SIZE;
+    }
+    else {
+        /* Erase as the data arrives instead of the whole partition up front */
+        ret = esp_ota_begin(update->partition, OTA_WITH_SEQUENTIAL_WRITES, &update->handle);
+    }
+
+    if (ret == ESP_OK) {
+        mbedtls_sha256_init(&update->sha);
+        (void)mbedtls_sha256_starts(&update->sha, 0);
+        update->size = size;
+        update->written = 0U;
+        update->active = true;
+        ota_update_running = true;
+        ESP_LOGI(OTA_TAG, "Writing %u bytes to %s", (unsigned)size, update->partition->label);
+    }
+    else {
+        ESP_LOGE(OTA_TAG, "Cannot start update: %s", esp_err_to_name(ret));
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Hash and write the next part of the image.
+ *
+ * The update is aborted on error.
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_SIZE if the data goes past the
+ *         announced size, or the esp_ota_write() error.
+ */
+esp_err_t ota_update_write(ota_update_t *update, const void *data, size_t len)
+{
+    esp_err_t ret = ESP_OK;
+
+    if (update->active == false) {
+        ret = ESP_ERR_INVALID_STATE;
+    }
+    else if (len > (update->size - update->written)) {
+        ret = ESP_ERR_INVALID_SIZE;
+    }
+    else {
+        (void)mbedtls_sha256_update(&update->sha, (const unsigned char *)data, len);
+        ret = esp_ota_write(update->handle, data, len);
+    }
+
+    if (ret == ESP_OK) {
+        update->written += len;
+    }
+    else if (update->active == true) {
+        ESP_LOGE(OTA_TAG, "Write failed at %u: %s", (unsigned)update->written, esp_err_to_name(ret));
+        ota_update_abort(update);
+    }
+    else {
+        /* Nothing to abort */
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Check the image and select it for the next boot.
+ *
+ * The image is only selected if the whole announced size was written,
+ * its SHA-256 matches the expected one and esp_ota_end() validates it.
+ * The update is aborted otherwise.
+ *
+ * @param update Update state.
+ * @param expected_sha256 Expected digest, NULL to skip the comparison.
+ * @param[out] sha256 Digest of the received image.
+ *
+ * @return ESP_OK if the image boots next,
+ *         ESP_ERR_INVALID_SIZE if the image is incomplete,
+ *         ESP_ERR_INVALID_CRC if the digest does not match,
+ *         ESP_ERR_OTA_VALIDATE_FAILED if the image is not a valid app,
+ *         or the esp_ota_set_boot_partition() error.
+ */
+esp_err_t ota_update_finish(ota_update_t *update, const uint8_t *expected_sha256, uint8_t sha256[OTA_SHA256_SIZE])
+{
+    esp_err_t ret = ESP_OK;
+
+    if (update->active == false) {
+        ret = ESP_ERR_INVALID_STATE;
+    }
+    else {
+        (void)mbedtls_sha256_finish(&update->sha, sha256);
+        mbedtls_sha256_free(&update->sha);
+
+        if (update->written != update->size) {
+            ret = ESP_ERR_INVALID_SIZE;
+        }
+        else if ((expected_sha256 != NULL) && (memcmp(expected_sha256, sha256, OTA_SHA256_SIZE) != 0)) {
+            ret = ESP_ERR_INVALID_CRC;
+        }
+        else {
+            /* Also checks the image header and its appended digest */
+            ret = esp_ota_end(update->handle);
+            update->active = false;
+            ota_update_running = false;
+            if (ret == ESP_OK) {
+                ret = esp_ota_set_boot_partition(update->partition);
+            }
+        }
+
+        if (update->active == true) {
+            ota_update_abort(update);
+        }
+    }
+
+    if (ret == ESP_OK) {
+        ESP_LOGI(OTA_TAG, "Image accepted, %s boots next", update->partition->label);
+    }
+    else {
+        ESP_LOGE(OTA_TAG, "Image rejected: %s", esp_err_to_name(ret));
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Drop an update, the running image stays selected.
+ */
+void ota_update_abort(ota_update_t *update)
+{
+    if (update->active == true) {
+        (void)esp_ota_abort(update->handle);
+        mbedtls_sha256_free(&update->sha);
+        update->active = false;
+        ota_update_running = false;
+    }
+}
+
+/**
+ * @brief Tell whether the running image still has to pass its health check.
+ *
+ * @return true on the first boot of a new image, until ota_boot_confirm().
+ */
+bool ota_boot_is_pending(void)
+{
+    esp_ota_img_states_t state = ESP_OTA_IMG_UNDEFINED;
+
+    return (esp_ota_get_state_partition(esp_ota_get_running_partition(), &state) == ESP_OK) &&
+           (state == ESP_OTA_IMG_PENDING_VERIFY);
+}
+
+/**
+ * @brief Keep or roll back the running image after its health check.
+ *
+ * A healthy image is marked valid. Otherwise it is marked invalid and
+ * the device restarts on the previous image. The bootloader also rolls
+ * back if the device resets before this call.
+ *
+ * @param healthy Result of the health check.
+ *
+ * @return ESP_OK if the image was kept, the esp_ota error otherwise. Does
+ *         not return when rolling back.
+ */
+esp_err_t ota_boot_confirm(bool healthy)
+{
+    esp_err_t ret = ESP_OK;
+
+    if (healthy == true) {
+        ret = esp_ota_mark_app_valid_cancel_rollback();
+        if (ret == ESP_OK) {
+            ESP_LOGI(OTA_TAG, "Health check passed, image marked valid");
+        }
+    }
+    else {
+        ESP_LOGE(OTA_TAG, "Health check failed, rolling back");
+        ret = esp_ota_mark_app_invalid_rollback_and_reboot();
+    }
+
+    if (ret != ESP_OK) {
+        ESP_LOGE(OTA_TAG, "Cannot confirm image: %s", esp_err_to_name(ret));
+    }
+
+    return ret;
+}
@@ -0,0 +1,55 @@
+#ifndef OTA_H
+#define OTA_H
+
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_ota_ops.h"
+#include "mbedtls/sha256.h"
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+#define OTA_SHA256_SIZE                  (32U)
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+/**
+ * Firmware update streamed into the inactive OTA partition.
+ *
+ * Data is hashed and written as it arrives, the partition is erased
+ * sector by sector ahead of the writes, so no image buffer is needed.
+ */
+typedef struct {
+    const esp_partition_t *partition;
+    esp_ota_handle_t handle;
+    mbedtls_sha256_context sha;
+    size_t size;                /* Announced image size */
+    size_t written;
+    bool active;
+} ota_update_t;
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+
+/******************************************************************
+ * 6. Functions definitions (public API in .c)
+******************************************************************/
+esp_err_t ota_update_begin(ota_update_t *update, size_t size);
+esp_err_t ota_update_write(ota_update_t *update, const void *data, size_t len);
+esp_err_t ota_update_finish(ota_update_t *update, const uint8_t *expected_sha256, uint8_t sha256[OTA_SHA256_SIZE]);
+void ota_update_abort(ota_update_t *update);
+bool ota_boot_is_pending(void);
+esp_err_t ota_boot_confirm(bool healthy);
+
+#endif // OTA_H
@@ -25,6 +25,6 @@
  * 6. Functions definitions
 ******************************************************************/
 void pwm_init(void);
-void pwm_callback(uint8_t* payload, uint8_t size);
+void pwm_callback(uint8_t* payload, uint16_t size);
 
 #endif // PWM_H
\ No newline at end of file
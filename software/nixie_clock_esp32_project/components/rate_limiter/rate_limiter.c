@@ -0,0 +1,179 @@
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#include "rate_limiter.h"
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+static void rate_limiter_refill(rate_limiter_bucket_t *bucket, const rate_limiter_rate_t *rate, uint32_t now_ms);
+static uint32_t rate_limiter_wait(const rate_limiter_bucket_t *bucket, const rate_limiter_rate_t *rate, uint32_t now_ms);
+static rate_limiter_client_t *rate_limiter_client(rate_limiter_t *limiter, uint32_t key, uint32_t now_ms);
+
+/******************************************************************
+ * 6. Functions definitions
+******************************************************************/
+
+/**
+ * @brief Credit the tokens earned since the last refill.
+ *
+ * Only whole periods are credited, the remainder is kept for the next
+ * call. A full bucket earns nothing, so idle time is not banked.
+ */
+static void rate_limiter_refill(rate_limiter_bucket_t *bucket, const rate_limiter_rate_t *rate, uint32_t now_ms)
+{
+    uint32_t elapsed = now_ms - bucket->refilled_ms;
+    uint32_t earned = elapsed / rate->period_ms;
+
+    if ((bucket->tokens >= rate->burst) || (earned >= (rate->burst - bucket->tokens))) {
+        bucket->tokens = rate->burst;
+        bucket->refilled_ms = now_ms;
+    }
+    else {
+        bucket->tokens += earned;
+        bucket->refilled_ms += earned * rate->period_ms;
+    }
+}
+
+/**
+ * @brief Time until a refilled bucket holds a token, 0 if it has one.
+ */
+static uint32_t rate_limiter_wait(const rate_limiter_bucket_t *bucket, const rate_limiter_rate_t *rate, uint32_t now_ms)
+{
+    uint32_t wait = 0U;
+
+    if (bucket->tokens == 0U) {
+        wait = rate->period_ms - (now_ms - bucket->refilled_ms);
+    }
+
+    return wait;
+}
+
+/**
+ * @brief Find the slot of a client, or recycle one for it.
+ *
+ * A new client gets a free slot, or else the one whose last request is
+ * the oldest, with a full bucket.
+ */
+static rate_limiter_client_t *rate_limiter_client(rate_limiter_t *limiter, uint32_t key, uint32_t now_ms)
+{
+    rate_limiter_client_t *client = NULL;
+    rate_limiter_client_t *oldest = &limiter->clients[0];
+
+    for (uint8_t i = 0U; (i < RATE_LIMITER_MAX_CLIENTS) && (client == NULL); i++) {
+        rate_limiter_client_t *slot = &limiter->clients[i];
+
+        if ((slot->used == true) && (slot->key == key)) {
+            client = slot;
+        }
+        else if ((oldest->used == true) &&
+                 ((slot->used == false) || ((now_ms - slot->seen_ms) > (now_ms - oldest->seen_ms)))) {
+            oldest = slot;
+        }
+        else {
+            /* Keep the current candidate */
+        }
+    }
+
+    if (client == NULL) {
+        client = oldest;
+        client->used = true;
+        client->key = key;
+        client->bucket.tokens = limiter->client_rate.burst;
+        client->bucket.refilled_ms = now_ms;
+    }
+    client->seen_ms = now_ms;
+
+    return client;
+}
+
+/**
+ * @brief Reset the limiter, every bucket starts full.
+ *
+ * @param limiter Limiter state.
+ * @param client_rate Rate allowed to each client.
+ * @param global_rate Rate allowed to all clients together.
+ * @param now_ms Current time.
+ */
+void rate_limiter_init(rate_limiter_t *limiter, const rate_limiter_rate_t *client_rate,
+                       const rate_limiter_rate_t *global_rate, uint32_t now_ms)
+{
+    limiter->client_rate = *client_rate;
+    limiter->global_rate = *global_rate;
+
+    /* A zero period would never refill, a zero burst never allow */
+    if (limiter->client_rate.period_ms == 0U) {
+        limiter->client_rate.period_ms = 1U;
+    }
+    if (limiter->global_rate.period_ms == 0U) {
+        limiter->global_rate.period_ms = 1U;
+    }
+    if (limiter->client_rate.burst == 0U) {
+        limiter->client_rate.burst = 1U;
+    }
+    if (limiter->global_rate.burst == 0U) {
+        limiter->global_rate.burst = 1U;
+    }
+
+    limiter->global.tokens = limiter->global_rate.burst;
+    limiter->global.refilled_ms = now_ms;
+    for (uint8_t i = 0U; i < RATE_LIMITER_MAX_CLIENTS; i++) {
+        limiter->clients[i].used = false;
+    }
+}
+
+/**
+ * @brief Take a token for one request of a client.
+ *
+ * The client is checked first, so a client over its own limit does not
+ * drain the global bucket for the others.
+ *
+ * @param limiter Limiter state.
+ * @param key Client identifier.
+ * @param now_ms Current time.
+ * @param[out] retry_ms Time until the request would be allowed, 0 when
+ *             allowed. May be NULL.
+ *
+ * @return RATE_LIMITER_ALLOWED if a token was taken, otherwise the bucket
+ *         that was empty.
+ */
+rate_limiter_result_t rate_limiter_take(rate_limiter_t *limiter, uint32_t key, uint32_t now_ms, uint32_t *retry_ms)
+{
+    rate_limiter_result_t result = RATE_LIMITER_ALLOWED;
+    rate_limiter_client_t *client = rate_limiter_client(limiter, key, now_ms);
+    uint32_t wait = 0U;
+
+    rate_limiter_refill(&client->bucket, &limiter->client_rate, now_ms);
+    rate_limiter_refill(&limiter->global, &limiter->global_rate, now_ms);
+
+    if (client->bucket.tokens == 0U) {
+        result = RATE_LIMITER_LIMITED_CLIENT;
+        wait = rate_limiter_wait(&client->bucket, &limiter->client_rate, now_ms);
+    }
+    else if (limiter->global.tokens == 0U) {
+        result = RATE_LIMITER_LIMITED_GLOBAL;
+        wait = rate_limiter_wait(&limiter->global, &limiter->global_rate, now_ms);
+    }
+    else {
+        client->bucket.tokens--;
+        limiter->global.tokens--;
+    }
+
+    if (retry_ms != NULL) {
+        *retry_ms = wait;
+    }
+
+    return result;
+}
@@ -0,0 +1,73 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+#define RATE_LIMITER_MAX_CLIENTS         (8U)    /* Clients tracked at once, the least recent is recycled */
+
+typedef uint8_t rate_limiter_result_t;
+#define RATE_LIMITER_ALLOWED             ((rate_limiter_result_t)0U)
+#define RATE_LIMITER_LIMITED_CLIENT      ((rate_limiter_result_t)1U)    /* Bucket of the client is empty */
+#define RATE_LIMITER_LIMITED_GLOBAL      ((rate_limiter_result_t)2U)    /* Bucket shared by all clients is empty */
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+/* Token bucket: up to burst requests at once, then one every period_ms */
+typedef struct {
+    uint32_t burst;             /* Capacity, in tokens */
+    uint32_t period_ms;         /* Refill time of one token */
+} rate_limiter_rate_t;
+
+typedef struct {
+    uint32_t tokens;            /* Whole tokens available */
+    uint32_t refilled_ms;       /* Time the last token was credited */
+} rate_limiter_bucket_t;
+
+typedef struct {
+    uint32_t key;               /* Client identifier, e.g. its IPv4 address */
+    uint32_t seen_ms;           /* Last request, for recycling */
+    bool used;
+    rate_limiter_bucket_t bucket;
+} rate_limiter_client_t;
+
+/**
+ * Per-client and global token buckets.
+ *
+ * A request takes one token from the bucket of its client and one from
+ * the global bucket, or none if either is empty. Times are in ms from
+ * any monotonic clock and may wrap; a bucket left partly empty for more
+ * than 2^32 ms may then refill late, a full one is not affected.
+ * Not thread-safe, no heap is used.
+ */
+typedef struct {
+    rate_limiter_rate_t client_rate;
+    rate_limiter_rate_t global_rate;
+    rate_limiter_bucket_t global;
+    rate_limiter_client_t clients[RATE_LIMITER_MAX_CLIENTS];
+} rate_limiter_t;
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+
+/******************************************************************
+ * 6. Functions definitions (public API in .c)
+******************************************************************/
+void rate_limiter_init(rate_limiter_t *limiter, const rate_limiter_rate_t *client_rate,
+                       const rate_limiter_rate_t *global_rate, uint32_t now_ms);
+rate_limiter_result_t rate_limiter_take(rate_limiter_t *limiter, uint32_t key, uint32_t now_ms, uint32_t *retry_ms);
+
+#endif // RATE_LIMITER_H
@@ -1,6 +1,7 @@
 /******************************************************************
  * 1. Included files (microcontroller ones then user defined ones)
 ******************************************************************/
+#include <stdbool.h>
 #include <stdint.h>
 #include "rotary_encoder.h"
 
@@ -15,6 +16,14 @@
 /******************************************************************
  * 4. Variable definitions (static then global)
 ******************************************************************/
+/* Transition table : lastCode -> currentCode
+  +1 = clockwise, -1 = counterclockwise, 0 = no movement */
+static const ROTARY_ENCODER_DRAM_ATTR int8_t transition_table[4][4] = {
+    {  0, +1, -1,  0 },
+    { -1,  0,  0, +1 },
+    { +1,  0,  0, -1 },
+    {  0, -1, +1,  0 }
+};
 
 /******************************************************************
  * 5. Functions prototypes (static only)
@@ -32,15 +41,6 @@ rotary_encoder_event_t process_rotary_encoder(uint8_t lastA, uint8_t lastB, uint
 {
     int8_t lastCode = 0;
     int8_t currentCode = 0;
-    /* Transition table : lastCode -> currentCode 
-      +1 = clockwise, -1 = counterclockwise, 0 = no movement */
-    static const int8_t transition_table[4][4] = {
-        {  0, +1, -1,  0 },
-        { -1,  0,  0, +1 },
-        { +1,  0,  0, -1 },
-        {  0, -1, +1,  0 }
-    };
-    
     rotary_encoder_event_t ret = ROTARY_ENCODER_EVENT_NONE;
 
     /* Encode states into 0..3 */
@@ -68,4 +68,96 @@ rotary_encoder_event_t process_rotary_encoder(uint8_t lastA, uint8_t lastB, uint
     }
 
     return ret;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Reset a quadrature decoder
+ * @param decoder Decoder state
+ * @param levels Current A/B levels, bit 1 = A, bit 0 = B
+ */
+void rotary_encoder_decoder_init(rotary_encoder_decoder_t *decoder, uint8_t levels)
+{
+    decoder->levels = (uint8_t)(levels & 3U);
+    decoder->edges = 0;
+}
+
+/**
+ * @brief Feed new A/B levels to a quadrature decoder
+ *
+ * Safe to call from an ISR. Invalid transitions (both channels changed)
+ * are ignored, and reversing direction mid-detent cancels its edges.
+ *
+ * @param decoder Decoder state
+ * @param levels Current A/B levels, bit 1 = A, bit 0 = B
+ * @return +1 or -1 when a full detent completes, 0 otherwise
+ */
+int8_t ROTARY_ENCODER_IRAM_ATTR rotary_encoder_decode(rotary_encoder_decoder_t *decoder, uint8_t levels)
+{
+    int8_t detent = 0;
+
+    levels &= 3U;
+    decoder->edges += transition_table[decoder->levels][levels];
+    decoder->levels = levels;
+
+    if (decoder->edges >= ROTARY_ENCODER_EDGES_PER_DETENT) {
+        decoder->edges = 0;
+        detent = 1;
+    }
+    else if (decoder->edges <= -ROTARY_ENCODER_EDGES_PER_DETENT) {
+        decoder->edges = 0;
+        detent = -1;
+    }
+    else {
+        /* Between detents */
+    }
+
+    return detent;
+}
+
+/**
+ * @brief Reset a rotation speed tracker
+ * @param accel Tracker state
+ * @param curve Acceleration curve, sorted by increasing interval, must outlive the tracker
+ * @param points Number of curve points
+ */
+void rotary_encoder_accel_init(rotary_encoder_accel_t *accel, const rotary_encoder_accel_point_t *curve, uint8_t points)
+{
+    accel->curve = curve;
+    accel->points = points;
+    accel->last_direction = 0;
+    accel->last_detent_us = 0;
+}
+
+/**
+ * @brief Scale a detent by the rotation speed
+ *
+ * Safe to call from an ISR. The speed is taken from the interval since the
+ * previous detent, the first point of the curve it falls under gives the
+ * multiplier. Turning back always restarts at one step.
+ *
+ * @param accel Tracker state
+ * @param direction Detent direction, +1 or -1
+ * @param now_us Timestamp of the detent
+ * @return Number of steps the detent is worth, at least 1
+ */
+uint8_t ROTARY_ENCODER_IRAM_ATTR rotary_encoder_accel_steps(rotary_encoder_accel_t *accel, int8_t direction, int64_t now_us)
+{
+    uint8_t steps = 1U;
+
+    if (direction == accel->last_direction) {
+        int64_t interval_us = now_us - accel->last_detent_us;
+        bool found = false;
+
+        for (uint8_t i = 0U; (i < accel->points) && (found == false); i++) {
+            if (interval_us < (int64_t)accel->curve[i].interval_us) {
+                steps = accel->curve[i].multiplier;
+                found = true;
+            }
+        }
+    }
+
+    accel->last_direction = direction;
+    accel->last_detent_us = now_us;
+
+    return (steps > 0U) ? steps : 1U;
+}
@@ -4,6 +4,7 @@
 /******************************************************************
  * 1. Included files (microcontroller ones then user defined ones)
 ******************************************************************/
+#include <stdint.h>
 
 /******************************************************************
  * 2. Define declarations (macros then function macros)
@@ -13,9 +14,40 @@ typedef uint8_t rotary_encoder_event_t;
 #define ROTARY_ENCODER_EVENT_DECREMENT   ((rotary_encoder_event_t)1U)
 #define ROTARY_ENCODER_EVENT_NONE        ((rotary_encoder_event_t)2U)
 
+#define ROTARY_ENCODER_EDGES_PER_DETENT  (4)    /* Quadrature edges between two detents */
+
+/* The decoder runs in the GPIO ISR, keep it in IRAM on target */
+#ifdef ESP_PLATFORM
+#include "esp_attr.h"
+#define ROTARY_ENCODER_IRAM_ATTR         IRAM_ATTR
+#define ROTARY_ENCODER_DRAM_ATTR         DRAM_ATTR
+#else
+#define ROTARY_ENCODER_IRAM_ATTR
+#define ROTARY_ENCODER_DRAM_ATTR
+#endif
+
 /******************************************************************
  * 3. Typedef definitions (simple typedef, then enum and structs)
 ******************************************************************/
+/* Quadrature decoder state, levels are bit 1 = A, bit 0 = B */
+typedef struct {
+    uint8_t levels;     /* Last A/B levels */
+    int8_t edges;       /* Edges since the last detent, signed by direction */
+} rotary_encoder_decoder_t;
+
+/* Acceleration curve point: detents closer than interval_us count multiplier times */
+typedef struct {
+    uint32_t interval_us;
+    uint8_t multiplier;
+} rotary_encoder_accel_point_t;
+
+/* Rotation speed tracker, curve points sorted by increasing interval */
+typedef struct {
+    const rotary_encoder_accel_point_t *curve;
+    uint8_t points;
+    int8_t last_direction;      /* Direction of the last detent, 0 before the first one */
+    int64_t last_detent_us;     /* Timestamp of the last detent */
+} rotary_encoder_accel_t;
 
 /******************************************************************
  * 4. Variable definitions (static then global)
@@ -29,5 +61,9 @@ typedef uint8_t rotary_encoder_event_t;
  * 6. Functions definitions
 ******************************************************************/
 rotary_encoder_event_t process_rotary_encoder(uint8_t lastA, uint8_t lastB, uint8_t currentA, uint8_t currentB);
+void rotary_encoder_decoder_init(rotary_encoder_decoder_t *decoder, uint8_t levels);
+int8_t rotary_encoder_decode(rotary_encoder_decoder_t *decoder, uint8_t levels);
+void rotary_encoder_accel_init(rotary_encoder_accel_t *accel, const rotary_encoder_accel_point_t *curve, uint8_t points);
+uint8_t rotary_encoder_accel_steps(rotary_encoder_accel_t *accel, int8_t direction, int64_t now_us);
 
 #endif // ROTARY_ENCODER_H
\ No newline at end of file
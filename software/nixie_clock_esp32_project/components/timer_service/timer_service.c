@@ -0,0 +1,286 @@
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#ifdef STATIC_ANALYSIS
+#include "../test/common/esp_stub.h"
+#endif
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "timer_service.h"
+#include "../event_bus/event_payloads.h"
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+#define TIMER_SERVICE_TICK_US       ((uint64_t)TIMER_SERVICE_TICK_MS * 1000U)
+
+_Static_assert(EVT_COUNT <= 32U, "counted events are flagged in a 32-bit mask");
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+static const char TIMER_SERVICE_TAG[] = "TIMER_SERVICE";
+static timer_wheel_t s_wheel;
+static esp_timer_handle_t s_tick_timer = NULL;
+/* Time of wheel tick s_wheel.now, under s_wheel_lock */
+static int64_t s_last_tick_us = 0;
+static portMUX_TYPE s_wheel_lock = portMUX_INITIALIZER_UNLOCKED;
+/* Serializes re-arming of s_tick_timer, esp_timer calls cannot run under s_wheel_lock */
+static SemaphoreHandle_t s_arm_mutex = NULL;
+static StaticSemaphore_t s_arm_mutex_buffer;
+/* Events started with timer_service_start_counted(), under s_wheel_lock */
+static uint32_t s_counted_mask = 0U;
+/* Expiries of counted events not published yet, only touched by the tick */
+static uint32_t s_unsent[EVT_COUNT];
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+static void timer_service_tick(void *arg);
+static void timer_service_arm(void);
+static void timer_service_publish_counted(event_bus_event_t evt);
+static uint32_t timer_service_ms_to_ticks(uint32_t ms);
+static timer_wheel_id_t timer_service_schedule(event_bus_event_t type, uint32_t delay_ms, uint32_t period_ms, bool counted);
+
+/******************************************************************
+ * 6. Functions definitions
+******************************************************************/
+
+/**
+ * @brief Convert milliseconds to wheel ticks, rounding up.
+ */
+static uint32_t timer_service_ms_to_ticks(uint32_t ms)
+{
+    return (ms + TIMER_SERVICE_TICK_MS - 1U) / TIMER_SERVICE_TICK_MS;
+}
+
+/**
+ * @brief Publish the pending expiries of a counted event.
+ *
+ * The count travels in an evt_timer_tick_t payload, so the bus never
+ * coalesces the event. If the payload pool is empty the expiries are kept
+ * and published with the next ones.
+ */
+static void timer_service_publish_counted(event_bus_event_t evt)
+{
+    evt_timer_tick_t tick;
+
+    tick.ticks = (s_unsent[evt] > (uint32_t)UINT16_MAX) ? UINT16_MAX : (uint16_t)s_unsent[evt];
+    event_bus_buffer_t buf = evt_timer_tick_pack(&tick);
+    if (buf != EVENT_BUS_BUFFER_NONE) {
+        s_unsent[evt] -= (uint32_t)tick.ticks;
+        event_bus_publish(evt, buf);
+    }
+    else {
+        ESP_LOGW(TIMER_SERVICE_TAG, "No buffer for event %u, %lu expiries delayed",
+                 (unsigned)evt, (unsigned long)s_unsent[evt]);
+    }
+}
+
+/**
+ * @brief Arm the one-shot esp_timer for the nearest wheel expiry.
+ *
+ * Stops it when no timer is running, so an idle wheel never wakes the
+ * CPU. Called after each advance and whenever a timer is started.
+ */
+static void timer_service_arm(void)
+{
+    uint32_t next_ticks = 0U;
+    bool running = false;
+    int64_t due_us = 0;
+
+    if ((s_tick_timer != NULL) && (xSemaphoreTake(s_arm_mutex, portMAX_DELAY) == pdTRUE)) {
+        portENTER_CRITICAL(&s_wheel_lock);
+        running = timer_wheel_next_expiry(&s_wheel, &next_ticks);
+        due_us = s_last_tick_us + ((int64_t)next_ticks * (int64_t)TIMER_SERVICE_TICK_US);
+        portEXIT_CRITICAL(&s_wheel_lock);
+
+        (void)esp_timer_stop(s_tick_timer);
+        if (running == true) {
+            int64_t delay_us = due_us - esp_timer_get_time();
+            if (delay_us < 1) {
+                delay_us = 1;
+            }
+            if (esp_timer_start_once(s_tick_timer, (uint64_t)delay_us) != ESP_OK) {
+                ESP_LOGE(TIMER_SERVICE_TAG, "Failed to arm tick timer");
+            }
+        }
+        (void)xSemaphoreGive(s_arm_mutex);
+    }
+}
+
+/**
+ * @brief esp_timer callback, advances the wheel by the elapsed ticks.
+ *
+ * Runs once per nearest expiry, not every tick. Expiries are counted per
+ * event and published after the wheel lock is released. Plain events carry no payload, so the bus coalesces them and
+ * a slow consumer cannot make the time lane overflow. Counted events
+ * carry the number of expiries, so a late callback or a late dispatcher
+ * never loses one.
+ */
+static void timer_service_tick(void *arg)
+{
+    uint32_t counts[EVT_COUNT] = { 0U };
+    timer_wheel_counter_t counter = { counts, EVT_COUNT };
+    uint32_t counted = 0U;
+    int64_t now_us = esp_timer_get_time();
+    (void)arg;
+
+    portENTER_CRITICAL(&s_wheel_lock);
+    /* Every tick elapsed since the last advance, late callbacks included */
+    uint32_t ticks = (uint32_t)((now_us - s_last_tick_us) / (int64_t)TIMER_SERVICE_TICK_US);
+    s_last_tick_us += (int64_t)ticks * (int64_t)TIMER_SERVICE_TICK_US;
+    (void)timer_wheel_advance(&s_wheel, ticks, timer_wheel_count_expiry, &counter);
+    counted = s_counted_mask;
+    portEXIT_CRITICAL(&s_wheel_lock);
+
+    for (event_bus_event_t evt = 0U; evt < EVT_COUNT; evt++) {
+        if ((counted & (1UL << evt)) != 0U) {
+            s_unsent[evt] += counts[evt];
+            if (s_unsent[evt] > 0U) {
+                timer_service_publish_counted(evt);
+            }
+        }
+        else if (counts[evt] > 0U) {
+            event_bus_publish(evt, EVENT_BUS_BUFFER_NONE);
+        }
+        else {
+            /* Not expired */
+        }
+    }
+
+    timer_service_arm();
+}
+
+/**
+ * @brief Start the timer service.
+ *
+ * All timers share one one-shot esp_timer, armed for the nearest expiry
+ * with a TIMER_SERVICE_TICK_MS resolution and stopped while no timer
+ * runs. Subsequent calls have no effect.
+ *
+ * @return ESP_OK on success, or the esp_timer error.
+ */
+esp_err_t timer_service_init(void)
+{
+    esp_err_t ret = ESP_OK;
+
+    if (s_tick_timer == NULL) {
+        const esp_timer_create_args_t args = {
+            .callback = timer_service_tick,
+            .arg = NULL,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "timer_service",
+        };
+
+        timer_wheel_init(&s_wheel);
+        s_last_tick_us = esp_timer_get_time();
+        s_arm_mutex = xSemaphoreCreateMutexStatic(&s_arm_mutex_buffer);
+        ret = esp_timer_create(&args, &s_tick_timer);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TIMER_SERVICE_TAG, "Failed to start tick timer: %s", esp_err_to_name(ret));
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Allocate and start a wheel timer publishing an event.
+ *
+ * The wheel is only advanced when the esp_timer fires, so it may lag
+ * behind the current time. The delay is extended by that lag so the
+ * first expiry is counted from now. An empty wheel is simply resynced.
+ */
+static timer_wheel_id_t timer_service_schedule(event_bus_event_t type, uint32_t delay_ms, uint32_t period_ms, bool counted)
+{
+    timer_wheel_id_t id = TIMER_WHEEL_NONE;
+
+    if ((type != EVT_NONE) && (type < EVT_COUNT)) {
+        int64_t now_us = esp_timer_get_time();
+        uint32_t lag = 0U;
+        uint32_t next_ticks = 0U;
+
+        portENTER_CRITICAL(&s_wheel_lock);
+        if (timer_wheel_next_expiry(&s_wheel, &next_ticks) == false) {
+            s_last_tick_us = now_us;
+        }
+        else {
+            lag = (uint32_t)((now_us - s_last_tick_us) / (int64_t)TIMER_SERVICE_TICK_US);
+        }
+        id = timer_wheel_alloc(&s_wheel, (uint32_t)type);
+        if ((id != TIMER_WHEEL_NONE) &&
+            (timer_wheel_start(&s_wheel, id, timer_service_ms_to_ticks(delay_ms) + lag,
+                               timer_service_ms_to_ticks(period_ms)) == false)) {
+            timer_wheel_free(&s_wheel, id);
+            id = TIMER_WHEEL_NONE;
+        }
+        if ((id != TIMER_WHEEL_NONE) && (counted == true)) {
+            s_counted_mask |= (1UL << type);
+        }
+        portEXIT_CRITICAL(&s_wheel_lock);
+    }
+
+    if (id == TIMER_WHEEL_NONE) {
+        ESP_LOGE(TIMER_SERVICE_TAG, "Failed to schedule event %u", (unsigned)type);
+    }
+    else {
+        timer_service_arm();
+    }
+
+    return id;
+}
+
+/**
+ * @brief Schedule an event.
+ *
+ * Expiries not dispatched yet are merged into one event, use
+ * timer_service_start_counted() when each one matters.
+ *
+ * @param type Payload-less event published on expiry.
+ * @param delay_ms Delay before the first publication.
+ * @param period_ms Period of later publications, 0 for a one-shot event.
+ *
+ * @return Timer id for timer_service_stop(), TIMER_WHEEL_NONE on error.
+ */
+timer_wheel_id_t timer_service_start(event_bus_event_t type, uint32_t delay_ms, uint32_t period_ms)
+{
+    return timer_service_schedule(type, delay_ms, period_ms, false);
+}
+
+/**
+ * @brief Schedule an event whose every expiry is delivered.
+ *
+ * The event carries an evt_timer_tick_t payload holding the number of
+ * expiries since the previous one, at least 1. Subscribers must apply
+ * all of them, e.g. advance the clock by that many seconds.
+ *
+ * @param type Event published on expiry.
+ * @param delay_ms Delay before the first publication.
+ * @param period_ms Period of later publications, 0 for a one-shot event.
+ *
+ * @return Timer id for timer_service_stop(), TIMER_WHEEL_NONE on error.
+ */
+timer_wheel_id_t timer_service_start_counted(event_bus_event_t type, uint32_t delay_ms, uint32_t period_ms)
+{
+    return timer_service_schedule(type, delay_ms, period_ms, true);
+}
+
+/**
+ * @brief Cancel and release a scheduled event.
+ *
+ * The esp_timer is left armed, a wakeup with nothing due re-arms it for
+ * the next expiry or stops it.
+ */
+void timer_service_stop(timer_wheel_id_t id)
+{
+    portENTER_CRITICAL(&s_wheel_lock);
+    timer_wheel_free(&s_wheel, id);
+    portEXIT_CRITICAL(&s_wheel_lock);
+}
@@ -0,0 +1,36 @@
+#ifndef TIMER_SERVICE_H
+#define TIMER_SERVICE_H
+
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#include "esp_err.h"
+#include "timer_wheel.h"
+#include "../event_bus/event_bus.h"
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+#define TIMER_SERVICE_TICK_MS       (10U)   /* Timer resolution */
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+
+/******************************************************************
+ * 6. Functions definitions (public API in .c)
+******************************************************************/
+esp_err_t timer_service_init(void);
+timer_wheel_id_t timer_service_start(event_bus_event_t type, uint32_t delay_ms, uint32_t period_ms);
+timer_wheel_id_t timer_service_start_counted(event_bus_event_t type, uint32_t delay_ms, uint32_t period_ms);
+void timer_service_stop(timer_wheel_id_t id);
+
+#endif // TIMER_SERVICE_H
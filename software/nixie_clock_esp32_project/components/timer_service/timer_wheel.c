@@ -0,0 +1,288 @@
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#include <stddef.h>
+#include "timer_wheel.h"
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+#define TIMER_WHEEL_SLOT_MASK       (TIMER_WHEEL_SLOTS - 1U)
+
+_Static_assert((TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS) < TIMER_WHEEL_NONE, "slot numbers must fit below TIMER_WHEEL_NONE");
+_Static_assert(TIMER_WHEEL_MAX_TIMERS < TIMER_WHEEL_NONE, "timer ids must fit below TIMER_WHEEL_NONE");
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+static void timer_wheel_link(timer_wheel_t *wheel, timer_wheel_id_t id);
+static void timer_wheel_unlink(timer_wheel_t *wheel, timer_wheel_id_t id);
+static void timer_wheel_cascade(timer_wheel_t *wheel, uint8_t level);
+
+/******************************************************************
+ * 6. Functions definitions
+******************************************************************/
+
+/**
+ * @brief Insert a timer in the slot matching its expiry.
+ *
+ * Level n holds timers expiring less than 64^(n+1) ticks from now, in the
+ * slot given by bits [6n, 6n+6) of their expiry tick. Constant time.
+ */
+static void timer_wheel_link(timer_wheel_t *wheel, timer_wheel_id_t id)
+{
+    timer_wheel_timer_t *timer = &wheel->timers[id];
+    uint32_t delta = timer->expires - wheel->now;
+    uint8_t level = 0U;
+
+    while ((level < (TIMER_WHEEL_LEVELS - 1U)) && (delta >= (1UL << (TIMER_WHEEL_SLOT_BITS * (level + 1U))))) {
+        level++;
+    }
+
+    uint8_t slot = (uint8_t)((level * TIMER_WHEEL_SLOTS) +
+                             ((timer->expires >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK));
+    timer->slot = slot;
+    timer->prev = TIMER_WHEEL_NONE;
+    timer->next = wheel->heads[slot];
+    if (timer->next != TIMER_WHEEL_NONE) {
+        wheel->timers[timer->next].prev = id;
+    }
+    wheel->heads[slot] = id;
+}
+
+/**
+ * @brief Remove a timer from its slot list. Constant time.
+ */
+static void timer_wheel_unlink(timer_wheel_t *wheel, timer_wheel_id_t id)
+{
+    timer_wheel_timer_t *timer = &wheel->timers[id];
+
+    if (timer->slot != TIMER_WHEEL_NONE) {
+        if (timer->prev != TIMER_WHEEL_NONE) {
+            wheel->timers[timer->prev].next = timer->next;
+        }
+        else {
+            wheel->heads[timer->slot] = timer->next;
+        }
+        if (timer->next != TIMER_WHEEL_NONE) {
+            wheel->timers[timer->next].prev = timer->prev;
+        }
+        timer->slot = TIMER_WHEEL_NONE;
+        timer->next = TIMER_WHEEL_NONE;
+        timer->prev = TIMER_WHEEL_NONE;
+    }
+}
+
+/**
+ * @brief Move the timers of the current slot of a level to lower levels.
+ */
+static void timer_wheel_cascade(timer_wheel_t *wheel, uint8_t level)
+{
+    uint8_t slot = (uint8_t)((level * TIMER_WHEEL_SLOTS) +
+                             ((wheel->now >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK));
+
+    while (wheel->heads[slot] != TIMER_WHEEL_NONE) {
+        timer_wheel_id_t id = wheel->heads[slot];
+        timer_wheel_unlink(wheel, id);
+        timer_wheel_link(wheel, id);
+    }
+}
+
+/**
+ * @brief Initialize an empty wheel at tick 0.
+ */
+void timer_wheel_init(timer_wheel_t *wheel)
+{
+    wheel->now = 0U;
+    for (uint16_t i = 0U; i < (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS); i++) {
+        wheel->heads[i] = TIMER_WHEEL_NONE;
+    }
+    for (uint8_t i = 0U; i < TIMER_WHEEL_MAX_TIMERS; i++) {
+        wheel->timers[i].slot = TIMER_WHEEL_NONE;
+        wheel->timers[i].next = TIMER_WHEEL_NONE;
+        wheel->timers[i].prev = TIMER_WHEEL_NONE;
+        wheel->timers[i].allocated = false;
+    }
+}
+
+/**
+ * @brief Reserve a stopped timer.
+ *
+ * @param user Value handed to the expiry callback.
+ *
+ * @return Timer id, TIMER_WHEEL_NONE if all timers are in use.
+ */
+timer_wheel_id_t timer_wheel_alloc(timer_wheel_t *wheel, uint32_t user)
+{
+    timer_wheel_id_t id = TIMER_WHEEL_NONE;
+
+    for (uint8_t i = 0U; i < TIMER_WHEEL_MAX_TIMERS; i++) {
+        if (wheel->timers[i].allocated == false) {
+            wheel->timers[i].allocated = true;
+            wheel->timers[i].user = user;
+            wheel->timers[i].period = 0U;
+            id = i;
+            break;
+        }
+    }
+
+    return id;
+}
+
+/**
+ * @brief Stop and release a timer.
+ */
+void timer_wheel_free(timer_wheel_t *wheel, timer_wheel_id_t id)
+{
+    if (id < TIMER_WHEEL_MAX_TIMERS) {
+        timer_wheel_unlink(wheel, id);
+        wheel->timers[id].allocated = false;
+    }
+}
+
+/**
+ * @brief (Re)start a timer.
+ *
+ * @param delay Ticks until the first expiry, 0 is rounded up to 1.
+ * @param period Ticks between later expiries, 0 for a one-shot timer.
+ *
+ * @return false if the timer is not allocated or a duration exceeds
+ *         TIMER_WHEEL_MAX_DELAY.
+ */
+bool timer_wheel_start(timer_wheel_t *wheel, timer_wheel_id_t id, uint32_t delay, uint32_t period)
+{
+    bool ret = false;
+
+    if ((id < TIMER_WHEEL_MAX_TIMERS) && (wheel->timers[id].allocated == true) &&
+        (delay <= TIMER_WHEEL_MAX_DELAY) && (period <= TIMER_WHEEL_MAX_DELAY)) {
+        timer_wheel_unlink(wheel, id);
+        wheel->timers[id].expires = wheel->now + ((delay == 0U) ? 1U : delay);
+        wheel->timers[id].period = period;
+        timer_wheel_link(wheel, id);
+        ret = true;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Stop a timer, it stays allocated.
+ */
+void timer_wheel_stop(timer_wheel_t *wheel, timer_wheel_id_t id)
+{
+    if (id < TIMER_WHEEL_MAX_TIMERS) {
+        timer_wheel_unlink(wheel, id);
+    }
+}
+
+/**
+ * @brief Tell whether a timer is running.
+ */
+bool timer_wheel_is_active(const timer_wheel_t *wheel, timer_wheel_id_t id)
+{
+    return (id < TIMER_WHEEL_MAX_TIMERS) && (wheel->timers[id].slot != TIMER_WHEEL_NONE);
+}
+
+/**
+ * @brief Get the ticks until the nearest expiry.
+ *
+ * Scans the TIMER_WHEEL_MAX_TIMERS timers, so callers can sleep until
+ * then instead of advancing the wheel one tick at a time.
+ *
+ * @param[out] ticks Ticks from now to the nearest expiry, at least 1.
+ *
+ * @return false if no timer is running, ticks is then left untouched.
+ */
+bool timer_wheel_next_expiry(const timer_wheel_t *wheel, uint32_t *ticks)
+{
+    bool running = false;
+    uint32_t nearest = TIMER_WHEEL_MAX_DELAY;
+
+    for (uint8_t i = 0U; i < TIMER_WHEEL_MAX_TIMERS; i++) {
+        if (wheel->timers[i].slot != TIMER_WHEEL_NONE) {
+            uint32_t delta = wheel->timers[i].expires - wheel->now;
+            running = true;
+            if (delta < nearest) {
+                nearest = delta;
+            }
+        }
+    }
+
+    if (running == true) {
+        *ticks = (nearest == 0U) ? 1U : nearest;
+    }
+
+    return running;
+}
+
+/**
+ * @brief Advance the wheel and fire expired timers.
+ *
+ * Periodic timers are re-armed from their expiry tick, so they do not
+ * drift when the wheel is advanced late.
+ *
+ * @param ticks Number of ticks elapsed.
+ * @param cb Expiry callback, called in expiry order.
+ * @param ctx Opaque pointer handed to cb.
+ *
+ * @return Number of expiries.
+ */
+uint32_t timer_wheel_advance(timer_wheel_t *wheel, uint32_t ticks, timer_wheel_expiry_cb_t cb, void *ctx)
+{
+    uint32_t expired = 0U;
+
+    for (uint32_t t = 0U; t < ticks; t++) {
+        wheel->now++;
+
+        /* Entering a new slot of an upper level: spread its timers below, highest level first */
+        for (uint8_t level = TIMER_WHEEL_LEVELS - 1U; level > 0U; level--) {
+            if ((wheel->now & ((1UL << (TIMER_WHEEL_SLOT_BITS * level)) - 1UL)) == 0U) {
+                timer_wheel_cascade(wheel, level);
+            }
+        }
+
+        /* Pop one timer at a time so the callback may start or stop any timer */
+        uint8_t slot = (uint8_t)(wheel->now & TIMER_WHEEL_SLOT_MASK);
+        while (wheel->heads[slot] != TIMER_WHEEL_NONE) {
+            timer_wheel_id_t id = wheel->heads[slot];
+            timer_wheel_timer_t *timer = &wheel->timers[id];
+
+            timer_wheel_unlink(wheel, id);
+            if (timer->period != 0U) {
+                timer->expires += timer->period;
+                timer_wheel_link(wheel, id);
+            }
+            expired++;
+            if (cb != NULL) {
+                cb(ctx, id, timer->user);
+            }
+        }
+    }
+
+    return expired;
+}
+
+/**
+ * @brief Expiry callback counting every expiry of each user value.
+ *
+ * Hand it to timer_wheel_advance() with a timer_wheel_counter_t as ctx.
+ * A periodic timer expiring several times in one advance is counted
+ * each time. User values past the counter array are ignored.
+ */
+void timer_wheel_count_expiry(void *ctx, timer_wheel_id_t id, uint32_t user)
+{
+    timer_wheel_counter_t *counter = (timer_wheel_counter_t *)ctx;
+    (void)id;
+
+    if ((counter != NULL) && (user < counter->size)) {
+        counter->counts[user]++;
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+#define TIMER_WHEEL_SLOT_BITS       (6U)
+#define TIMER_WHEEL_SLOTS           (1U << TIMER_WHEEL_SLOT_BITS)   /* Slots per level */
+#define TIMER_WHEEL_LEVELS          (3U)
+#define TIMER_WHEEL_MAX_TIMERS      (16U)
+/* Longest delay or period, in ticks: 64^3 - 1 */
+#define TIMER_WHEEL_MAX_DELAY       ((1UL << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS)) - 1UL)
+
+typedef uint8_t timer_wheel_id_t;
+#define TIMER_WHEEL_NONE            ((timer_wheel_id_t)0xFFU)
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+typedef struct {
+    uint32_t expires;           /* Absolute expiry tick */
+    uint32_t period;            /* Reload in ticks, 0 for one-shot */
+    uint32_t user;              /* Opaque value handed to the expiry callback */
+    timer_wheel_id_t next;      /* Slot list links */
+    timer_wheel_id_t prev;
+    uint8_t slot;               /* level * TIMER_WHEEL_SLOTS + index, TIMER_WHEEL_NONE if stopped */
+    bool allocated;
+} timer_wheel_timer_t;
+
+typedef struct {
+    uint32_t now;                                               /* Current tick */
+    timer_wheel_id_t heads[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS]; /* Slot list heads */
+    timer_wheel_timer_t timers[TIMER_WHEEL_MAX_TIMERS];
+} timer_wheel_t;
+
+/* Called for each expired timer, may start or stop any timer */
+typedef void (*timer_wheel_expiry_cb_t)(void *ctx, timer_wheel_id_t id, uint32_t user);
+
+/* Context of timer_wheel_count_expiry(): one counter per user value */
+typedef struct {
+    uint32_t *counts;
+    uint32_t size;
+} timer_wheel_counter_t;
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+
+/******************************************************************
+ * 6. Functions definitions (public API in .c)
+******************************************************************/
+void timer_wheel_init(timer_wheel_t *wheel);
+timer_wheel_id_t timer_wheel_alloc(timer_wheel_t *wheel, uint32_t user);
+void timer_wheel_free(timer_wheel_t *wheel, timer_wheel_id_t id);
+bool timer_wheel_start(timer_wheel_t *wheel, timer_wheel_id_t id, uint32_t delay, uint32_t period);
+void timer_wheel_stop(timer_wheel_t *wheel, timer_wheel_id_t id);
+bool timer_wheel_is_active(const timer_wheel_t *wheel, timer_wheel_id_t id);
+bool timer_wheel_next_expiry(const timer_wheel_t *wheel, uint32_t *ticks);
+uint32_t timer_wheel_advance(timer_wheel_t *wheel, uint32_t ticks, timer_wheel_expiry_cb_t cb, void *ctx);
+void timer_wheel_count_expiry(void *ctx, timer_wheel_id_t id, uint32_t user);
+
+#endif // TIMER_WHEEL_H
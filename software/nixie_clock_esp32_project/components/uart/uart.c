@@ -26,6 +26,7 @@
  * 4. Variable definitions (static then global)
 ******************************************************************/
 static SemaphoreHandle_t uart_mutex = NULL;
+static StaticSemaphore_t uart_mutex_buffer;
 static const char UART_TAG[] = "UART";
 
 /******************************************************************
@@ -62,7 +63,7 @@ void uart_init(void)
     };
 
     if (uart_mutex == NULL) {
-        uart_mutex = xSemaphoreCreateMutex();
+        uart_mutex = xSemaphoreCreateMutexStatic(&uart_mutex_buffer);
     }
 
     /* Configure UART */
@@ -4,309 +4,532 @@
 #ifdef STATIC_ANALYSIS
 #include "../test/common/esp_stub.h"
 #endif
-#include <errno.h>
+#include <inttypes.h>
 #include <string.h>
+#include <unistd.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_log.h"
 #include "esp_netif.h"
+#include "esp_system.h"
+#include "esp_timer.h"
 #include "webserver.h"
+#include "webserver_api.h"
+#include "webserver_events.h"
+#include "webserver_write.h"
 #include "config.h"
+#include "config_schema.h"
 #include "wifi.h"
 #include "../event_bus/event_bus.h"
+#include "../form_parser/form_parser.h"
 #include "../clock_task/clock_task.h"
+#include "../mem_budget/mem_budget.h"
+#include "../metrics/metrics.h"
 
 /******************************************************************
  * 2. Define declarations (macros then function macros)
 ******************************************************************/
-#define WEBSERVER_HTML_PAGE_SIZE                 (8192U)
-#define WEBSERVER_HTTPD_REQ_RECV_BUFFER_SIZE     (512U)
-#define WEBSERVER_URLDEC_OK                      ((uint8_t)0x00)
-#define WEBSERVER_URLDEC_WARN_TRUNCATED          ((uint8_t)0x01)
-#define WEBSERVER_URLDEC_WARN_INVALID_SEQ        ((uint8_t)0x02)
-#define WEBSERVER_URLDEC_ERR_BAD_PARAM           ((uint8_t)0x80)
+#define WEBSERVER_RENDER_BUFFER_SIZE             (64U)
+#define WEBSERVER_TEMPLATE_OPEN                  "{{"
+#define WEBSERVER_TEMPLATE_CLOSE                 "}}"
+#define WEBSERVER_ETAG_SIZE                      (11U)   /* Quoted 32-bit hex hash */
+#define WEBSERVER_IF_NONE_MATCH_SIZE             (64U)
+/* Asset URLs carry their ETag as version, so they can be cached for a year */
+#define WEBSERVER_ASSET_CACHE_CONTROL            "public, max-age=31536000, immutable"
+#define WEBSERVER_MAX_URI_HANDLERS               (16U)
+#define WEBSERVER_FORM_CHUNK_SIZE                (128U)
+#define WEBSERVER_FORM_MAX_BODY_SIZE             (2048U)
+#define WEBSERVER_STATS_LINE_SIZE                (256U)
+#define WEBSERVER_METRICS_LINE_SIZE              (192U)
+#define WEBSERVER_METRICS_CONTENT_TYPE           "text/plain; version=0.0.4"
 #define WEBSERVER_TAG                            "WEBSERVER"
+/* Escaped strings grow up to 6 times ("&quot;"), the other values are short */
+#define WEBSERVER_PAGE_CACHE_SIZE                (((CONFIG_SSID_SIZE + CONFIG_WPA_PASSPHRASE_SIZE) * 6U) + 64U)
+
+/**
+ * Template variables of the page.
+ *
+ * X(id, name)
+ * - id:   WEBSERVER_PAGE_VAR_<id>
+ * - name: name between the template braces
+ *
+ * The time is formatted on every request, all other values are rendered
+ * once per configuration generation into the page cache.
+ */
+#define WEBSERVER_PAGE_VARS(X) \
+    X(NTP,             "ntp") \
+    X(HOURS,           "hours") \
+    X(MINUTES,         "minutes") \
+    X(SECONDS,         "seconds") \
+    X(SSID,            "ssid") \
+    X(WPA_PASSPHRASE,  "wpa_passphrase") \
+    X(MODE0,           "mode0") \
+    X(MODE1,           "mode1") \
+    X(MODE2,           "mode2") \
+    X(DUTYCYCLE,       "dutycycle") \
+    X(STYLE_CSS_ETAG,  "style_css_etag") \
+    X(APP_JS_ETAG,     "app_js_etag")
+
+#define WEBSERVER_PAGE_VAR_ENUM(id, name)        WEBSERVER_PAGE_VAR_##id,
+#define WEBSERVER_PAGE_VAR_NAME(id, name)        (name),
+
+typedef uint8_t webserver_asset_id_t;
+#define WEBSERVER_ASSET_STYLE_CSS                ((webserver_asset_id_t)0U)
+#define WEBSERVER_ASSET_APP_JS                   ((webserver_asset_id_t)1U)
+#define WEBSERVER_ASSET_COUNT                    (2U)
+
+_Static_assert(CONFIG_FIELD_COUNT <= 32U, "submitted fields are tracked in a 32-bit mask");
 
 /******************************************************************
  * 3. Typedef definitions (simple typedef, then enum and structs)
 ******************************************************************/
+/* Static asset, gzipped at build time and embedded in flash */
+typedef struct {
+    const char *uri;
+    const char *type;
+    const uint8_t *start;
+    const uint8_t *end;
+    char etag[WEBSERVER_ETAG_SIZE];     /* Computed by start_webserver() */
+} webserver_asset_t;
+
+/* "/update" form being applied */
+typedef struct {
+    config_t config;
+    uint32_t submitted;     /* Bit per config_field_id_t */
+} webserver_form_t;
+
+typedef enum {
+    WEBSERVER_PAGE_VARS(WEBSERVER_PAGE_VAR_ENUM)
+    WEBSERVER_PAGE_VAR_COUNT
+} webserver_page_var_t;
+
+/* Rendered configuration values, value i is text[start[i]] to text[start[i + 1]] */
+typedef struct {
+    uint32_t generation;    /* config_get_generation() of the values */
+    bool valid;
+    uint16_t start[WEBSERVER_PAGE_VAR_COUNT + 1U];
+    uint16_t len;
+    char text[WEBSERVER_PAGE_CACHE_SIZE];
+} webserver_page_cache_t;
+
+/* Streaming page renderer, dynamic values are batched in a small buffer */
+typedef struct {
+    httpd_req_t *req;
+    const webserver_page_cache_t *cache;
+    const myclock_t *clk;
+    char buf[WEBSERVER_RENDER_BUFFER_SIZE];
+    size_t len;
+    esp_err_t ret;      /* First send error, rendering stops on error */
+} webserver_render_t;
 
 /******************************************************************
  * 4. Variable definitions (static then global)
 ******************************************************************/
+extern const uint8_t style_css_gz_start[] asm("_binary_style_css_gz_start");
+extern const uint8_t style_css_gz_end[]   asm("_binary_style_css_gz_end");
+extern const uint8_t app_js_gz_start[]    asm("_binary_app_js_gz_start");
+extern const uint8_t app_js_gz_end[]      asm("_binary_app_js_gz_end");
+
+static webserver_asset_t webserver_assets[WEBSERVER_ASSET_COUNT] = {
+    { "/static/style.css", "text/css",               style_css_gz_start, style_css_gz_end, "" },
+    { "/static/app.js",    "application/javascript", app_js_gz_start,    app_js_gz_end,    "" },
+};
+
+static const char * const webserver_page_var_names[WEBSERVER_PAGE_VAR_COUNT] = {
+    WEBSERVER_PAGE_VARS(WEBSERVER_PAGE_VAR_NAME)
+};
+
+/* Only used by the httpd task, which runs one handler at a time */
+static webserver_page_cache_t webserver_page_cache = { .generation = 0U, .valid = false, .len = 0U };
+
+/* Tasks reported by /metrics, missing ones are skipped */
+static const char * const webserver_metrics_tasks[] = {
+    "main", "dispatcher_task", "dispatch_pool0", "dispatch_pool1", "dispatch_ded0", "dispatch_ded1",
+    "gpio_task", "time_sync_task", "httpd", "esp_timer", "tiT", "IDLE",
+};
+
+static const char * const webserver_metrics_lanes[EVENT_BUS_LANE_COUNT] = {
+    "input", "time", "config", "telemetry",
+};
+
+/* Label per event type, indexed by the EVT_* value */
+static const char * const webserver_metrics_events[] = {
+    [EVT_NONE]              = "none",
+    [EVT_CLOCK_NTP_CONFIG]  = "clock_ntp",
+    [EVT_CLOCK_GPIO_CONFIG] = "clock_gpio",
+    [EVT_CLOCK_WEB_CONFIG]  = "clock_web",
+    [EVT_NTP_CONFIG]        = "ntp_config",
+    [EVT_WIFI_CONFIG]       = "wifi_config",
+    [EVT_PWM_CONFIG]        = "pwm_config",
+    [EVT_TIMER_CLOCK_TICK]  = "clock_tick",
+    [EVT_TIMER_DISPLAY]     = "display",
+    [EVT_CONFIG_PERSIST]    = "config_persist",
+};
+_Static_assert((sizeof(webserver_metrics_events) / sizeof(webserver_metrics_events[0])) == EVT_COUNT,
+               "every event type needs a /metrics label");
 
 /******************************************************************
  * 5. Functions prototypes (static only)
 ******************************************************************/
 static const char* get_html_page(void);
-static uint8_t hex_to_uint8(uint8_t c);
-static uint8_t url_decode(uint8_t *dst, size_t dst_size, const uint8_t *src, size_t src_len, size_t *out_len);
-static void html_escape(char *dst, size_t dst_size, const char *src);
+static bool update_form_pair(void *ctx, const char *key, const char *value, form_parser_status_t status);
+static void asset_compute_etag(webserver_asset_t *asset);
+static esp_err_t asset_handler(httpd_req_t *req);
+static void render_flush(webserver_render_t *render);
+static void render_write(webserver_render_t *render, const char *data, size_t len);
+static void page_cache_append(webserver_page_cache_t *cache, const char *data, size_t len);
+static void page_cache_append_escaped(webserver_page_cache_t *cache, const char *src);
+static esp_err_t page_cache_refresh(webserver_page_cache_t *cache);
+static void render_var(webserver_render_t *render, const char *name, size_t name_len);
+static esp_err_t render_template(webserver_render_t *render, const char *tpl);
+static esp_err_t render_end(webserver_render_t *render);
+static void render_metric_family(webserver_render_t *render, const char *name, const char *type, const char *help);
+static void render_metric(webserver_render_t *render, const char *name, const char *label, const char *label_value, long long value);
+static void render_histogram(webserver_render_t *render, const char *name, const char *label, const char *label_value,
+                             const uint32_t *buckets, uint8_t bucket_count, uint64_t sum);
+static void webserver_close_fn(httpd_handle_t server, int sockfd);
 
 /**
  * @brief Handles the root page ("/") request.
  *
- * This handler generates the HTML page for the web interface,
- * including the current configuration values. The page is dynamically
- * populated from the config structure.
+ * This handler streams the HTML page of the web interface, including
+ * the current configuration values. Static parts of the page are sent
+ * straight from flash, the configuration values from the page cache and
+ * only the time is formatted per request.
+ *
+ * Neither the config nor the clock mutex is taken while the
+ * configuration is unchanged.
  *
  * @param req Pointer to the HTTP request structure.
  *
- * @return ESP_OK Always returns ESP_OK after sending the page.
+ * @return ESP_OK on success, ESP_FAIL if the configuration could not be
+ *         read or the client went away.
  */
 static esp_err_t root_handler(httpd_req_t *req)
 {
-    esp_err_t ret = ESP_FAIL;
-    config_t config;
-    const char *html_page_orig = get_html_page();
+    esp_err_t ret = page_cache_refresh(&webserver_page_cache);
+    myclock_t clk;
 
-    ret = config_get_copy(&config);
     if (ESP_OK == ret) {
-		char safe_ssid[CONFIG_SSID_BUF_SZ * 6U];
-		char safe_pass[CONFIG_WPA_PASSPHRASE_BUF_SZ * 6U];
-		html_escape(safe_ssid, sizeof(safe_ssid), config.ssid);
-		html_escape(safe_pass, sizeof(safe_pass), config.wpa_passphrase);
-
-        myclock_t clk;
-        bool clock_get_copy_result = clock_get_copy(&clk);
-
-        if (clock_get_copy_result == true) {
-
-            /* Populate HTML page with current configuration values */
-            char html_format[WEBSERVER_HTML_PAGE_SIZE];
-            int ret_modify_html = snprintf(html_format, sizeof(html_format), html_page_orig,
-            (config.ntp == 1U) ? "checked" : "",
-            clk.hours,
-            clk.minutes,
-            clk.seconds,
-            safe_ssid,
-            safe_pass,
-            (config.mode == 0U) ? "checked" : "",
-            (config.mode == 1U) ? "checked" : "",
-            (config.mode == 2U) ? "checked" : "",
-            config.dutycycle);
-
-            if ((ret_modify_html >= 0) && ((size_t)ret_modify_html < sizeof(html_format))) {
-                httpd_resp_send(req, html_format, HTTPD_RESP_USE_STRLEN);
-            }
-            else {
-                ret = ESP_FAIL;
-            }
+        webserver_render_t render = {
+            .req = req,
+            .cache = &webserver_page_cache,
+            .clk = &clk,
+            .len = 0U,
+            .ret = ESP_OK,
+        };
+
+        clock_get_snapshot(&clk);
+
+        /* Populate HTML page with current configuration values */
+        ret = render_template(&render, get_html_page());
+    }
+    else {
+        ESP_LOGE(WEBSERVER_TAG, "Failed to get configuration");
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Applies one pair of the "/update" form to the new configuration.
+ *
+ * Unknown keys are ignored, invalid values keep the current value.
+ */
+static bool update_form_pair(void *ctx, const char *key, const char *value, form_parser_status_t status)
+{
+    webserver_form_t *form = (webserver_form_t *)ctx;
+    const config_field_t *field = config_field_find(key);
+
+    if (field == NULL) {
+        /* Not a configuration field */
+    }
+    else {
+        form->submitted |= (1UL << (uint32_t)(field - config_fields));
+
+        if (status != FORM_PARSER_OK) {
+            ESP_LOGE(WEBSERVER_TAG, "Malformed value for %s: 0x%02X", key, status);
+        }
+        else if (config_field_set_from_str(&form->config, field, value) != ESP_OK) {
+            ESP_LOGW(WEBSERVER_TAG, "Invalid value for %s", key);
         }
         else {
-            ESP_LOGE(WEBSERVER_TAG, "Failed to get clock state");
-            ret = ESP_FAIL;
+            /* Value stored */
         }
     }
 
-    return ret;
+    return true;
 }
 
 /**
  * @brief Handles the "/update" request to update configuration.
  *
- * This handler updates configuration, then redirects the client
- * back to the root page using an HTTP 303 redirect.
+ * The form body is received in small chunks and parsed in one pass,
+ * then the configuration is updated and the client is redirected back
+ * to the root page using an HTTP 303 redirect. Writes over the rate limit
+ * are refused with 429 before the body is read.
  *
  * @param req Pointer to the HTTP request structure.
  *
- * @return ESP_OK Always returns ESP_OK after handling the request.
+ * @return ESP_OK on success, ESP_FAIL if the body could not be received
+ *         or the write was refused.
  */
 static esp_err_t update_handler(httpd_req_t *req)
 {
-    char req_recv_buf[WEBSERVER_HTTPD_REQ_RECV_BUFFER_SIZE];
-    config_t new_config;
+    char chunk[WEBSERVER_FORM_CHUNK_SIZE];
+    webserver_form_t form = { .submitted = 0U };
+    form_parser_t parser;
+    size_t remaining = req->content_len;
     esp_err_t ret = ESP_OK;
 
-    /* Start from a copy of the current configuration */
-    ret = config_get_copy(&new_config);
-
-    ssize_t len = httpd_req_recv(req, req_recv_buf, (size_t)(sizeof(req_recv_buf) - 1U));
-    if (len <= 0) {
-        if (len == HTTPD_SOCK_ERR_TIMEOUT) {
-            httpd_resp_send_408(req);
-        }
+    if (remaining > WEBSERVER_FORM_MAX_BODY_SIZE) {
+        httpd_resp_send_err(req, HTTPD_413_CONTENT_TOO_LARGE, "Form too large");
+        ret = ESP_FAIL;
+    }
+    else if (webserver_write_admit(req) == false) {
+        httpd_resp_set_status(req, WEBSERVER_WRITE_LIMITED_STATUS);
+        httpd_resp_send(req, "Too many configuration changes, retry later", HTTPD_RESP_USE_STRLEN);
         ret = ESP_FAIL;
     }
+    else {
+        /* Start from a copy of the current configuration */
+        ret = config_get_copy(&form.config);
+        form_parser_init(&parser, update_form_pair, &form);
+    }
 
-    if (ret == ESP_OK) {
-        esp_err_t query_res;
-        char tmp[64U];
-
-        req_recv_buf[(size_t)len] = 0; /* Null-terminate received data */
-
-        /* Read "ssid" parameter */
-        query_res = httpd_query_key_value(req_recv_buf, "ssid", tmp, sizeof(tmp));
-        if (query_res == ESP_OK)
-        {
-            uint8_t decoded[64U] = {0};
-            size_t decoded_len = 0U;
-
-            uint8_t ret_decode = url_decode(decoded, sizeof(decoded),
-                                       (uint8_t *)tmp, strlen(tmp),
-                                       &decoded_len);
-
-            if (ret_decode == WEBSERVER_URLDEC_OK) {
-                /* Copy safely into new_config.ssid */
-                size_t copy_len = (decoded_len < sizeof(new_config.ssid) - 1U)
-                                ? decoded_len
-                                : sizeof(new_config.ssid) - 1U;
-
-                (void)strncpy(new_config.ssid, (char *)decoded, copy_len);
-                new_config.ssid[copy_len] = '\0';
+    while ((ret == ESP_OK) && (remaining > 0U)) {
+        int len = httpd_req_recv(req, chunk, (remaining < sizeof(chunk)) ? remaining : sizeof(chunk));
+        if (len <= 0) {
+            if (len == HTTPD_SOCK_ERR_TIMEOUT) {
+                httpd_resp_send_408(req);
             }
-            else {
-                ESP_LOGE(WEBSERVER_TAG, "URL decode error: 0x%02X", ret_decode);
-            }
-
+            ret = ESP_FAIL;
         }
-
-        /* Read "wpa-passphrase" parameter */
-        query_res = httpd_query_key_value(req_recv_buf, "wpa-passphrase", tmp, sizeof(tmp));
-        if (query_res == ESP_OK)
-        {
-            uint8_t decoded[64U] = {0};
-            size_t decoded_len = 0U;
-
-            uint8_t ret_decode = url_decode(decoded, sizeof(decoded),
-                                       (uint8_t *)tmp, strlen(tmp),
-                                       &decoded_len);
-
-            if (ret_decode == WEBSERVER_URLDEC_OK) {
-                /* Copy safely into new_config.wpa_passphrase */
-                size_t copy_len = (decoded_len < sizeof(new_config.wpa_passphrase) - 1U)
-                                ? decoded_len
-                                : sizeof(new_config.wpa_passphrase) - 1U;
-
-                (void)strncpy(new_config.wpa_passphrase, (char *)decoded, copy_len);
-                new_config.wpa_passphrase[copy_len] = '\0';
-            }
-            else {
-                ESP_LOGE(WEBSERVER_TAG, "URL decode error: 0x%02X", ret_decode);
-            }
+        else {
+            (void)form_parser_feed(&parser, chunk, (size_t)len);
+            remaining -= (size_t)len;
         }
+    }
 
-        /* Read "mode" parameter */
-        query_res = httpd_query_key_value(req_recv_buf, "mode", tmp, sizeof(tmp));
-        if (query_res == ESP_OK)
-        {
-            char *local_endptr = NULL;
-            errno = 0;  /* Reset errno before calling strtol */
-            const long tmp_val = strtol(tmp, &local_endptr, 10);
-            /* Check for successful numeric conversion */
-            if ((local_endptr != tmp) && (*local_endptr == '\0') && (errno == 0))
-            {
-                if ((tmp_val >= 0) && (tmp_val <= 2)) {
-                    new_config.mode = (uint8_t)tmp_val;
-                }
-            }
-        }
+    if (ret == ESP_OK) {
+        (void)form_parser_finish(&parser);
 
-        /* Read "ntp" parameter */
-        query_res = httpd_query_key_value(req_recv_buf, "ntp", tmp, sizeof(tmp));
-        if (query_res == ESP_OK)
-        {
-            char *local_endptr = NULL;
-            errno = 0;  /* Reset errno before calling strtol */
-            const long tmp_val = strtol(tmp, &local_endptr, 10);
-            /* Check for successful numeric conversion */
-            if ((local_endptr != tmp) && (*local_endptr == '\0') && (errno == 0)) {
-                if ((tmp_val >= 0) && (tmp_val <= 1)) {
-                    new_config.ntp = (uint8_t)tmp_val;
-                }
+        /* Checkboxes are not submitted when unchecked */
+        for (uint8_t i = 0U; i < (uint8_t)CONFIG_FIELD_COUNT; i++) {
+            if (((config_fields[i].flags & CONFIG_FIELD_FLAG_CHECKBOX) != 0U) &&
+                ((form.submitted & (1UL << i)) == 0U)) {
+                (void)config_field_set_u8(&form.config, &config_fields[i], (long)config_fields[i].min);
             }
         }
-        else {
-            /* Field is not present if ntp is not checked */
-            new_config.ntp = 0U;
-        }
 
-        /* Read "hours" parameter */
-        query_res = httpd_query_key_value(req_recv_buf, "hours", tmp, sizeof(tmp));
-        if (query_res == ESP_OK)
-        {
-            char *local_endptr = NULL;
-            errno = 0;  /* Reset errno before calling strtol */
-            const long tmp_val = strtol(tmp, &local_endptr, 10);
-            /* Check for successful numeric conversion */
-            if ((local_endptr != tmp) && (*local_endptr == '\0') && (errno == 0))
-            {
-                if ((tmp_val >= 0) && (tmp_val <= 23)) {
-                    new_config.time.hours = (uint8_t)tmp_val;
-                }
-            }
-        }
+        /* Update global configuration, bursts are applied once */
+        ret = webserver_write_apply(&form.config);
 
-        /* Read "minutes" parameter */
-        query_res = httpd_query_key_value(req_recv_buf, "minutes", tmp, sizeof(tmp));
-        if (query_res == ESP_OK)
-        {
-            char *local_endptr = NULL;
-            errno = 0;  /* Reset errno before calling strtol */
-            const long tmp_val = strtol(tmp, &local_endptr, 10);
-            /* Check for successful numeric conversion */
-            if ((local_endptr != tmp) && (*local_endptr == '\0') && (errno == 0))
-            {
-                if ((tmp_val >= 0) && (tmp_val <= 59)) {
-                    new_config.time.minutes = (uint8_t)tmp_val;
-                }
-            }
-        }
+        /* Redirect client back to the root page */
+        httpd_resp_set_status(req, "303 See Other");
+        httpd_resp_set_hdr(req, "Location", "/");
+        httpd_resp_send(req, NULL, 0);
+    }
 
-        /* Read "seconds" parameter */
-        query_res = httpd_query_key_value(req_recv_buf, "seconds", tmp, sizeof(tmp));
-        if (query_res == ESP_OK)
-        {
-            char *local_endptr = NULL;
-            errno = 0;  /* Reset errno before calling strtol */
-            const long tmp_val = strtol(tmp, &local_endptr, 10);
-            /* Check for successful numeric conversion */
-            if ((local_endptr != tmp) && (*local_endptr == '\0') && (errno == 0))
-            {
-                if ((tmp_val >= 0) && (tmp_val <= 59)) {
-                    new_config.time.seconds = (uint8_t)tmp_val;
-                }
-            }
-        }
+    return ret;
+}
 
-        /* Read "dutycycle" parameter */
-        query_res = httpd_query_key_value(req_recv_buf, "dutycycle", tmp, sizeof(tmp));
-        if (query_res == ESP_OK)
-        {
-            char *local_endptr = NULL;
-            errno = 0;  /* Reset errno before calling strtol */
-            const long tmp_val = strtol(tmp, &local_endptr, 10);
-            /* Check for successful numeric conversion */
-            if ((local_endptr != tmp) && (*local_endptr == '\0') && (errno == 0))
-            {
-                if ((tmp_val >= 0) && (tmp_val <= 255)) {
-                    new_config.dutycycle = (uint8_t)tmp_val;
-                }
-            }
+/**
+ * @brief Handles the event bus statistics page ("/stats") request.
+ *
+ * Streams the event bus report as plain text, one chunk per line.
+ *
+ * @param req Pointer to the HTTP request structure.
+ *
+ * @return ESP_OK on success, ESP_FAIL if the client went away.
+ */
+static esp_err_t stats_handler(httpd_req_t *req)
+{
+    char line[WEBSERVER_STATS_LINE_SIZE];
+    esp_err_t ret = ESP_OK;
+    size_t len = 0U;
+
+    httpd_resp_set_type(req, "text/plain");
+    for (uint16_t i = 0U; (ret == ESP_OK) && ((len = event_bus_stats_format_line(i, line, sizeof(line) - 1U)) > 0U); i++) {
+        line[len] = '\n';
+        ret = httpd_resp_send_chunk(req, line, (ssize_t)(len + 1U));
+    }
+    if (ret == ESP_OK) {
+        ret = httpd_resp_send_chunk(req, NULL, 0);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Handles the health metrics ("/metrics") request.
+ *
+ * Reports heap, task stacks, event bus lanes and dispatch latencies,
+ * health counters and histograms, Wi-Fi signal and NVS writes in the
+ * Prometheus text exposition format.
+ * Counters are only read here, their hot paths are single atomics.
+ *
+ * @param req Pointer to the HTTP request structure.
+ *
+ * @return ESP_OK on success, ESP_FAIL if the client went away.
+ */
+static esp_err_t metrics_handler(httpd_req_t *req)
+{
+    webserver_render_t render = { .req = req, .cache = NULL, .clk = NULL, .len = 0U, .ret = ESP_OK };
+    event_bus_lane_stats_t lanes[EVENT_BUS_LANE_COUNT];
+    event_bus_type_stats_t type_stats;
+    uint32_t buckets[METRICS_HIST_BUCKETS];
+    config_persist_stats_t persist;
+    wifi_ap_record_t ap;
+
+    httpd_resp_set_type(req, WEBSERVER_METRICS_CONTENT_TYPE);
+
+    render_metric_family(&render, "nixie_uptime_seconds", "gauge", "Time since boot");
+    render_metric(&render, "nixie_uptime_seconds", NULL, NULL, esp_timer_get_time() / 1000000LL);
+    render_metric_family(&render, "nixie_heap_free_bytes", "gauge", "Free heap");
+    render_metric(&render, "nixie_heap_free_bytes", NULL, NULL, (long long)esp_get_free_heap_size());
+    render_metric_family(&render, "nixie_heap_min_free_bytes", "gauge", "Lowest free heap since boot");
+    render_metric(&render, "nixie_heap_min_free_bytes", NULL, NULL, (long long)esp_get_minimum_free_heap_size());
+
+    render_metric_family(&render, "nixie_task_stack_free_bytes", "gauge", "Stack high-water mark, unused bytes at the worst point");
+    for (size_t i = 0U; i < (sizeof(webserver_metrics_tasks) / sizeof(webserver_metrics_tasks[0])); i++) {
+        TaskHandle_t task = xTaskGetHandle(webserver_metrics_tasks[i]);
+        if (task != NULL) {
+            render_metric(&render, "nixie_task_stack_free_bytes", "task", webserver_metrics_tasks[i],
+                          (long long)uxTaskGetStackHighWaterMark(task));
         }
+    }
 
-        /* Update global configuration */
-        ret = config_set_config(&new_config);
-        if (ret == ESP_OK) {
-            ret = config_save();
+    for (event_bus_lane_t lane = 0U; lane < EVENT_BUS_LANE_COUNT; lane++) {
+        (void)event_bus_get_lane_stats(lane, &lanes[lane]);
+    }
+#define WEBSERVER_METRIC_LANES(name, type, help, expr) \
+    render_metric_family(&render, (name), (type), (help)); \
+    for (event_bus_lane_t lane = 0U; lane < EVENT_BUS_LANE_COUNT; lane++) { \
+        render_metric(&render, (name), "lane", webserver_metrics_lanes[lane], (long long)(expr)); \
+    }
+    WEBSERVER_METRIC_LANES("nixie_event_bus_queue_depth", "gauge", "Events queued now", event_bus_get_lane_depth(lane))
+    WEBSERVER_METRIC_LANES("nixie_event_bus_queue_depth_peak", "gauge", "Most events queued at once", lanes[lane].depth_peak)
+    WEBSERVER_METRIC_LANES("nixie_event_bus_dispatched_total", "counter", "Events handed to the dispatcher", lanes[lane].dispatched)
+    WEBSERVER_METRIC_LANES("nixie_event_bus_dropped_total", "counter", "Events dropped on a full lane", lanes[lane].dropped)
+    WEBSERVER_METRIC_LANES("nixie_event_bus_coalesced_total", "counter", "Events merged into a queued one", lanes[lane].coalesced)
+    WEBSERVER_METRIC_LANES("nixie_event_bus_budget_overruns_total", "counter", "Events dispatched later than the lane budget", lanes[lane].budget_overruns)
+    WEBSERVER_METRIC_LANES("nixie_event_bus_latency_max_us", "gauge", "Worst publish-to-dispatch delay", lanes[lane].latency_max_us)
+    WEBSERVER_METRIC_LANES("nixie_event_bus_latency_us_total", "counter", "Sum of publish-to-dispatch delays", lanes[lane].latency_sum_us)
+#undef WEBSERVER_METRIC_LANES
+
+    /* Event types never dispatched are skipped */
+    render_metric_family(&render, "nixie_event_dispatch_latency_us", "histogram", "Publish-to-dispatch delay per event type");
+    for (event_bus_event_t type = 0U; type < EVT_COUNT; type++) {
+        if ((event_bus_get_type_stats(type, &type_stats) == true) && (type_stats.dispatched > 0U)) {
+            render_histogram(&render, "nixie_event_dispatch_latency_us", "event", webserver_metrics_events[type],
+                             type_stats.latency_hist, EVENT_BUS_HIST_BUCKETS, type_stats.latency_sum_us);
         }
+    }
 
-        /* Redirect client back to the root page */
-        httpd_resp_set_status(req, "303 See Other");
-        httpd_resp_set_hdr(req, "Location", "/");
-        httpd_resp_send(req, NULL, 0);
+    for (uint8_t i = 0U; i < (uint8_t)METRICS_COUNTER_COUNT; i++) {
+        render_metric_family(&render, metrics_counter_desc[i].name, "counter", metrics_counter_desc[i].help);
+        render_metric(&render, metrics_counter_desc[i].name, NULL, NULL, (long long)metrics_counter_get((metrics_counter_t)i));
     }
-    
+    for (uint8_t i = 0U; i < (uint8_t)METRICS_GAUGE_COUNT; i++) {
+        render_metric_family(&render, metrics_gauge_desc[i].name, "gauge", metrics_gauge_desc[i].help);
+        render_metric(&render, metrics_gauge_desc[i].name, NULL, NULL, (long long)metrics_gauge_get((metrics_gauge_t)i));
+    }
+    for (uint8_t i = 0U; i < (uint8_t)METRICS_HISTOGRAM_COUNT; i++) {
+        uint64_t sum = metrics_histogram_get((metrics_histogram_t)i, buckets);
+        render_metric_family(&render, metrics_histogram_desc[i].name, "histogram", metrics_histogram_desc[i].help);
+        render_histogram(&render, metrics_histogram_desc[i].name, NULL, NULL, buckets, METRICS_HIST_BUCKETS, sum);
+    }
+
+    if (esp_wifi_sta_get_ap_info(&ap) == ESP_OK) {
+        render_metric_family(&render, "nixie_wifi_rssi_dbm", "gauge", "Signal of the access point");
+        render_metric(&render, "nixie_wifi_rssi_dbm", NULL, NULL, (long long)ap.rssi);
+    }
+
+    if (config_get_persist_stats(&persist) == ESP_OK) {
+        render_metric_family(&render, "nixie_config_save_requests_total", "counter", "Calls to config_save()");
+        render_metric(&render, "nixie_config_save_requests_total", NULL, NULL, (long long)persist.save_requests);
+        render_metric_family(&render, "nixie_config_flushes_total", "counter", "Write-behind flushes to NVS");
+        render_metric(&render, "nixie_config_flushes_total", NULL, NULL, (long long)persist.flushes);
+        render_metric_family(&render, "nixie_nvs_writes_total", "counter", "NVS keys written");
+        render_metric(&render, "nixie_nvs_writes_total", NULL, NULL, (long long)persist.nvs_writes);
+        render_metric_family(&render, "nixie_nvs_writes_avoided_total", "counter", "NVS key writes coalesced away");
+        render_metric(&render, "nixie_nvs_writes_avoided_total", NULL, NULL, (long long)persist.writes_avoided);
+    }
+
+    return render_end(&render);
+}
+
+/**
+ * @brief Handles the static asset requests ("/static/...").
+ *
+ * Sends the gzipped asset with its ETag and a long cache lifetime, or an
+ * empty 304 Not Modified if the client already has this version.
+ *
+ * @param req Pointer to the HTTP request structure, user_ctx is the asset.
+ *
+ * @return ESP_OK on success, ESP_FAIL if the client went away.
+ */
+static esp_err_t asset_handler(httpd_req_t *req)
+{
+    const webserver_asset_t *asset = (const webserver_asset_t *)req->user_ctx;
+    char if_none_match[WEBSERVER_IF_NONE_MATCH_SIZE];
+    esp_err_t ret = ESP_OK;
+
+    httpd_resp_set_hdr(req, "ETag", asset->etag);
+    httpd_resp_set_hdr(req, "Cache-Control", WEBSERVER_ASSET_CACHE_CONTROL);
+
+    if ((httpd_req_get_hdr_value_str(req, "If-None-Match", if_none_match, sizeof(if_none_match)) == ESP_OK) &&
+        (strstr(if_none_match, asset->etag) != NULL)) {
+        httpd_resp_set_status(req, "304 Not Modified");
+        ret = httpd_resp_send(req, NULL, 0);
+    }
+    else {
+        httpd_resp_set_type(req, asset->type);
+        httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+        ret = httpd_resp_send(req, (const char *)asset->start, (ssize_t)(asset->end - asset->start));
+    }
+
     return ret;
 }
 
+/**
+ * @brief Computes the ETag of an asset, a FNV-1a hash of its content.
+ *
+ * @param asset Asset to update.
+ */
+static void asset_compute_etag(webserver_asset_t *asset)
+{
+    uint32_t hash = 2166136261UL;
+
+    for (const uint8_t *p = asset->start; p < asset->end; p++) {
+        hash = (hash ^ (uint32_t)*p) * 16777619UL;
+    }
+    (void)snprintf(asset->etag, sizeof(asset->etag), "\"%08" PRIx32 "\"", hash);
+}
+
+/**
+ * @brief Server close callback, releases event stream clients.
+ *
+ * @param server HTTP server.
+ * @param sockfd Socket being closed.
+ */
+static void webserver_close_fn(httpd_handle_t server, int sockfd)
+{
+    (void)server;
+    webserver_events_on_close(sockfd);
+    (void)close(sockfd);
+}
+
 /**
  * @brief Starts the HTTP web server and registers URI handlers.
  *
  * This function initializes the HTTP server using default configuration,
- * and registers the handlers for "/", "/on", and "/off".
+ * and registers the handlers for the page ("/"), the form ("/update"),
+ * the statistics ("/stats", "/metrics"), the static assets ("/static/...") and the
+ * JSON API ("/api/...", including the "/api/events" stream).
  *
  * @return httpd_handle_t Handle to the running HTTP server if successful,
  *                        NULL if the server failed to start.
@@ -317,11 +540,24 @@ httpd_handle_t start_webserver(void)
     httpd_handle_t server = NULL;
     esp_err_t start_result = ESP_FAIL;
 
-    config.stack_size = 65535;    /* 64 KB */
+    config.stack_size = MEM_BUDGET_HTTPD_STACK_SIZE;
     config.task_priority = tskIDLE_PRIORITY + 5U;
+    config.max_uri_handlers = WEBSERVER_MAX_URI_HANDLERS;
+    /* Event streams hold their socket, recycle the oldest when all are busy */
+    config.lru_purge_enable = true;
+    config.close_fn = webserver_close_fn;
+
+    /* The page links the assets by ETag, compute them before serving it */
+    for (uint8_t i = 0U; i < WEBSERVER_ASSET_COUNT; i++) {
+        asset_compute_etag(&webserver_assets[i]);
+    }
 
     start_result = httpd_start(&server, &config);
     if (start_result == ESP_OK) {
+        /* Before the handlers, they use its rate limiter */
+        if (webserver_write_init(server) != ESP_OK) {
+            ESP_LOGW(WEBSERVER_TAG, "Configuration writes are applied without merging");
+        }
 
         httpd_uri_t root = {
             .uri       = "/",
@@ -338,6 +574,35 @@ httpd_handle_t start_webserver(void)
             .user_ctx  = NULL
         };
         httpd_register_uri_handler(server, &update);
+
+        httpd_uri_t stats = {
+            .uri       = "/stats",
+            .method    = HTTP_GET,
+            .handler   = stats_handler,
+            .user_ctx  = NULL
+        };
+        httpd_register_uri_handler(server, &stats);
+
+        httpd_uri_t metrics = {
+            .uri       = "/metrics",
+            .method    = HTTP_GET,
+            .handler   = metrics_handler,
+            .user_ctx  = NULL
+        };
+        httpd_register_uri_handler(server, &metrics);
+
+        for (uint8_t i = 0U; i < WEBSERVER_ASSET_COUNT; i++) {
+            httpd_uri_t asset = {
+                .uri       = webserver_assets[i].uri,
+                .method    = HTTP_GET,
+                .handler   = asset_handler,
+                .user_ctx  = &webserver_assets[i]
+            };
+            httpd_register_uri_handler(server, &asset);
+        }
+
+        (void)webserver_api_register(server);
+        (void)webserver_events_register(server);
     }
 
     /* Small delay to ensure server is fully started */
@@ -366,32 +631,7 @@ static const char* get_html_page(void) {
     "<meta charset=\"UTF-8\">\n"
     "<meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">\n"
     "<title>Nixie clock settings</title>\n"
-    "<style>\n"
-    "body { font-family: 'Roboto', sans-serif; background: #0d0d0d; color: #e0e0e0; margin: 0; display: flex; justify-content: center; align-items: flex-start; min-height: 100vh; padding: 50px 20px; }\n"
-    ".card { background: #1e1e1e; border-radius: 16px; padding: 40px 30px; width: 380px; max-width: 100%%; box-shadow: 0 8px 25px rgba(0,0,0,0.7); border: 1px solid #2c2c2c; }\n"
-    "h1 { font-size: 2.2em; margin-bottom: 10px; color: #ffffff; text-align: center; letter-spacing: 1px; }\n"
-    "h2 { font-size: 1.4em; margin: 25px 0 10px 0; color: #cccccc; border-bottom: 1px solid #333; padding-bottom: 5px; }\n"
-    ".input-row { display: flex; justify-content: center; align-items: center; margin-bottom: 15px; }\n"
-    ".input-row input[type=number] { width: 60px; padding: 10px; margin: 0 5px; font-size: 18px; text-align: center; border-radius: 6px; border: 1px solid #333; background: #111; color: #fff; outline: none; transition: 0.2s; }\n"
-    ".input-row input[type=number]:focus { border-color: #888; box-shadow: 0 0 5px #555; }\n"
-    ".input-row input[type=number]:disabled { background: #333; color: #777; }\n"
-    ".input-group { display: flex; align-items: center; margin-bottom: 10px; }\n"
-    ".input-group label { width: 100px; }\n"
-    ".input-group input { padding: 10px; font-size: 16px; border-radius: 6px; border: 1px solid #333; background: #111; color: #fff; outline: none; box-sizing: border-box; }\n"
-    ".input-group input[type=text], .input-group input[type=password] { flex: 1; }\n"
-    ".input-group input:focus { border-color: #888; box-shadow: 0 0 5px #555; }\n"
-    ".input-group input:disabled { background: #333; color: #777; }\n"
-    ".checkbox-container { margin: 20px 0; }\n"
-    ".checkbox-container label { display: flex; align-items: center; font-size: 16px; margin-bottom: 10px; cursor: pointer; user-select: none; }\n"
-    ".checkbox-container input[type=checkbox], .checkbox-container input[type=radio] { width: 20px; height: 20px; margin-right: 12px; }\n"
-    "button { width: 100%%; padding: 14px; font-size: 18px; background: #555; color: #fff; border: none; border-radius: 8px; cursor: pointer; transition: 0.25s; font-weight: bold; }\n"
-    "button:hover { background: #777; }\n"
-    "hr { border: 0; border-top: 1px solid #333; margin: 20px 0; }\n"
-    ".brightness-container { display: flex; flex-direction: column; margin-bottom: 20px; }\n"
-    ".brightness-label-row { width: 100%%; display: flex; justify-content: space-between; align-items: center; margin-bottom: 5px; }\n"
-    "#brightness { width: 100%%; margin-top: 0; }\n"
-    "#brightnessValue { font-size: 18px; }\n"
-    "</style>\n"
+    "<link rel=\"stylesheet\" href=\"/static/style.css?v={{style_css_etag}}\">\n"
     "</head>\n"
     "<body>\n"
     "<div class=\"card\">\n"
@@ -399,28 +639,28 @@ static const char* get_html_page(void) {
     "<form action=\"/update\" method=\"POST\">\n"
     "<h2>Time synchronization</h2>\n"
     "<div class=\"checkbox-container\">\n"
-    "  <label><input type=\"checkbox\" id=\"ntp\" name=\"ntp\" value=\"1\" %s> Sync with NTP</label>\n"
+    "  <label><input type=\"checkbox\" id=\"ntp\" name=\"ntp\" value=\"1\" {{ntp}}> Sync with NTP</label>\n"
     "</div>\n"
     "<h2>Set time</h2>\n"
     "<div class=\"input-row\">\n"
-    "  <input type=\"number\" id=\"hours\" name=\"hours\" min=\"0\" max=\"23\" placeholder=\"HH\" value=\"%d\"> :\n"
-    "  <input type=\"number\" id=\"minutes\" name=\"minutes\" min=\"0\" max=\"59\" placeholder=\"MM\" value=\"%d\"> :\n"
-    "  <input type=\"number\" id=\"seconds\" name=\"seconds\" min=\"0\" max=\"59\" placeholder=\"SS\" value=\"%d\">\n"
+    "  <input type=\"number\" id=\"hours\" name=\"hours\" min=\"0\" max=\"23\" placeholder=\"HH\" value=\"{{hours}}\"> :\n"
+    "  <input type=\"number\" id=\"minutes\" name=\"minutes\" min=\"0\" max=\"59\" placeholder=\"MM\" value=\"{{minutes}}\"> :\n"
+    "  <input type=\"number\" id=\"seconds\" name=\"seconds\" min=\"0\" max=\"59\" placeholder=\"SS\" value=\"{{seconds}}\">\n"
     "</div>\n"
     "<h2>Wi-Fi</h2>\n"
     "<div class=\"input-group\">\n"
     "  <label for=\"ssid\">SSID:</label>\n"
-    "  <input type=\"text\" id=\"ssid\" name=\"ssid\" max=\"32\" value=\"%s\">\n"
+    "  <input type=\"text\" id=\"ssid\" name=\"ssid\" max=\"32\" value=\"{{ssid}}\">\n"
     "</div>\n"
     "<div class=\"input-group\">\n"
     "  <label for=\"wpa-passphrase\">WPA passphrase:</label>\n"
-    "  <input type=\"password\" id=\"wpa-passphrase\" name=\"wpa-passphrase\" max=\"63\" value=\"%s\">\n"
+    "  <input type=\"password\" id=\"wpa-passphrase\" name=\"wpa-passphrase\" max=\"63\" value=\"{{wpa_passphrase}}\">\n"
     "</div>\n"
     "<h2>Mode</h2>\n"
     "<div class=\"checkbox-container\">\n"
-    "  <label><input type=\"radio\" name=\"mode\" value=\"0\" %s> Hour mode</label>\n"
-    "  <label><input type=\"radio\" name=\"mode\" value=\"1\" %s> Cathode antipoisoning mode</label>\n"
-    "  <label><input type=\"radio\" name=\"mode\" value=\"2\" %s> Test mode</label>\n"
+    "  <label><input type=\"radio\" name=\"mode\" value=\"0\" {{mode0}}> Hour mode</label>\n"
+    "  <label><input type=\"radio\" name=\"mode\" value=\"1\" {{mode1}}> Cathode antipoisoning mode</label>\n"
+    "  <label><input type=\"radio\" name=\"mode\" value=\"2\" {{mode2}}> Test mode</label>\n"
     "</div>\n"
     "<h2>Brightness control</h2>\n"
     "<div class=\"brightness-container\">\n"
@@ -428,175 +668,368 @@ static const char* get_html_page(void) {
     "      <label for=\"brightness\">Brightness:</label>\n"
     "      <span id=\"brightnessValue\"></span>\n"
     "  </div>\n"
-    "  <input type=\"range\" id=\"dutycycle\" name=\"dutycycle\" min=\"0\" max=\"255\" value=\"%d\">\n"
+    "  <input type=\"range\" id=\"dutycycle\" name=\"dutycycle\" min=\"0\" max=\"255\" value=\"{{dutycycle}}\">\n"
     "</div>\n"
     "<hr>\n"
     "<button type=\"submit\">Apply</button>\n"
     "</form>\n"
     "</div>\n"
-    "<script>\n"
-    "const ntpCheckbox = document.getElementById('ntp');\n"
-    "const hourInputs = [document.getElementById('hours'), document.getElementById('minutes'), document.getElementById('seconds')];\n"
-    "function updateTimeInputs() {\n"
-    "  const disabled = ntpCheckbox.checked;\n"
-    "  hourInputs.forEach(input => { input.disabled = disabled; });\n"
-    "}\n"
-    "updateTimeInputs();\n"
-    "ntpCheckbox.addEventListener('change', updateTimeInputs);\n"
-    "const brightnessSlider = document.getElementById('dutycycle');\n"
-    "const brightnessValue = document.getElementById('brightnessValue');\n"
-    "brightnessValue.textContent = brightnessSlider.value;\n"
-    "brightnessSlider.addEventListener('input', () => { brightnessValue.textContent = brightnessSlider.value; });\n"
-    "</script>\n"
+    "<script src=\"/static/app.js?v={{app_js_etag}}\"></script>\n"
     "</body>\n"
     "</html>\n";
     return html_page_data;
 }
 
 /**
- * @brief Converts a single hexadecimal character to its integer value.
+ * @brief Sends the buffered dynamic values as one chunk.
  *
- * This function takes a hexadecimal character ('0'-'9', 'A'-'F', 'a'-'f') and
- * returns its corresponding integer value (0-15). If the input character
- * is not a valid hexadecimal digit, the function returns 0xFFU.
+ * @param render Renderer state.
+ */
+static void render_flush(webserver_render_t *render)
+{
+    if ((render->ret == ESP_OK) && (render->len > 0U)) {
+        render->ret = httpd_resp_send_chunk(render->req, render->buf, (ssize_t)render->len);
+    }
+    render->len = 0U;
+}
+
+/**
+ * @brief Appends data to the response.
  *
- * @param c The hexadecimal character to convert.
- * @return uint8_t The integer value of the hex character, or 0xFFU if invalid.
+ * Small writes are batched in the render buffer, larger ones such as the
+ * static parts of the template are sent directly without a copy.
+ *
+ * @param render Renderer state.
+ * @param data Data to send.
+ * @param len Length of data in bytes.
  */
-static uint8_t hex_to_uint8(uint8_t c)
+static void render_write(webserver_render_t *render, const char *data, size_t len)
 {
-    uint8_t result = 0xFFU;
-    
-    if ((c >= (uint8_t)'0') && (c <= (uint8_t)'9')) {
-        result = (uint8_t)(c - (uint8_t)'0');
+    if ((render->len + len) > sizeof(render->buf)) {
+        render_flush(render);
     }
-    else if ((c >= (uint8_t)'A') && (c <= (uint8_t)'F')) {
-        result = (uint8_t)(c - (uint8_t)'A' + 10U);
+
+    if (render->ret != ESP_OK) {
+        /* Client is gone, drop the rest of the page */
     }
-    else if ((c >= (uint8_t)'a') && (c <= (uint8_t)'f')) {
-        result = (uint8_t)(c - (uint8_t)'a' + 10U);
+    else if (len >= sizeof(render->buf)) {
+        render->ret = httpd_resp_send_chunk(render->req, data, (ssize_t)len);
     }
     else {
-        /* result is 0xFFU */
+        (void)memcpy(&render->buf[render->len], data, len);
+        render->len += len;
+    }
+}
+
+/**
+ * @brief Appends data to the page cache.
+ *
+ * @param cache Page cache being rebuilt.
+ * @param data Data to append.
+ * @param len Length of data in bytes.
+ */
+static void page_cache_append(webserver_page_cache_t *cache, const char *data, size_t len)
+{
+    /* Cannot overflow, the size covers fully escaped strings */
+    if (((size_t)cache->len + len) <= sizeof(cache->text)) {
+        (void)memcpy(&cache->text[cache->len], data, len);
+        cache->len += (uint16_t)len;
     }
-    
-    return result;
 }
 
 /**
- * @brief Decodes a percent-encoded (URL-encoded) string.
- *
- * This function converts percent-encoded sequences (e.g., "%20") and plus signs
- * ('+') in the input string to their corresponding ASCII characters.
- * It is safe for use with embedded systems and buffers, using a length-limited
- * approach.
- *
- * @param dst Pointer to the destination buffer to store the decoded string.
- * @param dst_size Size of the destination buffer in bytes (must be > 0).
- * @param src Pointer to the source buffer containing the URL-encoded string.
- * @param src_len Length of the source buffer in bytes.
- * @param out_len Pointer to a size_t variable to store the length of the decoded string
- *                (excluding the null terminator). Can be NULL if not needed.
- * @return uint8_t Status code of the decoding operation:
- *         - WEBSERVER_URLDEC_OK: Decoding successful.
- *         - WEBSERVER_URLDEC_WARN_INVALID_SEQ: Input contains invalid percent-encoded sequences.
- *         - WEBSERVER_URLDEC_WARN_TRUNCATED: Destination buffer was too small; output truncated.
- *         - WEBSERVER_URLDEC_ERR_BAD_PARAM: Invalid input parameters (NULL pointers or dst_size = 0).
+ * @brief Appends a string escaped for an HTML attribute value.
+ *
+ * @param cache Page cache being rebuilt.
+ * @param src Null-terminated string to escape.
  */
-static uint8_t url_decode(uint8_t *dst, size_t dst_size,
-                             const uint8_t *src, size_t src_len,
-                             size_t *out_len)
+static void page_cache_append_escaped(webserver_page_cache_t *cache, const char *src)
 {
+    for (size_t i = 0U; src[i] != '\0'; i++) {
+        const char *esc = NULL;
 
-    uint8_t status = WEBSERVER_URLDEC_OK;
-    if ((dst == NULL) || (src == NULL) || (dst_size == 0U)) {
-        status = WEBSERVER_URLDEC_ERR_BAD_PARAM;
+        switch (src[i]) {
+            case '&':  esc = "&amp;";  break;
+            case '<':  esc = "&lt;";   break;
+            case '>':  esc = "&gt;";   break;
+            case '"':  esc = "&quot;"; break;
+            case '\'': esc = "&#39;";  break;
+            default:   break;
+        }
+
+        if (esc != NULL) {
+            page_cache_append(cache, esc, strlen(esc));
+        } else {
+            page_cache_append(cache, &src[i], 1U);
+        }
     }
-    else {
-        size_t i = 0;
-        size_t j = 0;
-        
-        while ((i < src_len) && (j < (dst_size - 1U))) {
-
-            if ((src[i] == (uint8_t)'%') && ((i + 2U) < src_len)) {
-
-                uint8_t hi = hex_to_uint8(src[i + 1U]);
-                uint8_t lo = hex_to_uint8(src[i + 2U]);
-                
-                if ((hi != 0xFFU) && (lo != 0xFFU)) {
-                    dst[j] = (uint8_t)((hi << 4U) | lo);
-                    j++;
-                    i += 3U;
-                }
-                else {
-                    dst[j] = src[i];
-                    j++;
-                    i++;
-                    status = WEBSERVER_URLDEC_WARN_INVALID_SEQ;
-                }
+}
+
+/**
+ * @brief Renders the configuration values again if the configuration changed.
+ *
+ * The cache is keyed by config_get_generation(), so the config mutex is
+ * only taken for the first page after a change.
+ *
+ * @param cache Page cache.
+ *
+ * @return ESP_OK if the cache is up to date, the config_get_copy() error otherwise.
+ */
+static esp_err_t page_cache_refresh(webserver_page_cache_t *cache)
+{
+    /* Read before the copy, a concurrent change then triggers another refresh */
+    uint32_t generation = config_get_generation();
+    esp_err_t ret = ESP_OK;
+    config_t config;
+
+    if ((cache->valid == false) || (cache->generation != generation)) {
+        cache->valid = false;
+        ret = config_get_copy(&config);
+    }
+
+    if ((ret == ESP_OK) && (cache->valid == false)) {
+        cache->len = 0U;
+        for (uint8_t var = 0U; var < (uint8_t)WEBSERVER_PAGE_VAR_COUNT; var++) {
+            char value[12U];
+            int value_len = -1;
+            const char *text = NULL;
+
+            cache->start[var] = cache->len;
+            switch ((webserver_page_var_t)var) {
+                case WEBSERVER_PAGE_VAR_NTP:
+                    text = (config.ntp == 1U) ? "checked" : "";
+                    break;
+                case WEBSERVER_PAGE_VAR_SSID:
+                    page_cache_append_escaped(cache, config.ssid);
+                    break;
+                case WEBSERVER_PAGE_VAR_WPA_PASSPHRASE:
+                    page_cache_append_escaped(cache, config.wpa_passphrase);
+                    break;
+                case WEBSERVER_PAGE_VAR_MODE0:
+                    text = (config.mode == 0U) ? "checked" : "";
+                    break;
+                case WEBSERVER_PAGE_VAR_MODE1:
+                    text = (config.mode == 1U) ? "checked" : "";
+                    break;
+                case WEBSERVER_PAGE_VAR_MODE2:
+                    text = (config.mode == 2U) ? "checked" : "";
+                    break;
+                case WEBSERVER_PAGE_VAR_DUTYCYCLE:
+                    value_len = snprintf(value, sizeof(value), "%d", config.dutycycle);
+                    break;
+                case WEBSERVER_PAGE_VAR_STYLE_CSS_ETAG:
+                    /* ETag without its quotes */
+                    page_cache_append(cache, &webserver_assets[WEBSERVER_ASSET_STYLE_CSS].etag[1], WEBSERVER_ETAG_SIZE - 3U);
+                    break;
+                case WEBSERVER_PAGE_VAR_APP_JS_ETAG:
+                    page_cache_append(cache, &webserver_assets[WEBSERVER_ASSET_APP_JS].etag[1], WEBSERVER_ETAG_SIZE - 3U);
+                    break;
+                default:
+                    /* Time, formatted on every request */
+                    break;
+            }
+
+            if (text != NULL) {
+                page_cache_append(cache, text, strlen(text));
             }
-            else if (src[i] == (uint8_t)'+') {
-                dst[j] = (uint8_t)' ';
-                j++;
-                i++;
+            else if ((value_len > 0) && ((size_t)value_len < sizeof(value))) {
+                page_cache_append(cache, value, (size_t)value_len);
             }
             else {
-                dst[j] = src[i];
-                j++;
-                i++;
+                /* Value already written, or nothing to write */
             }
         }
+        cache->start[WEBSERVER_PAGE_VAR_COUNT] = cache->len;
+        cache->generation = generation;
+        cache->valid = true;
+    }
 
-        if (i < src_len) {
-            status = WEBSERVER_URLDEC_WARN_TRUNCATED;
-        }
+    return ret;
+}
 
-        dst[j] = (uint8_t)'\0';
-        if (out_len != NULL) {
-            *out_len = j;
-        }
+/**
+ * @brief Appends the value of a template variable.
+ *
+ * @param render Renderer state.
+ * @param name Variable name, not null-terminated.
+ * @param name_len Length of the name.
+ */
+static void render_var(webserver_render_t *render, const char *name, size_t name_len)
+{
+    uint8_t var = 0U;
+    char value[12U];
+    int value_len = -1;
+
+    while ((var < (uint8_t)WEBSERVER_PAGE_VAR_COUNT) &&
+           ((strlen(webserver_page_var_names[var]) != name_len) ||
+            (strncmp(name, webserver_page_var_names[var], name_len) != 0))) {
+        var++;
+    }
+
+    switch ((webserver_page_var_t)var) {
+        case WEBSERVER_PAGE_VAR_HOURS:
+            value_len = snprintf(value, sizeof(value), "%d", render->clk->hours);
+            break;
+        case WEBSERVER_PAGE_VAR_MINUTES:
+            value_len = snprintf(value, sizeof(value), "%d", render->clk->minutes);
+            break;
+        case WEBSERVER_PAGE_VAR_SECONDS:
+            value_len = snprintf(value, sizeof(value), "%d", render->clk->seconds);
+            break;
+        case WEBSERVER_PAGE_VAR_COUNT:
+            ESP_LOGW(WEBSERVER_TAG, "Unknown template variable %.*s", (int)name_len, name);
+            break;
+        default:
+            render_write(render, &render->cache->text[render->cache->start[var]],
+                         (size_t)render->cache->start[var + 1U] - (size_t)render->cache->start[var]);
+            break;
+    }
+
+    if ((value_len > 0) && ((size_t)value_len < sizeof(value))) {
+        render_write(render, value, (size_t)value_len);
     }
-    return status;
 }
 
 /**
- * @brief Escape HTML special characters in a string.
+ * @brief Streams a template as a chunked response.
  *
- * Replaces &, <, >, " with their HTML entity equivalents
- * to prevent cross-site scripting (XSS) when embedding
- * user-provided strings in HTML output.
+ * Text between WEBSERVER_TEMPLATE_OPEN and WEBSERVER_TEMPLATE_CLOSE is a
+ * variable name, replaced by render_var(). Everything else is sent as is.
  *
- * @param dst Destination buffer.
- * @param dst_size Size of the destination buffer.
- * @param src Source string to escape.
+ * @param render Renderer state.
+ * @param tpl Null-terminated template.
+ *
+ * @return ESP_OK if the whole page was sent, the send error otherwise.
  */
-static void html_escape(char *dst, size_t dst_size, const char *src)
+static esp_err_t render_template(webserver_render_t *render, const char *tpl)
 {
-    size_t j = 0U;
+    const char *cursor = tpl;
+    const char *open = NULL;
 
-    for (size_t i = 0U; (src[i] != '\0') && (j < (dst_size - 1U)); i++) {
-        const char *esc = NULL;
-        size_t esc_len = 0U;
+    while ((render->ret == ESP_OK) && ((open = strstr(cursor, WEBSERVER_TEMPLATE_OPEN)) != NULL)) {
+        const char *name = open + (sizeof(WEBSERVER_TEMPLATE_OPEN) - 1U);
+        const char *close = strstr(name, WEBSERVER_TEMPLATE_CLOSE);
 
-        switch (src[i]) {
-            case '&':  esc = "&amp;";  esc_len = 5U; break;
-            case '<':  esc = "&lt;";   esc_len = 4U; break;
-            case '>':  esc = "&gt;";   esc_len = 4U; break;
-            case '"':  esc = "&quot;"; esc_len = 6U; break;
-            case '\'': esc = "&#39;";  esc_len = 5U; break;
-            default:   break;
+        if (close == NULL) {
+            /* Unterminated variable, send the rest as text */
+            break;
         }
+        render_write(render, cursor, (size_t)(open - cursor));
+        render_var(render, name, (size_t)(close - name));
+        cursor = close + (sizeof(WEBSERVER_TEMPLATE_CLOSE) - 1U);
+    }
 
-        if ((esc != NULL) && ((j + esc_len) < dst_size)) {
-            (void)memcpy(&dst[j], esc, esc_len);
-            j += esc_len;
-        } else if (esc == NULL) {
-            dst[j] = src[i];
-            j++;
-        } else {
-            break;
+    render_write(render, cursor, strlen(cursor));
+
+    return render_end(render);
+}
+
+/**
+ * @brief Sends the buffered data and terminates the chunked response.
+ *
+ * @param render Renderer state.
+ *
+ * @return ESP_OK if the whole response was sent, the send error otherwise.
+ */
+static esp_err_t render_end(webserver_render_t *render)
+{
+    render_flush(render);
+    if (render->ret == ESP_OK) {
+        render->ret = httpd_resp_send_chunk(render->req, NULL, 0);
+    }
+
+    return render->ret;
+}
+
+/**
+ * @brief Appends the HELP and TYPE lines of a metric family.
+ *
+ * @param render Renderer state.
+ * @param name Metric name.
+ * @param type "counter", "gauge" or "histogram".
+ * @param help One-line description.
+ */
+static void render_metric_family(webserver_render_t *render, const char *name, const char *type, const char *help)
+{
+    char line[WEBSERVER_METRICS_LINE_SIZE];
+    int len = snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+
+    if ((len > 0) && ((size_t)len < sizeof(line))) {
+        render_write(render, line, (size_t)len);
+    }
+}
+
+/**
+ * @brief Appends one sample in the text exposition format.
+ *
+ * @param render Renderer state.
+ * @param name Metric name.
+ * @param label Label name, NULL for an unlabelled sample.
+ * @param label_value Label value, plain text without quotes.
+ * @param value Sample value.
+ */
+static void render_metric(webserver_render_t *render, const char *name, const char *label, const char *label_value, long long value)
+{
+    char line[WEBSERVER_METRICS_LINE_SIZE];
+    int len = -1;
+
+    if (label != NULL) {
+        len = snprintf(line, sizeof(line), "%s{%s=\"%s\"} %lld\n", name, label, label_value, value);
+    }
+    else {
+        len = snprintf(line, sizeof(line), "%s %lld\n", name, value);
+    }
+    if ((len > 0) && ((size_t)len < sizeof(line))) {
+        render_write(render, line, (size_t)len);
+    }
+}
+
+/**
+ * @brief Appends the samples of a log2 histogram.
+ *
+ * Bucket i of the source counts integer values in [2^i, 2^(i+1)), so its
+ * cumulative sample gets the inclusive bound le="2^(i+1) - 1". The last
+ * bucket is open-ended and becomes le="+Inf".
+ *
+ * @param render Renderer state.
+ * @param name Metric name, without the _bucket/_sum/_count suffixes.
+ * @param label Label name, NULL for an unlabelled histogram.
+ * @param label_value Label value, plain text without quotes.
+ * @param buckets Per-bucket counts, not cumulative.
+ * @param bucket_count Number of buckets.
+ * @param sum Sum of the observed values.
+ */
+static void render_histogram(webserver_render_t *render, const char *name, const char *label, const char *label_value,
+                             const uint32_t *buckets, uint8_t bucket_count, uint64_t sum)
+{
+    char line[WEBSERVER_METRICS_LINE_SIZE];
+    char labels[WEBSERVER_METRICS_LINE_SIZE / 2U] = "";
+    unsigned long long count = 0U;
+    int len = -1;
+
+    if (label != NULL) {
+        (void)snprintf(labels, sizeof(labels), "%s=\"%s\",", label, label_value);
+    }
+    for (uint8_t i = 0U; i < bucket_count; i++) {
+        count += buckets[i];
+        if (i < (bucket_count - 1U)) {
+            len = snprintf(line, sizeof(line), "%s_bucket{%sle=\"%lu\"} %llu\n", name, labels,
+                           (unsigned long)((1UL << (i + 1U)) - 1UL), count);
+        }
+        else {
+            len = snprintf(line, sizeof(line), "%s_bucket{%sle=\"+Inf\"} %llu\n", name, labels, count);
+        }
+        if ((len > 0) && ((size_t)len < sizeof(line))) {
+            render_write(render, line, (size_t)len);
         }
     }
 
-    dst[j] = '\0';
-}
\ No newline at end of file
+    /* Drop the trailing comma of the label list */
+    labels[(label != NULL) ? (strlen(labels) - 1U) : 0U] = '\0';
+    len = snprintf(line, sizeof(line), "%s_sum%s%s%s %llu\n%s_count%s%s%s %llu\n",
+                   name, (label != NULL) ? "{" : "", labels, (label != NULL) ? "}" : "", (unsigned long long)sum,
+                   name, (label != NULL) ? "{" : "", labels, (label != NULL) ? "}" : "", count);
+    if ((len > 0) && ((size_t)len < sizeof(line))) {
+        render_write(render, line, (size_t)len);
+    }
+}
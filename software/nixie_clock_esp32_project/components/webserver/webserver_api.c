@@ -0,0 +1,701 @@
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#ifdef STATIC_ANALYSIS
+#include "../test/common/esp_stub.h"
+#endif
+#include <string.h>
+#include "esp_app_desc.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "webserver_api.h"
+#include "webserver_events.h"
+#include "webserver_write.h"
+#include "config.h"
+#include "config_schema.h"
+#include "../event_bus/event_bus.h"
+#include "../clock_task/clock_task.h"
+#include "../json_stream/json_stream.h"
+#include "../ota/ota.h"
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+#define WEBSERVER_API_JSON_BUFFER_SIZE   (128U)
+#define WEBSERVER_API_BODY_SIZE          (256U)  /* Largest PATCH body, a full config fits */
+#define WEBSERVER_API_CONTENT_TYPE       "application/json"
+#define WEBSERVER_API_OTA_CHUNK_SIZE     (1024U) /* Image bytes received and flashed at a time */
+#define WEBSERVER_API_OTA_MAX_TIMEOUTS   (3U)    /* Consecutive receive timeouts before giving up */
+#define WEBSERVER_API_OTA_REBOOT_US      (1000000ULL)    /* Lets the response reach the client */
+#define WEBSERVER_API_OTA_SHA256_HEADER  "X-Image-SHA256"
+#define WEBSERVER_API_SHA256_HEX_SIZE    ((OTA_SHA256_SIZE * 2U) + 1U)
+#define WEBSERVER_API_TAG                "WEBSERVER_API"
+
+_Static_assert(CONFIG_FIELD_COUNT <= 32U, "patched fields are tracked in a 32-bit mask");
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+/* JSON response streamed as HTTP chunks */
+typedef struct {
+    httpd_req_t *req;
+    json_writer_t writer;
+    char buf[WEBSERVER_API_JSON_BUFFER_SIZE];
+} webserver_api_response_t;
+
+/* PATCH state, members are applied to a copy of the configuration */
+typedef struct {
+    config_t config;
+    uint32_t patched;           /* Bit per config_field_id_t */
+    const char *error;          /* First error, NULL if none */
+    const char *error_key;      /* Member that caused it, points into the body */
+} webserver_api_patch_t;
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+static esp_timer_handle_t webserver_api_reboot_timer = NULL;
+/* OTA upload state, kept off the 6 KiB httpd stack that esp_ota_end()
+ * image verification runs on. Only the single httpd task uses them, so
+ * uploads are serialized. */
+static char webserver_api_ota_chunk[WEBSERVER_API_OTA_CHUNK_SIZE];
+static ota_update_t webserver_api_ota_update;
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+static bool api_flush(void *ctx, const char *data, size_t len);
+static void api_begin(webserver_api_response_t *resp, httpd_req_t *req, const char *status);
+static esp_err_t api_end(webserver_api_response_t *resp);
+static esp_err_t api_send_error(httpd_req_t *req, const char *status, const char *error, const char *key);
+static bool api_patch_member(void *ctx, const char *key, const json_value_t *value);
+static void api_patch_time_from_clock(webserver_api_patch_t *patch);
+static esp_err_t api_config_get_handler(httpd_req_t *req);
+static esp_err_t api_config_patch_handler(httpd_req_t *req);
+static esp_err_t api_time_handler(httpd_req_t *req);
+static esp_err_t api_status_handler(httpd_req_t *req);
+static bool api_hex_decode(const char *hex, uint8_t *out, size_t out_size);
+static void api_hex_encode(const uint8_t *data, size_t len, char *hex);
+static esp_err_t api_ota_receive(httpd_req_t *req, ota_update_t *update);
+static esp_err_t api_ota_send_error(httpd_req_t *req, esp_err_t err);
+static void api_ota_reboot(void *arg);
+static esp_err_t api_ota_handler(httpd_req_t *req);
+
+/******************************************************************
+ * 6. Functions definitions
+******************************************************************/
+
+/**
+ * @brief JSON writer output, sends the buffer as one chunk.
+ */
+static bool api_flush(void *ctx, const char *data, size_t len)
+{
+    httpd_req_t *req = (httpd_req_t *)ctx;
+
+    return (httpd_resp_send_chunk(req, data, (ssize_t)len) == ESP_OK);
+}
+
+/**
+ * @brief Start a JSON response.
+ *
+ * @param resp Response state, lives on the handler stack.
+ * @param req HTTP request.
+ * @param status HTTP status line, NULL for 200 OK.
+ */
+static void api_begin(webserver_api_response_t *resp, httpd_req_t *req, const char *status)
+{
+    resp->req = req;
+    if (status != NULL) {
+        httpd_resp_set_status(req, status);
+    }
+    httpd_resp_set_type(req, WEBSERVER_API_CONTENT_TYPE);
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    json_writer_init(&resp->writer, resp->buf, sizeof(resp->buf), api_flush, req);
+}
+
+/**
+ * @brief Flush the JSON document and terminate the chunked response.
+ *
+ * @return ESP_OK if the whole document was sent.
+ */
+static esp_err_t api_end(webserver_api_response_t *resp)
+{
+    esp_err_t ret = ESP_FAIL;
+
+    if (json_writer_finish(&resp->writer) == true) {
+        ret = httpd_resp_send_chunk(resp->req, NULL, 0);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Send {"error": error, "field": key}, the field being optional.
+ */
+static esp_err_t api_send_error(httpd_req_t *req, const char *status, const char *error, const char *key)
+{
+    webserver_api_response_t resp;
+
+    api_begin(&resp, req, status);
+    json_object_begin(&resp.writer);
+    json_key(&resp.writer, "error");
+    json_string(&resp.writer, error);
+    if (key != NULL) {
+        json_key(&resp.writer, "field");
+        json_string(&resp.writer, key);
+    }
+    json_object_end(&resp.writer);
+
+    return api_end(&resp);
+}
+
+/**
+ * @brief Write the configuration as an object keyed like the web form.
+ *
+ * Secret fields are write-only and never sent back.
+ */
+void webserver_api_write_config(json_writer_t *w, const config_t *config)
+{
+    json_object_begin(w);
+    for (uint8_t i = 0U; i < (uint8_t)CONFIG_FIELD_COUNT; i++) {
+        const config_field_t *field = &config_fields[i];
+
+        if ((field->flags & CONFIG_FIELD_FLAG_SECRET) == 0U) {
+            json_key(w, field->key);
+            if (field->type == CONFIG_FIELD_STR) {
+                json_string(w, config_field_get_str(config, field));
+            }
+            else if ((field->flags & CONFIG_FIELD_FLAG_CHECKBOX) != 0U) {
+                json_bool(w, config_field_get_u8(config, field) != field->min);
+            }
+            else {
+                json_uint(w, (unsigned long)config_field_get_u8(config, field));
+            }
+        }
+    }
+    json_object_end(w);
+}
+
+/**
+ * @brief Apply one PATCH member to the configuration copy.
+ *
+ * Numeric fields take a number, checkboxes also take a boolean, text
+ * fields take a string. The first invalid member stops the parsing.
+ */
+static bool api_patch_member(void *ctx, const char *key, const json_value_t *value)
+{
+    webserver_api_patch_t *patch = (webserver_api_patch_t *)ctx;
+    const config_field_t *field = config_field_find(key);
+    esp_err_t ret = ESP_ERR_INVALID_ARG;
+
+    if (field == NULL) {
+        patch->error = "unknown field";
+    }
+    else if ((field->type == CONFIG_FIELD_STR) && (value->type == JSON_VALUE_STRING)) {
+        ret = config_field_set_from_str(&patch->config, field, value->str);
+    }
+    else if ((field->type == CONFIG_FIELD_U8) && (value->type == JSON_VALUE_NUMBER)) {
+        ret = config_field_set_u8(&patch->config, field, value->number);
+    }
+    else if ((field->type == CONFIG_FIELD_U8) && (value->type == JSON_VALUE_BOOL) &&
+             ((field->flags & CONFIG_FIELD_FLAG_CHECKBOX) != 0U)) {
+        ret = config_field_set_u8(&patch->config, field, (value->boolean == true) ? (long)field->max : (long)field->min);
+    }
+    else {
+        patch->error = "wrong type";
+    }
+
+    if (ret == ESP_OK) {
+        patch->patched |= (1UL << (uint32_t)(field - config_fields));
+    }
+    else {
+        if (patch->error == NULL) {
+            patch->error = "out of range";
+        }
+        patch->error_key = key;
+    }
+
+    return (ret == ESP_OK);
+}
+
+/**
+ * @brief Complete a partial time update with the running clock.
+ *
+ * The configured time is only the last time set by hand, so a PATCH of
+ * the minutes alone must keep the hours the clock shows now.
+ */
+static void api_patch_time_from_clock(webserver_api_patch_t *patch)
+{
+    const uint32_t time_fields = (1UL << CONFIG_FIELD_ID_HOURS) |
+                                 (1UL << CONFIG_FIELD_ID_MINUTES) |
+                                 (1UL << CONFIG_FIELD_ID_SECONDS);
+    myclock_t clk;
+
+    if (((patch->patched & time_fields) != 0U) && (clock_get_copy(&clk) == true)) {
+        if ((patch->patched & (1UL << CONFIG_FIELD_ID_HOURS)) == 0U) {
+            patch->config.time.hours = clk.hours;
+        }
+        if ((patch->patched & (1UL << CONFIG_FIELD_ID_MINUTES)) == 0U) {
+            patch->config.time.minutes = clk.minutes;
+        }
+        if ((patch->patched & (1UL << CONFIG_FIELD_ID_SECONDS)) == 0U) {
+            patch->config.time.seconds = clk.seconds;
+        }
+    }
+}
+
+/**
+ * @brief Handles GET /api/config.
+ *
+ * @param req Pointer to the HTTP request structure.
+ *
+ * @return ESP_OK on success, ESP_FAIL if the client went away.
+ */
+static esp_err_t api_config_get_handler(httpd_req_t *req)
+{
+    webserver_api_response_t resp;
+    config_t config;
+    esp_err_t ret = config_get_copy(&config);
+
+    if (ret == ESP_OK) {
+        api_begin(&resp, req, NULL);
+        webserver_api_write_config(&resp.writer, &config);
+        ret = api_end(&resp);
+    }
+    else {
+        ret = api_send_error(req, "503 Service Unavailable", "configuration busy", NULL);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Handles PATCH /api/config.
+ *
+ * The body is a flat JSON object with some of the fields of GET
+ * /api/config, plus the write-only secrets. Either all members are
+ * applied through webserver_write_apply() or none, then the new
+ * configuration is sent back. Writes over the rate limit are refused
+ * with 429 before the body is read.
+ *
+ * @param req Pointer to the HTTP request structure.
+ *
+ * @return ESP_OK on success, ESP_FAIL if the client went away or stalled.
+ */
+static esp_err_t api_config_patch_handler(httpd_req_t *req)
+{
+    char body[WEBSERVER_API_BODY_SIZE];
+    webserver_api_patch_t patch = { .patched = 0U, .error = NULL, .error_key = NULL };
+    size_t received = 0U;
+    esp_err_t ret = ESP_OK;
+
+    if (req->content_len > sizeof(body)) {
+        ret = api_send_error(req, "413 Content Too Large", "body too large", NULL);
+    }
+    else if (webserver_write_admit(req) == false) {
+        ret = api_send_error(req, WEBSERVER_WRITE_LIMITED_STATUS, "too many configuration changes", NULL);
+    }
+    else {
+        while ((ret == ESP_OK) && (received < req->content_len)) {
+            int len = httpd_req_recv(req, &body[received], req->content_len - received);
+            if (len <= 0) {
+                /* A stalled client must not hold the only server task */
+                if (len == HTTPD_SOCK_ERR_TIMEOUT) {
+                    httpd_resp_send_408(req);
+                }
+                ret = ESP_FAIL;
+            }
+            else {
+                received += (size_t)len;
+            }
+        }
+
+        if (ret != ESP_OK) {
+            /* Client is gone */
+        }
+        else if (config_get_copy(&patch.config) != ESP_OK) {
+            ret = api_send_error(req, "503 Service Unavailable", "configuration busy", NULL);
+        }
+        else {
+            json_status_t status = json_parse_object(body, received, api_patch_member, &patch);
+
+            if (patch.error != NULL) {
+                ret = api_send_error(req, "400 Bad Request", patch.error, patch.error_key);
+            }
+            else if (status != JSON_OK) {
+                ret = api_send_error(req, "400 Bad Request",
+                                     (status == JSON_ERR_SYNTAX) ? "malformed JSON" : "unsupported JSON", NULL);
+            }
+            else {
+                api_patch_time_from_clock(&patch);
+                ret = webserver_write_apply(&patch.config);
+
+                if (ret == ESP_OK) {
+                    webserver_api_response_t resp;
+
+                    api_begin(&resp, req, NULL);
+                    webserver_api_write_config(&resp.writer, &patch.config);
+                    ret = api_end(&resp);
+                }
+                else {
+                    ESP_LOGE(WEBSERVER_API_TAG, "Failed to apply configuration: %s", esp_err_to_name(ret));
+                    ret = api_send_error(req, "503 Service Unavailable", "configuration busy", NULL);
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Handles GET /api/time.
+ *
+ * @param req Pointer to the HTTP request structure.
+ *
+ * @return ESP_OK on success, ESP_FAIL if the client went away.
+ */
+static esp_err_t api_time_handler(httpd_req_t *req)
+{
+    webserver_api_response_t resp;
+    config_t config;
+    myclock_t clk;
+    esp_err_t ret = ESP_OK;
+
+    if ((clock_get_copy(&clk) == true) && (config_get_copy(&config) == ESP_OK)) {
+        api_begin(&resp, req, NULL);
+        json_object_begin(&resp.writer);
+        json_key(&resp.writer, "hours");
+        json_uint(&resp.writer, (unsigned long)clk.hours);
+        json_key(&resp.writer, "minutes");
+        json_uint(&resp.writer, (unsigned long)clk.minutes);
+        json_key(&resp.writer, "seconds");
+        json_uint(&resp.writer, (unsigned long)clk.seconds);
+        json_key(&resp.writer, "ntp");
+        json_bool(&resp.writer, config.ntp == 1U);
+        json_object_end(&resp.writer);
+        ret = api_end(&resp);
+    }
+    else {
+        ret = api_send_error(req, "503 Service Unavailable", "clock busy", NULL);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Handles GET /api/status.
+ *
+ * @param req Pointer to the HTTP request structure.
+ *
+ * @return ESP_OK on success, ESP_FAIL if the client went away.
+ */
+static esp_err_t api_status_handler(httpd_req_t *req)
+{
+    webserver_api_response_t resp;
+
+    api_begin(&resp, req, NULL);
+    webserver_api_write_status(&resp.writer);
+
+    return api_end(&resp);
+}
+
+/**
+ * @brief Write the device status: uptime, heap, persistence statistics and firmware.
+ */
+void webserver_api_write_status(json_writer_t *w)
+{
+    config_persist_stats_t persist;
+    bool has_persist = (config_get_persist_stats(&persist) == ESP_OK);
+    const esp_partition_t *running = esp_ota_get_running_partition();
+
+    json_object_begin(w);
+    json_key(w, "uptime_s");
+    json_uint(w, (unsigned long)(esp_timer_get_time() / 1000000LL));
+    json_key(w, "free_heap");
+    json_uint(w, (unsigned long)esp_get_free_heap_size());
+    json_key(w, "min_free_heap");
+    json_uint(w, (unsigned long)esp_get_minimum_free_heap_size());
+    json_key(w, "persist");
+    if (has_persist == true) {
+        json_object_begin(w);
+        json_key(w, "save_requests");
+        json_uint(w, (unsigned long)persist.save_requests);
+        json_key(w, "flushes");
+        json_uint(w, (unsigned long)persist.flushes);
+        json_key(w, "nvs_writes");
+        json_uint(w, (unsigned long)persist.nvs_writes);
+        json_key(w, "writes_avoided");
+        json_uint(w, (unsigned long)persist.writes_avoided);
+        json_object_end(w);
+    }
+    else {
+        json_null(w);
+    }
+    json_key(w, "firmware");
+    json_object_begin(w);
+    json_key(w, "version");
+    json_string(w, esp_app_get_description()->version);
+    json_key(w, "partition");
+    json_string(w, (running != NULL) ? running->label : "");
+    json_key(w, "pending_verify");
+    json_bool(w, ota_boot_is_pending());
+    json_object_end(w);
+    json_object_end(w);
+}
+
+/**
+ * @brief Decode a hexadecimal string of exactly 2 * out_size digits.
+ *
+ * @return true if the whole string was decoded.
+ */
+static bool api_hex_decode(const char *hex, uint8_t *out, size_t out_size)
+{
+    bool ok = (strlen(hex) == (out_size * 2U));
+
+    for (size_t i = 0U; (ok == true) && (i < (out_size * 2U)); i++) {
+        char c = hex[i];
+        uint8_t nibble = 0U;
+
+        if ((c >= '0') && (c <= '9')) {
+            nibble = (uint8_t)(c - '0');
+        }
+        else if ((c >= 'a') && (c <= 'f')) {
+            nibble = (uint8_t)((c - 'a') + 10);
+        }
+        else if ((c >= 'A') && (c <= 'F')) {
+            nibble = (uint8_t)((c - 'A') + 10);
+        }
+        else {
+            ok = false;
+        }
+
+        if ((i % 2U) == 0U) {
+            out[i / 2U] = (uint8_t)(nibble << 4U);
+        }
+        else {
+            out[i / 2U] |= nibble;
+        }
+    }
+
+    return ok;
+}
+
+/**
+ * @brief Encode data as a null-terminated lowercase hexadecimal string.
+ *
+ * @param hex Output, 2 * len + 1 characters.
+ */
+static void api_hex_encode(const uint8_t *data, size_t len, char *hex)
+{
+    static const char digits[] = "0123456789abcdef";
+
+    for (size_t i = 0U; i < len; i++) {
+        hex[2U * i] = digits[data[i] >> 4U];
+        hex[(2U * i) + 1U] = digits[data[i] & 0x0FU];
+    }
+    hex[2U * len] = '\0';
+}
+
+/**
+ * @brief Stream the request body into the update, one chunk at a time.
+ *
+ * @return ESP_OK once the whole body is written, ESP_ERR_TIMEOUT if the
+ *         client stalled, ESP_FAIL if it went away, or the write error.
+ *         The update is aborted on error.
+ */
+static esp_err_t api_ota_receive(httpd_req_t *req, ota_update_t *update)
+{
+    char *chunk = webserver_api_ota_chunk;
+    size_t remaining = req->content_len;
+    uint8_t timeouts = 0U;
+    esp_err_t ret = ESP_OK;
+
+    while ((ret == ESP_OK) && (remaining > 0U)) {
+        int len = httpd_req_recv(req, chunk, (remaining < WEBSERVER_API_OTA_CHUNK_SIZE) ? remaining : WEBSERVER_API_OTA_CHUNK_SIZE);
+        if (len == HTTPD_SOCK_ERR_TIMEOUT) {
+            timeouts++;
+            if (timeouts >= WEBSERVER_API_OTA_MAX_TIMEOUTS) {
+                ret = ESP_ERR_TIMEOUT;
+            }
+        }
+        else if (len <= 0) {
+            ret = ESP_FAIL;
+        }
+        else {
+            timeouts = 0U;
+            ret = ota_update_write(update, chunk, (size_t)len);
+            remaining -= (size_t)len;
+        }
+    }
+
+    if (ret != ESP_OK) {
+        ota_update_abort(update);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Answer a failed update with the matching status.
+ */
+static esp_err_t api_ota_send_error(httpd_req_t *req, esp_err_t err)
+{
+    esp_err_t ret = ESP_FAIL;
+
+    switch (err) {
+        case ESP_FAIL:
+            /* Client is gone */
+            break;
+        case ESP_ERR_TIMEOUT:
+            ret = api_send_error(req, "408 Request Timeout", "upload stalled", NULL);
+            break;
+        case ESP_ERR_INVALID_SIZE:
+            ret = api_send_error(req, "413 Content Too Large", "image empty or larger than the OTA partition", NULL);
+            break;
+        case ESP_ERR_INVALID_CRC:
+            ret = api_send_error(req, "422 Unprocessable Content", "sha256 mismatch", WEBSERVER_API_OTA_SHA256_HEADER);
+            break;
+        case ESP_ERR_OTA_VALIDATE_FAILED:
+            ret = api_send_error(req, "422 Unprocessable Content", "invalid image", NULL);
+            break;
+        case ESP_ERR_INVALID_STATE:
+        case ESP_ERR_OTA_ROLLBACK_INVALID_STATE:
+            ret = api_send_error(req, "409 Conflict", "running image not confirmed yet", NULL);
+            break;
+        case ESP_ERR_NOT_FOUND:
+            ret = api_send_error(req, "503 Service Unavailable", "no OTA partition", NULL);
+            break;
+        default:
+            ret = api_send_error(req, "500 Internal Server Error", esp_err_to_name(err), NULL);
+            break;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief One-shot timer callback, restarts on the new image.
+ */
+static void api_ota_reboot(void *arg)
+{
+    (void)arg;
+    esp_restart();
+}
+
+/**
+ * @brief Handles POST /api/ota.
+ *
+ * The body is the raw application image (build/<project>.bin), streamed
+ * into the inactive OTA partition in WEBSERVER_API_OTA_CHUNK_SIZE chunks
+ * and hashed on the way. When the optional X-Image-SHA256 header carries
+ * the hex digest of the body, a mismatch rejects the image. On success
+ * the digest is sent back and the device restarts on the new image,
+ * which has to pass its health check or is rolled back.
+ *
+ * @param req Pointer to the HTTP request structure.
+ *
+ * @return ESP_OK on success, ESP_FAIL if the client went away.
+ */
+static esp_err_t api_ota_handler(httpd_req_t *req)
+{
+    char hex[WEBSERVER_API_SHA256_HEX_SIZE];
+    uint8_t expected[OTA_SHA256_SIZE];
+    uint8_t digest[OTA_SHA256_SIZE];
+    bool has_expected = false;
+    bool bad_header = false;
+    ota_update_t *update = &webserver_api_ota_update;
+    esp_err_t ret = ESP_OK;
+
+    if (httpd_req_get_hdr_value_len(req, WEBSERVER_API_OTA_SHA256_HEADER) > 0U) {
+        has_expected = (httpd_req_get_hdr_value_str(req, WEBSERVER_API_OTA_SHA256_HEADER, hex, sizeof(hex)) == ESP_OK) &&
+                       (api_hex_decode(hex, expected, sizeof(expected)) == true);
+        bad_header = (has_expected == false);
+    }
+
+    if (bad_header == false) {
+        ret = ota_update_begin(update, req->content_len);
+        if (ret == ESP_OK) {
+            ret = api_ota_receive(req, update);
+        }
+        if (ret == ESP_OK) {
+            ret = ota_update_finish(update, (has_expected == true) ? expected : NULL, digest);
+        }
+    }
+
+    if (bad_header == true) {
+        ret = api_send_error(req, "400 Bad Request", "expected 64 hex digits", WEBSERVER_API_OTA_SHA256_HEADER);
+    }
+    else if (ret != ESP_OK) {
+        ret = api_ota_send_error(req, ret);
+    }
+    else {
+        webserver_api_response_t resp;
+        const esp_timer_create_args_t args = {
+            .callback = api_ota_reboot,
+            .arg = NULL,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "ota_reboot",
+        };
+
+        api_hex_encode(digest, sizeof(digest), hex);
+        api_begin(&resp, req, NULL);
+        json_object_begin(&resp.writer);
+        json_key(&resp.writer, "size");
+        json_uint(&resp.writer, (unsigned long)req->content_len);
+        json_key(&resp.writer, "sha256");
+        json_string(&resp.writer, hex);
+        json_key(&resp.writer, "partition");
+        json_string(&resp.writer, update->partition->label);
+        json_key(&resp.writer, "reboot");
+        json_bool(&resp.writer, true);
+        json_object_end(&resp.writer);
+        ret = api_end(&resp);
+
+        /* Restart once the response is out, pending config writes are flushed on the way */
+        if ((webserver_api_reboot_timer == NULL) &&
+            (esp_timer_create(&args, &webserver_api_reboot_timer) != ESP_OK)) {
+            esp_restart();
+        }
+        (void)esp_timer_start_once(webserver_api_reboot_timer, WEBSERVER_API_OTA_REBOOT_US);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Registers the JSON API handlers.
+ *
+ * - GET /api/config: configuration, secrets excepted
+ * - PATCH /api/config: partial update, answers the new configuration
+ * - GET /api/time: time shown by the clock
+ * - GET /api/status: uptime, heap, persistence statistics and firmware
+ * - POST /api/ota: firmware image, restarts on it
+ *
+ * The server needs WEBSERVER_API_URI_HANDLERS free URI handler slots.
+ *
+ * @param server Running HTTP server.
+ *
+ * @return ESP_OK if all handlers were registered.
+ */
+esp_err_t webserver_api_register(httpd_handle_t server)
+{
+    static const httpd_uri_t handlers[WEBSERVER_API_URI_HANDLERS] = {
+        { .uri = "/api/config", .method = HTTP_GET,   .handler = api_config_get_handler,   .user_ctx = NULL },
+        { .uri = "/api/config", .method = HTTP_PATCH, .handler = api_config_patch_handler, .user_ctx = NULL },
+        { .uri = "/api/time",   .method = HTTP_GET,   .handler = api_time_handler,         .user_ctx = NULL },
+        { .uri = "/api/status", .method = HTTP_GET,   .handler = api_status_handler,       .user_ctx = NULL },
+        { .uri = "/api/ota",    .method = HTTP_POST,  .handler = api_ota_handler,          .user_ctx = NULL },
+    };
+    esp_err_t ret = ESP_OK;
+
+    for (uint8_t i = 0U; (ret == ESP_OK) && (i < WEBSERVER_API_URI_HANDLERS); i++) {
+        ret = httpd_register_uri_handler(server, &handlers[i]);
+        if (ret != ESP_OK) {
+            ESP_LOGE(WEBSERVER_API_TAG, "Failed to register %s: %s", handlers[i].uri, esp_err_to_name(ret));
+        }
+    }
+
+    return ret;
+}
@@ -0,0 +1,35 @@
+#ifndef WEBSERVER_API_H
+#define WEBSERVER_API_H
+
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#include "esp_http_server.h"
+#include "config.h"
+#include "../json_stream/json_stream.h"
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+#define WEBSERVER_API_URI_HANDLERS       (5U)    /* Handlers registered by webserver_api_register() */
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+
+/******************************************************************
+ * 6. Functions definitions (public API in .c)
+******************************************************************/
+esp_err_t webserver_api_register(httpd_handle_t server);
+void webserver_api_write_config(json_writer_t *w, const config_t *config);
+void webserver_api_write_status(json_writer_t *w);
+
+#endif // WEBSERVER_API_H
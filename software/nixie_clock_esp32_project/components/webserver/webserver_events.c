@@ -0,0 +1,451 @@
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#ifdef STATIC_ANALYSIS
+#include "../test/common/esp_stub.h"
+#endif
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/socket.h>
+#include "esp_log.h"
+#include "webserver_events.h"
+#include "webserver_api.h"
+#include "config.h"
+#include "../clock_task/clock_task.h"
+#include "../json_stream/json_stream.h"
+#include "../event_bus/event_payloads.h"
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+#define WEBSERVER_EVENTS_MESSAGE_SIZE    (320U)  /* One SSE message, a full config fits */
+#define WEBSERVER_EVENTS_JSON_BUFFER_SIZE (32U)
+#define WEBSERVER_EVENTS_STALL_LIMIT     (10U)   /* Pushes a client may stay blocked before it is dropped */
+#define WEBSERVER_EVENTS_STATUS_PERIOD_S (10U)
+#define WEBSERVER_EVENTS_NO_SOCKET       (-1)
+#define WEBSERVER_EVENTS_TAG             "WEBSERVER_EVENTS"
+
+/* Sent once, the stream then stays open and the server never answers it */
+#define WEBSERVER_EVENTS_HEADERS \
+    "HTTP/1.1 200 OK\r\n" \
+    "Content-Type: text/event-stream\r\n" \
+    "Cache-Control: no-store\r\n" \
+    "Connection: keep-alive\r\n" \
+    "\r\n" \
+    "retry: 5000\n\n"
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+/* Connected SSE client, only touched from the server task */
+typedef struct {
+    int fd;                                     /* WEBSERVER_EVENTS_NO_SOCKET if the slot is free */
+    webserver_events_kind_t pending;            /* State not sent yet */
+    uint8_t stalls;                             /* Consecutive pushes without progress */
+    uint16_t tail_len;                          /* Unsent end of the last message */
+    char tail[WEBSERVER_EVENTS_MESSAGE_SIZE];
+} webserver_events_client_t;
+
+typedef struct {
+    char data[WEBSERVER_EVENTS_MESSAGE_SIZE];
+    size_t len;
+} webserver_events_message_t;
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+static _Atomic(httpd_handle_t) s_events_server = NULL;
+static atomic_uint_fast8_t s_events_pending = 0U;       /* Kinds published since the last push */
+static atomic_uint_fast8_t s_events_client_count = 0U;
+static atomic_bool s_events_push_queued = false;
+static uint32_t s_events_status_ticks = 0U;             /* Dispatcher task only */
+static webserver_events_client_t s_events_clients[WEBSERVER_EVENTS_MAX_CLIENTS];
+static webserver_events_message_t s_events_message;     /* Server task only */
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+static bool events_append(void *ctx, const char *data, size_t len);
+static bool events_format(webserver_events_kind_t kind, webserver_events_message_t *msg);
+static int events_send(httpd_handle_t server, webserver_events_client_t *client, const char *data, size_t len);
+static void events_drop(httpd_handle_t server, webserver_events_client_t *client);
+static void events_flush_tail(httpd_handle_t server, webserver_events_client_t *client);
+static void events_deliver(httpd_handle_t server, webserver_events_client_t *client, const webserver_events_message_t *msg);
+static void events_push(void *arg);
+static void events_schedule(void);
+static esp_err_t events_handler(httpd_req_t *req);
+
+/******************************************************************
+ * 6. Functions definitions
+******************************************************************/
+
+/**
+ * @brief JSON writer output, appends to the message being formatted.
+ */
+static bool events_append(void *ctx, const char *data, size_t len)
+{
+    webserver_events_message_t *msg = (webserver_events_message_t *)ctx;
+    bool fits = (len <= (sizeof(msg->data) - msg->len));
+
+    if (fits == true) {
+        (void)memcpy(&msg->data[msg->len], data, len);
+        msg->len += len;
+    }
+
+    return fits;
+}
+
+/**
+ * @brief Format the current state of one kind as an SSE message.
+ *
+ * @return false if the state could not be read or does not fit.
+ */
+static bool events_format(webserver_events_kind_t kind, webserver_events_message_t *msg)
+{
+    char buf[WEBSERVER_EVENTS_JSON_BUFFER_SIZE];
+    json_writer_t w;
+    const char *prefix = NULL;
+    config_t config;
+    myclock_t clk;
+    bool ok = true;
+
+    msg->len = 0U;
+    json_writer_init(&w, buf, sizeof(buf), events_append, msg);
+
+    if (kind == WEBSERVER_EVENTS_TIME) {
+        /* Pushed every second, read without the clock mutex */
+        clock_get_snapshot(&clk);
+        prefix = "event: time\ndata: ";
+        (void)events_append(msg, prefix, strlen(prefix));
+        json_object_begin(&w);
+        json_key(&w, "hours");
+        json_uint(&w, (unsigned long)clk.hours);
+        json_key(&w, "minutes");
+        json_uint(&w, (unsigned long)clk.minutes);
+        json_key(&w, "seconds");
+        json_uint(&w, (unsigned long)clk.seconds);
+        json_object_end(&w);
+    }
+    else if (kind == WEBSERVER_EVENTS_CONFIG) {
+        ok = (config_get_copy(&config) == ESP_OK);
+        if (ok == true) {
+            prefix = "event: config\ndata: ";
+            (void)events_append(msg, prefix, strlen(prefix));
+            webserver_api_write_config(&w, &config);
+        }
+    }
+    else {
+        prefix = "event: status\ndata: ";
+        (void)events_append(msg, prefix, strlen(prefix));
+        webserver_api_write_status(&w);
+    }
+
+    if (ok == true) {
+        ok = (json_writer_finish(&w) == true) && (events_append(msg, "\n\n", 2U) == true);
+    }
+    if (ok == false) {
+        ESP_LOGW(WEBSERVER_EVENTS_TAG, "Failed to format event 0x%02X", (unsigned)kind);
+    }
+
+    return ok;
+}
+
+/**
+ * @brief Send without blocking the server task.
+ *
+ * @return Bytes sent, possibly fewer than len, or -1 if the socket failed.
+ */
+static int events_send(httpd_handle_t server, webserver_events_client_t *client, const char *data, size_t len)
+{
+    size_t sent = 0U;
+    bool blocked = false;
+    int ret = 0;
+
+    while ((ret >= 0) && (blocked == false) && (sent < len)) {
+        ret = httpd_socket_send(server, client->fd, &data[sent], len - sent, MSG_DONTWAIT);
+        if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
+            /* Socket buffer is full, keep the rest for later */
+            blocked = true;
+            ret = 0;
+        }
+        else if (ret > 0) {
+            sent += (size_t)ret;
+        }
+        else {
+            ret = -1;
+        }
+    }
+
+    return (ret < 0) ? -1 : (int)sent;
+}
+
+/**
+ * @brief Close a client and free its slot.
+ */
+static void events_drop(httpd_handle_t server, webserver_events_client_t *client)
+{
+    (void)httpd_sess_trigger_close(server, client->fd);
+    client->fd = WEBSERVER_EVENTS_NO_SOCKET;
+    (void)atomic_fetch_sub(&s_events_client_count, 1U);
+}
+
+/**
+ * @brief Retry the unsent end of the last message.
+ *
+ * A client that stays blocked for WEBSERVER_EVENTS_STALL_LIMIT pushes is
+ * dropped, the browser reconnects by itself once it catches up.
+ */
+static void events_flush_tail(httpd_handle_t server, webserver_events_client_t *client)
+{
+    int sent = events_send(server, client, client->tail, client->tail_len);
+
+    if (sent < 0) {
+        events_drop(server, client);
+    }
+    else if ((uint16_t)sent == client->tail_len) {
+        client->tail_len = 0U;
+        client->stalls = 0U;
+    }
+    else {
+        (void)memmove(client->tail, &client->tail[sent], client->tail_len - (uint16_t)sent);
+        client->tail_len -= (uint16_t)sent;
+        client->stalls++;
+        if (client->stalls >= WEBSERVER_EVENTS_STALL_LIMIT) {
+            ESP_LOGW(WEBSERVER_EVENTS_TAG, "Dropping stalled client %d", client->fd);
+            events_drop(server, client);
+        }
+    }
+}
+
+/**
+ * @brief Send a message, keeping what the socket did not take.
+ */
+static void events_deliver(httpd_handle_t server, webserver_events_client_t *client, const webserver_events_message_t *msg)
+{
+    int sent = events_send(server, client, msg->data, msg->len);
+
+    if (sent < 0) {
+        events_drop(server, client);
+    }
+    else if ((size_t)sent < msg->len) {
+        client->tail_len = (uint16_t)(msg->len - (size_t)sent);
+        (void)memcpy(client->tail, &msg->data[sent], client->tail_len);
+    }
+    else {
+        /* Whole message sent */
+    }
+}
+
+/**
+ * @brief Push pending state to all clients, runs on the server task.
+ *
+ * Each kind is formatted once and fanned out. A client that still has a
+ * tail to send gets nothing new: its kinds stay pending and are coalesced,
+ * so a slow client skips intermediate states instead of queueing them.
+ */
+static void events_push(void *arg)
+{
+    httpd_handle_t server = atomic_load(&s_events_server);
+    webserver_events_kind_t kinds = 0U;
+    (void)arg;
+
+    atomic_store(&s_events_push_queued, false);
+    kinds = (webserver_events_kind_t)atomic_exchange(&s_events_pending, 0U);
+
+    for (uint8_t i = 0U; i < WEBSERVER_EVENTS_MAX_CLIENTS; i++) {
+        webserver_events_client_t *client = &s_events_clients[i];
+
+        if (client->fd != WEBSERVER_EVENTS_NO_SOCKET) {
+            client->pending |= kinds;
+            if (client->tail_len > 0U) {
+                events_flush_tail(server, client);
+            }
+        }
+    }
+
+    for (webserver_events_kind_t kind = WEBSERVER_EVENTS_TIME; kind <= WEBSERVER_EVENTS_STATUS;
+         kind = (webserver_events_kind_t)(kind << 1)) {
+        bool formatted = false;
+
+        for (uint8_t i = 0U; i < WEBSERVER_EVENTS_MAX_CLIENTS; i++) {
+            webserver_events_client_t *client = &s_events_clients[i];
+
+            if ((client->fd != WEBSERVER_EVENTS_NO_SOCKET) && (client->tail_len == 0U) &&
+                ((client->pending & kind) != 0U)) {
+                if (formatted == false) {
+                    formatted = events_format(kind, &s_events_message);
+                    if (formatted == false) {
+                        break;
+                    }
+                }
+                client->pending &= (webserver_events_kind_t)~kind;
+                events_deliver(server, client, &s_events_message);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Queue a push on the server task, at most one at a time.
+ */
+static void events_schedule(void)
+{
+    httpd_handle_t server = atomic_load(&s_events_server);
+
+    if ((server != NULL) && (atomic_exchange(&s_events_push_queued, true) == false)) {
+        if (httpd_queue_work(server, events_push, NULL) != ESP_OK) {
+            atomic_store(&s_events_push_queued, false);
+        }
+    }
+}
+
+/**
+ * @brief Handles GET /api/events, a Server-Sent Events stream.
+ *
+ * The socket is kept by the module and written from events_push(). The
+ * first push sends the full state, later ones only what changed.
+ *
+ * @param req Pointer to the HTTP request structure.
+ *
+ * @return ESP_OK, or ESP_FAIL if the headers could not be sent.
+ */
+static esp_err_t events_handler(httpd_req_t *req)
+{
+    webserver_events_client_t *client = NULL;
+    esp_err_t ret = ESP_OK;
+
+    for (uint8_t i = 0U; (client == NULL) && (i < WEBSERVER_EVENTS_MAX_CLIENTS); i++) {
+        if (s_events_clients[i].fd == WEBSERVER_EVENTS_NO_SOCKET) {
+            client = &s_events_clients[i];
+        }
+    }
+
+    if (client == NULL) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_set_hdr(req, "Retry-After", "10");
+        ret = httpd_resp_send(req, "Too many event clients", HTTPD_RESP_USE_STRLEN);
+    }
+    else if (httpd_send(req, WEBSERVER_EVENTS_HEADERS, sizeof(WEBSERVER_EVENTS_HEADERS) - 1U) !=
+             (int)(sizeof(WEBSERVER_EVENTS_HEADERS) - 1U)) {
+        ret = ESP_FAIL;
+    }
+    else {
+        client->fd = httpd_req_to_sockfd(req);
+        client->pending = WEBSERVER_EVENTS_ALL;
+        client->stalls = 0U;
+        client->tail_len = 0U;
+        (void)atomic_fetch_add(&s_events_client_count, 1U);
+        events_schedule();
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Registers the event stream handler ("/api/events").
+ *
+ * @param server Running HTTP server.
+ *
+ * @return ESP_OK if the handler was registered.
+ */
+esp_err_t webserver_events_register(httpd_handle_t server)
+{
+    httpd_uri_t events = {
+        .uri       = "/api/events",
+        .method    = HTTP_GET,
+        .handler   = events_handler,
+        .user_ctx  = NULL
+    };
+
+    for (uint8_t i = 0U; i < WEBSERVER_EVENTS_MAX_CLIENTS; i++) {
+        s_events_clients[i].fd = WEBSERVER_EVENTS_NO_SOCKET;
+    }
+    atomic_store(&s_events_server, server);
+
+    return httpd_register_uri_handler(server, &events);
+}
+
+/**
+ * @brief Forget a client whose socket is closing.
+ *
+ * Called from the server close callback, on the server task.
+ *
+ * @param sockfd Closing socket.
+ */
+void webserver_events_on_close(int sockfd)
+{
+    for (uint8_t i = 0U; i < WEBSERVER_EVENTS_MAX_CLIENTS; i++) {
+        if (s_events_clients[i].fd == sockfd) {
+            s_events_clients[i].fd = WEBSERVER_EVENTS_NO_SOCKET;
+            (void)atomic_fetch_sub(&s_events_client_count, 1U);
+        }
+    }
+}
+
+/**
+ * @brief Mark state as changed and push it to the connected clients.
+ *
+ * Safe from any task. Nothing is queued while no client is connected.
+ *
+ * @param kinds WEBSERVER_EVENTS_* bits.
+ */
+void webserver_events_notify(webserver_events_kind_t kinds)
+{
+    if (atomic_load(&s_events_client_count) > 0U) {
+        (void)atomic_fetch_or(&s_events_pending, kinds);
+        events_schedule();
+    }
+}
+
+/**
+ * @brief EVT_TIMER_CLOCK_TICK subscriber: pushes the time, and the
+ *        status every WEBSERVER_EVENTS_STATUS_PERIOD_S seconds.
+ */
+void webserver_events_tick_callback(uint8_t* payload, uint16_t size)
+{
+    webserver_events_kind_t kinds = WEBSERVER_EVENTS_TIME;
+    evt_timer_tick_t tick;
+
+    if (evt_timer_tick_unpack(payload, size, &tick) == true) {
+        s_events_status_ticks += tick.ticks;
+    }
+    if (s_events_status_ticks >= WEBSERVER_EVENTS_STATUS_PERIOD_S) {
+        s_events_status_ticks = 0U;
+        kinds |= WEBSERVER_EVENTS_STATUS;
+    }
+    webserver_events_notify(kinds);
+}
+
+/**
+ * @brief Subscriber for events that change the time shown, such as the
+ *        rotary encoder menu.
+ */
+void webserver_events_time_callback(uint8_t* payload, uint16_t size)
+{
+    (void)payload;
+    (void)size;
+    webserver_events_notify(WEBSERVER_EVENTS_TIME);
+}
+
+/**
+ * @brief Subscriber for configuration change events.
+ *
+ * Only pushes the configuration. A time set from the web is applied by a
+ * pool handler that may not have run yet, the next tick pushes it.
+ */
+void webserver_events_config_callback(uint8_t* payload, uint16_t size)
+{
+    (void)payload;
+    (void)size;
+    webserver_events_notify(WEBSERVER_EVENTS_CONFIG);
+}
+
+/**
+ * @brief EVT_CLOCK_NTP_CONFIG subscriber: time received from NTP.
+ */
+void webserver_events_ntp_callback(uint8_t* payload, uint16_t size)
+{
+    (void)payload;
+    (void)size;
+    webserver_events_notify(WEBSERVER_EVENTS_TIME | WEBSERVER_EVENTS_STATUS);
+}
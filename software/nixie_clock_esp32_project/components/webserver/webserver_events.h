@@ -0,0 +1,45 @@
+#ifndef WEBSERVER_EVENTS_H
+#define WEBSERVER_EVENTS_H
+
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#include <stdint.h>
+#include "esp_http_server.h"
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+#define WEBSERVER_EVENTS_MAX_CLIENTS     (3U)    /* Each client holds a server socket */
+
+/* Kinds of pushed state, a client only ever gets the latest of each */
+typedef uint8_t webserver_events_kind_t;
+#define WEBSERVER_EVENTS_TIME            ((webserver_events_kind_t)0x01U)
+#define WEBSERVER_EVENTS_CONFIG          ((webserver_events_kind_t)0x02U)
+#define WEBSERVER_EVENTS_STATUS          ((webserver_events_kind_t)0x04U)
+#define WEBSERVER_EVENTS_ALL             ((webserver_events_kind_t)0x07U)
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+
+/******************************************************************
+ * 6. Functions definitions (public API in .c)
+******************************************************************/
+esp_err_t webserver_events_register(httpd_handle_t server);
+void webserver_events_on_close(int sockfd);
+void webserver_events_notify(webserver_events_kind_t kinds);
+void webserver_events_tick_callback(uint8_t* payload, uint16_t size);
+void webserver_events_time_callback(uint8_t* payload, uint16_t size);
+void webserver_events_config_callback(uint8_t* payload, uint16_t size);
+void webserver_events_ntp_callback(uint8_t* payload, uint16_t size);
+
+#endif // WEBSERVER_EVENTS_H
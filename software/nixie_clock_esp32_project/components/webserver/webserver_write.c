@@ -0,0 +1,270 @@
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#ifdef STATIC_ANALYSIS
+#include "../test/common/esp_stub.h"
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "webserver_write.h"
+#include "webserver_events.h"
+#include "../metrics/metrics.h"
+#include "../rate_limiter/rate_limiter.h"
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+/* Each client: 4 changes at once, then one every 2 s */
+#define WEBSERVER_WRITE_CLIENT_BURST     (4U)
+#define WEBSERVER_WRITE_CLIENT_PERIOD_MS (2000U)
+/* All clients together: 8 changes at once, then one per second */
+#define WEBSERVER_WRITE_GLOBAL_BURST     (8U)
+#define WEBSERVER_WRITE_GLOBAL_PERIOD_MS (1000U)
+/* Changes accepted within this window after an apply are merged into one */
+#define WEBSERVER_WRITE_MERGE_MS         (500U)
+#define WEBSERVER_WRITE_RETRY_AFTER_SIZE (12U)
+#define WEBSERVER_WRITE_TAG              "WEBSERVER_WRITE"
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+/* Only used by the httpd task, which runs one handler at a time */
+static rate_limiter_t s_write_limiter;
+static char s_write_retry_after[WEBSERVER_WRITE_RETRY_AFTER_SIZE];
+
+/* Merge window, also only used by the httpd task: the timer queues work on it */
+static httpd_handle_t s_write_server = NULL;
+static esp_timer_handle_t s_write_timer = NULL;
+static bool s_write_window_open = false;     /* An apply happened less than WEBSERVER_WRITE_MERGE_MS ago */
+static bool s_write_pending = false;         /* A change waits for the end of the window */
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+static uint32_t write_now_ms(void);
+static uint32_t write_client_key(httpd_req_t *req);
+static void write_apply_now(void);
+static void write_window_end(void *arg);
+static void write_window_work(void *arg);
+
+/******************************************************************
+ * 6. Functions definitions
+******************************************************************/
+
+static uint32_t write_now_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000LL);
+}
+
+/**
+ * @brief Identify the client of a request by its address.
+ *
+ * IPv4 clients, mapped or not, are keyed by their address, IPv6 ones by
+ * a fold of theirs. Unknown peers share key 0.
+ */
+static uint32_t write_client_key(httpd_req_t *req)
+{
+    struct sockaddr_storage addr;
+    socklen_t addr_len = sizeof(addr);
+    uint32_t key = 0U;
+
+    (void)memset(&addr, 0, sizeof(addr));
+    if (getpeername(httpd_req_to_sockfd(req), (struct sockaddr *)&addr, &addr_len) == 0) {
+        if (addr.ss_family == AF_INET) {
+            key = ((struct sockaddr_in *)&addr)->sin_addr.s_addr;
+        }
+        else if (addr.ss_family == AF_INET6) {
+            uint32_t words[4];
+            (void)memcpy(words, &((struct sockaddr_in6 *)&addr)->sin6_addr, sizeof(words));
+            /* Mapped IPv4 addresses end with the IPv4 address, fold the rest on it */
+            key = (words[0] ^ words[1]) ^ ((words[2] == htonl(0x0000FFFFUL)) ? 0U : words[2]) ^ words[3];
+        }
+        else {
+            /* Unknown family, shared key */
+        }
+    }
+
+    return key;
+}
+
+/**
+ * @brief Apply the configuration in RAM: change events and write-behind.
+ */
+static void write_apply_now(void)
+{
+    (void)config_save();
+    webserver_events_notify(WEBSERVER_EVENTS_CONFIG);
+    metrics_inc(METRICS_CONFIG_APPLIES);
+}
+
+/**
+ * @brief End of the merge window, runs in the esp_timer task.
+ *
+ * Only hands the window over to the httpd task: config_save() waits for
+ * the config mutex and publishes events, which would hold every other
+ * esp_timer callback back. If the work queue is full, the changes stay
+ * pending for one more window.
+ */
+static void write_window_end(void *arg)
+{
+    (void)arg;
+
+    if (httpd_queue_work(s_write_server, write_window_work, NULL) != ESP_OK) {
+        ESP_LOGW(WEBSERVER_WRITE_TAG, "Failed to queue merged apply, retrying");
+        (void)esp_timer_start_once(s_write_timer, (uint64_t)WEBSERVER_WRITE_MERGE_MS * 1000U);
+    }
+}
+
+/**
+ * @brief End of the merge window, runs in the httpd task.
+ *
+ * Applies the changes merged during the window, which opens a new one,
+ * so a steady stream of writes is applied once per window.
+ */
+static void write_window_work(void *arg)
+{
+    bool apply = s_write_pending;
+    (void)arg;
+
+    s_write_pending = false;
+    s_write_window_open = apply;
+
+    if (apply == true) {
+        write_apply_now();
+        if (esp_timer_start_once(s_write_timer, (uint64_t)WEBSERVER_WRITE_MERGE_MS * 1000U) != ESP_OK) {
+            s_write_window_open = false;
+        }
+    }
+}
+
+/**
+ * @brief Create the merge timer and fill the rate limiter buckets.
+ *
+ * @param server Running HTTP server, merged changes are applied on its task.
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG without a server, or the
+ *         esp_timer error.
+ */
+esp_err_t webserver_write_init(httpd_handle_t server)
+{
+    const rate_limiter_rate_t client_rate = {
+        .burst = WEBSERVER_WRITE_CLIENT_BURST,
+        .period_ms = WEBSERVER_WRITE_CLIENT_PERIOD_MS,
+    };
+    const rate_limiter_rate_t global_rate = {
+        .burst = WEBSERVER_WRITE_GLOBAL_BURST,
+        .period_ms = WEBSERVER_WRITE_GLOBAL_PERIOD_MS,
+    };
+    esp_err_t ret = ESP_OK;
+
+    rate_limiter_init(&s_write_limiter, &client_rate, &global_rate, write_now_ms());
+    s_write_server = server;
+
+    if (server == NULL) {
+        ret = ESP_ERR_INVALID_ARG;
+    }
+    else if (s_write_timer == NULL) {
+        const esp_timer_create_args_t args = {
+            .callback = write_window_end,
+            .arg = NULL,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "config_write",
+        };
+        ret = esp_timer_create(&args, &s_write_timer);
+        if (ret != ESP_OK) {
+            ESP_LOGE(WEBSERVER_WRITE_TAG, "Failed to create merge timer: %s", esp_err_to_name(ret));
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Rate limit a configuration write, before its body is read.
+ *
+ * Takes a token from the bucket of the client and from the global one.
+ * When either is empty the request is refused: the Retry-After header is
+ * set and the caller must answer WEBSERVER_WRITE_LIMITED_STATUS in its
+ * own format, without touching the configuration.
+ *
+ * @param req HTTP request, only called from the httpd task.
+ *
+ * @return true if the write may proceed.
+ */
+bool webserver_write_admit(httpd_req_t *req)
+{
+    uint32_t retry_ms = 0U;
+    rate_limiter_result_t result = rate_limiter_take(&s_write_limiter, write_client_key(req), write_now_ms(), &retry_ms);
+
+    if (result == RATE_LIMITER_LIMITED_CLIENT) {
+        metrics_inc(METRICS_CONFIG_WRITES_LIMITED_CLIENT);
+    }
+    else if (result == RATE_LIMITER_LIMITED_GLOBAL) {
+        metrics_inc(METRICS_CONFIG_WRITES_LIMITED_GLOBAL);
+    }
+    else {
+        metrics_inc(METRICS_CONFIG_WRITES);
+    }
+
+    if (result != RATE_LIMITER_ALLOWED) {
+        /* Whole seconds, rounded up */
+        (void)snprintf(s_write_retry_after, sizeof(s_write_retry_after), "%lu",
+                       (unsigned long)((retry_ms + 999U) / 1000U));
+        httpd_resp_set_hdr(req, "Retry-After", s_write_retry_after);
+        ESP_LOGW(WEBSERVER_WRITE_TAG, "Configuration write refused, %s limit",
+                 (result == RATE_LIMITER_LIMITED_CLIENT) ? "client" : "global");
+    }
+
+    return (result == RATE_LIMITER_ALLOWED);
+}
+
+/**
+ * @brief Store an admitted configuration and apply it, merging bursts.
+ *
+ * The configuration in RAM is updated at once, so readers see it. The
+ * first change is applied immediately; changes arriving less than
+ * WEBSERVER_WRITE_MERGE_MS after an apply only mark it pending, and are
+ * applied together when the window ends. However long a burst, its change
+ * events are published at most once per window, and NVS is still written
+ * behind.
+ *
+ * @param config New configuration.
+ *
+ * @return ESP_OK if the configuration was stored, ESP_FAIL otherwise.
+ */
+esp_err_t webserver_write_apply(const config_t *config)
+{
+    esp_err_t ret = config_set_config(config);
+    bool apply = false;
+
+    if (ret == ESP_OK) {
+        if (s_write_window_open == true) {
+            s_write_pending = true;
+        }
+        else {
+            s_write_window_open = (s_write_timer != NULL);
+            apply = true;
+        }
+
+        if (apply == false) {
+            metrics_inc(METRICS_CONFIG_WRITES_MERGED);
+        }
+        else {
+            write_apply_now();
+            if ((s_write_timer != NULL) &&
+                (esp_timer_start_once(s_write_timer, (uint64_t)WEBSERVER_WRITE_MERGE_MS * 1000U) != ESP_OK)) {
+                s_write_window_open = false;
+            }
+        }
+    }
+
+    return ret;
+}
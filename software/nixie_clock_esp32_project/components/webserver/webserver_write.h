@@ -0,0 +1,35 @@
+#ifndef WEBSERVER_WRITE_H
+#define WEBSERVER_WRITE_H
+
+/******************************************************************
+ * 1. Included files (microcontroller ones then user defined ones)
+******************************************************************/
+#include <stdbool.h>
+#include "esp_http_server.h"
+#include "config.h"
+
+/******************************************************************
+ * 2. Define declarations (macros then function macros)
+******************************************************************/
+#define WEBSERVER_WRITE_LIMITED_STATUS   "429 Too Many Requests"
+
+/******************************************************************
+ * 3. Typedef definitions (simple typedef, then enum and structs)
+******************************************************************/
+
+/******************************************************************
+ * 4. Variable definitions (static then global)
+******************************************************************/
+
+/******************************************************************
+ * 5. Functions prototypes (static only)
+******************************************************************/
+
+/******************************************************************
+ * 6. Functions definitions (public API in .c)
+******************************************************************/
+esp_err_t webserver_write_init(httpd_handle_t server);
+bool webserver_write_admit(httpd_req_t *req);
+esp_err_t webserver_write_apply(const config_t *config);
+
+#endif // WEBSERVER_WRITE_H
@@ -0,0 +1,33 @@
+const ntpCheckbox = document.getElementById('ntp');
+const hourInputs = [document.getElementById('hours'), document.getElementById('minutes'), document.getElementById('seconds')];
+function updateTimeInputs() {
+  const disabled = ntpCheckbox.checked;
+  hourInputs.forEach(input => { input.disabled = disabled; });
+}
+updateTimeInputs();
+ntpCheckbox.addEventListener('change', updateTimeInputs);
+const brightnessSlider = document.getElementById('dutycycle');
+const brightnessValue = document.getElementById('brightnessValue');
+brightnessValue.textContent = brightnessSlider.value;
+brightnessSlider.addEventListener('input', () => { brightnessValue.textContent = brightnessSlider.value; });
+// Live state pushed by the clock, fields being edited are left alone
+function setField(id, value) {
+  const input = document.getElementById(id);
+  if (input && input !== document.activeElement) {
+    if (input.type === 'checkbox') { input.checked = value; } else { input.value = value; }
+  }
+}
+if (window.EventSource) {
+  const events = new EventSource('/api/events');
+  events.addEventListener('time', e => {
+    const t = JSON.parse(e.data);
+    setField('hours', t.hours); setField('minutes', t.minutes); setField('seconds', t.seconds);
+  });
+  events.addEventListener('config', e => {
+    const c = JSON.parse(e.data);
+    setField('ntp', c.ntp); setField('ssid', c.ssid); setField('dutycycle', c.dutycycle);
+    document.querySelectorAll('input[name="mode"]').forEach(r => { r.checked = (Number(r.value) === c.mode); });
+    updateTimeInputs();
+    brightnessValue.textContent = brightnessSlider.value;
+  });
+}
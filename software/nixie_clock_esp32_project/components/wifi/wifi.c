@@ -10,7 +10,11 @@
 #include "esp_event.h"
 #include "esp_log.h"
 #include "esp_netif.h"
+#if CONFIG_ETH_USE_OPENETH
+#include "esp_eth.h"
+#endif
 #include "../config/config.h"
+#include "../metrics/metrics.h"
 
 /******************************************************************
  * 2. Define declarations (macros then function macros)
@@ -61,6 +65,7 @@ static void wifi_event_handler(void* arg, esp_event_base_t event_base,
         ESP_LOGI(WIFI_TAG, "Wi‑Fi STA started, connecting...");
         esp_wifi_connect();
     } else if ((event_base == WIFI_EVENT) && (event_id == WIFI_EVENT_STA_DISCONNECTED)) {
+        metrics_inc(METRICS_WIFI_DISCONNECTS);
         if (wifi_sta_cfg_update_pending == true) {
             config_t config;
             esp_err_t cfg_ret;
@@ -81,6 +86,7 @@ static void wifi_event_handler(void* arg, esp_event_base_t event_base,
             /* Regular disconnect handling */
             if (wifi_sta_retry_count < WIFI_MAX_RETRY) {
                 esp_wifi_connect();
+                metrics_inc(METRICS_WIFI_RECONNECTS);
                 wifi_sta_retry_count++;
                 ESP_LOGI(WIFI_TAG, "Wi-Fi STA disconnected, retrying connection (%d/%d)",
                         wifi_sta_retry_count, WIFI_MAX_RETRY);
@@ -230,6 +236,56 @@ static void wifi_init_apsta(const char *sta_ssid, const char *sta_password,
     }
 }
 
+#if CONFIG_ETH_USE_OPENETH
+/**
+ * @brief Initializes the emulated Ethernet of QEMU instead of Wi-Fi
+ *
+ * QEMU emulates no radio but an OpenCores Ethernet MAC, whose user
+ * network answers DHCP. Only built with sdkconfig.qemu, see
+ * tools/ota_qemu_test.py.
+ */
+static void wifi_init_openeth(void)
+{
+    esp_err_t ret = ESP_OK;
+    esp_netif_config_t netif_cfg = ESP_NETIF_DEFAULT_ETH();
+    esp_netif_t *netif = NULL;
+    esp_eth_handle_t eth = NULL;
+
+    ret = esp_netif_init();
+    if (ret == ESP_OK) {
+        ret = esp_event_loop_create_default();
+        if (ret == ESP_ERR_INVALID_STATE) {
+            ret = ESP_OK;
+        }
+    }
+
+    if (ret == ESP_OK) {
+        netif = esp_netif_new(&netif_cfg);
+        ret = (netif != NULL) ? ESP_OK : ESP_FAIL;
+    }
+
+    if (ret == ESP_OK) {
+        eth_mac_config_t mac_cfg = ETH_MAC_DEFAULT_CONFIG();
+        eth_phy_config_t phy_cfg = ETH_PHY_DEFAULT_CONFIG();
+        phy_cfg.autonego_timeout_ms = 100;
+        esp_eth_config_t eth_cfg = ETH_DEFAULT_CONFIG(esp_eth_mac_new_openeth(&mac_cfg),
+                                                      esp_eth_phy_new_dp83848(&phy_cfg));
+        ret = esp_eth_driver_install(&eth_cfg, &eth);
+    }
+
+    if (ret == ESP_OK) {
+        ret = esp_netif_attach(netif, esp_eth_new_netif_glue(eth));
+    }
+    if (ret == ESP_OK) {
+        ret = esp_eth_start(eth);
+    }
+
+    if (ret != ESP_OK) {
+        ESP_LOGE(WIFI_TAG, "OpenETH start failed: %s", esp_err_to_name(ret));
+    }
+}
+#endif
+
 /**
  * @brief Change the STA Wi-Fi credentials and reconnect.
  *
@@ -279,7 +335,7 @@ static esp_err_t wifi_change_sta(const char* sta_ssid, const char* sta_passphras
  *
  * @note Logs an error if updating the STA Wi-Fi fails.
  */
-void wifi_callback(uint8_t* payload, uint8_t size) {
+void wifi_callback(uint8_t* payload, uint16_t size) {
     (void)payload;
     (void)size;
     config_t config;
@@ -290,7 +346,11 @@ void wifi_callback(uint8_t* payload, uint8_t size) {
     if (cfg_ret == ESP_OK) {
         static bool wifi_initialized = false;
         if (wifi_initialized == false) {
+#if CONFIG_ETH_USE_OPENETH
+            wifi_init_openeth();
+#else
             wifi_init_apsta(config.ssid, config.wpa_passphrase, WIFI_AP_SSID, WIFI_AP_PASSWORD);
+#endif
             wifi_initialized = true;
         } else {
             wifi_sta_retry_count = 0U;
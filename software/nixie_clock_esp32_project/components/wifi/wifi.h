@@ -27,6 +27,6 @@
 /******************************************************************
  * 6. Functions definitions
 ******************************************************************/
-void wifi_callback(uint8_t* payload, uint8_t size);
+void wifi_callback(uint8_t* payload, uint16_t size);
 
 #endif // WIFI_H
\ No newline at end of file
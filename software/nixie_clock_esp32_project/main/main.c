@@ -12,6 +12,7 @@
 #include "../components/display/display.h"
 #include "../components/clock/clock.h"
 #include "../components/webserver/webserver.h"
+#include "../components/webserver/webserver_events.h"
 #include "../components/config/config.h"
 #include "../components/pwm/pwm.h"
 #include "../components/dispatcher_task/dispatcher_task.h"
@@ -19,11 +20,15 @@
 #include "../components/wifi/wifi.h"
 #include "../components/clock_task/clock_task.h"
 #include "../components/gpio_task/gpio_task.h"
+#include "../components/timer_service/timer_service.h"
+#include "../components/ota/ota.h"
 
 /******************************************************************
  * 2. Define declarations (macros then function macros)
 ******************************************************************/
 #define MAIN_TASK_WDT_TIMEOUT_MS     5000U
+#define MAIN_EVENT_BUS_STATS_PERIOD_S  300U
+#define MAIN_OTA_HEALTH_CHECK_S      10U    /* Uptime before a new image is judged */
 
 /******************************************************************
  * 3. Typedef definitions (simple typedef, then enum and structs)
@@ -62,12 +67,28 @@ void app_main(void)
     esp_task_wdt_add(NULL);
 
     event_bus_init();
-    dispatcher_subscribe(EVT_NTP_CONFIG, ntp_callback);
-    dispatcher_subscribe(EVT_WIFI_CONFIG, wifi_callback);
-    dispatcher_subscribe(EVT_PWM_CONFIG, pwm_callback);
-    dispatcher_subscribe(EVT_CLOCK_NTP_CONFIG, clock_ntp_config_callback);
-    dispatcher_subscribe(EVT_CLOCK_GPIO_CONFIG, clock_update_with_menu_callback);
-    dispatcher_subscribe(EVT_CLOCK_WEB_CONFIG, clock_update_from_config_callback);
+    if (timer_service_init() != ESP_OK) {
+        ESP_LOGE(MAIN_TAG, "Timer service init failed");
+    }
+    /* Blocking handlers get their own task, user input stays on the dispatcher */
+    dispatcher_subscribe(EVT_NTP_CONFIG, ntp_callback, DISPATCHER_CONTEXT_DEDICATED);
+    dispatcher_subscribe(EVT_WIFI_CONFIG, wifi_callback, DISPATCHER_CONTEXT_DEDICATED);
+    dispatcher_subscribe(EVT_PWM_CONFIG, pwm_callback, DISPATCHER_CONTEXT_POOL);
+    dispatcher_subscribe(EVT_CONFIG_PERSIST, config_persist_callback, DISPATCHER_CONTEXT_POOL);
+    dispatcher_subscribe(EVT_CLOCK_NTP_CONFIG, clock_ntp_config_callback, DISPATCHER_CONTEXT_INLINE);
+    dispatcher_subscribe(EVT_CLOCK_GPIO_CONFIG, clock_update_with_menu_callback, DISPATCHER_CONTEXT_INLINE);
+    dispatcher_subscribe(EVT_CLOCK_WEB_CONFIG, clock_update_from_config_callback, DISPATCHER_CONTEXT_POOL);
+    dispatcher_subscribe(EVT_TIMER_CLOCK_TICK, clock_tick_callback, DISPATCHER_CONTEXT_INLINE);
+    dispatcher_subscribe(EVT_TIMER_DISPLAY, clock_display_callback, DISPATCHER_CONTEXT_INLINE);
+    /* Live web UI. Tick, encoder and NTP pushes run inline after the clock
+     * handlers so they see the updated time, config pushes do not carry it */
+    dispatcher_subscribe(EVT_TIMER_CLOCK_TICK, webserver_events_tick_callback, DISPATCHER_CONTEXT_INLINE);
+    dispatcher_subscribe(EVT_CLOCK_GPIO_CONFIG, webserver_events_time_callback, DISPATCHER_CONTEXT_INLINE);
+    dispatcher_subscribe(EVT_CLOCK_NTP_CONFIG, webserver_events_ntp_callback, DISPATCHER_CONTEXT_INLINE);
+    dispatcher_subscribe(EVT_CLOCK_WEB_CONFIG, webserver_events_config_callback, DISPATCHER_CONTEXT_INLINE);
+    dispatcher_subscribe(EVT_NTP_CONFIG, webserver_events_config_callback, DISPATCHER_CONTEXT_INLINE);
+    dispatcher_subscribe(EVT_WIFI_CONFIG, webserver_events_config_callback, DISPATCHER_CONTEXT_INLINE);
+    dispatcher_subscribe(EVT_PWM_CONFIG, webserver_events_config_callback, DISPATCHER_CONTEXT_INLINE);
 
     pwm_init();
     dispatcher_task_start();
@@ -77,14 +98,43 @@ void app_main(void)
         ESP_LOGE(MAIN_TAG, "Config init failed");
     }
 
-    start_webserver();
+    httpd_handle_t server = start_webserver();
     display_init();
     clock_task_start();
     gpio_task_start();
 
+    /* A new image is kept only if it starts and keeps the clock running */
+    bool ota_pending = ota_boot_is_pending();
+    myclock_t clk;
+    clock_get_snapshot(&clk);
+    uint32_t boot_time = clock_pack(&clk);
+    if (ota_pending == true) {
+        ESP_LOGW(MAIN_TAG, "New firmware pending verification");
+        if ((ret != ESP_OK) || (server == NULL)) {
+            (void)ota_boot_confirm(false);
+        }
+    }
+
+    uint32_t seconds = 0U;
+    uint32_t uptime_s = 0U;
     while (ret == ESP_OK) {
         esp_task_wdt_reset();
         vTaskDelay(pdMS_TO_TICKS(1000));
+
+        /* Ticking clock proves the timer service, event bus and dispatcher */
+        uptime_s++;
+        if ((ota_pending == true) && (uptime_s >= MAIN_OTA_HEALTH_CHECK_S)) {
+            clock_get_snapshot(&clk);
+            (void)ota_boot_confirm(clock_pack(&clk) != boot_time);
+            ota_pending = false;
+        }
+
+        /* Periodic event bus report on UART */
+        seconds++;
+        if (seconds >= MAIN_EVENT_BUS_STATS_PERIOD_S) {
+            seconds = 0U;
+            event_bus_stats_log();
+        }
     }
 
     /* Free task */
@@ -82,3 +82,14 @@ void test_clock_decrement_minutes(void) {
     clock_decrement_minutes(&system_clock_ticks);
     TEST_ASSERT_EQUAL_UINT8(59, system_clock_ticks.minutes);
 }
+
+// Test packing round trip
+void test_clock_pack_round_trip(void) {
+    myclock_t unpacked;
+    clock_init(&system_clock_ticks, 23, 59, 58);
+    TEST_ASSERT_EQUAL_HEX32(0x00173B3AU, clock_pack(&system_clock_ticks));
+    clock_unpack(clock_pack(&system_clock_ticks), &unpacked);
+    TEST_ASSERT_EQUAL_UINT8(23, unpacked.hours);
+    TEST_ASSERT_EQUAL_UINT8(59, unpacked.minutes);
+    TEST_ASSERT_EQUAL_UINT8(58, unpacked.seconds);
+}
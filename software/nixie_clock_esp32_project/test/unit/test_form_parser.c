@@ -0,0 +1,88 @@
+#include <string.h>
+#include "unity.h"
+#include "form_parser.h"
+
+typedef struct {
+    uint32_t count;
+    char keys[4][FORM_PARSER_KEY_SIZE];
+    char values[4][FORM_PARSER_VALUE_SIZE];
+    form_parser_status_t status[4];
+} pairs_t;
+
+static bool record_pair(void *ctx, const char *key, const char *value, form_parser_status_t status)
+{
+    pairs_t *pairs = (pairs_t *)ctx;
+    if (pairs->count < 4U) {
+        (void)strcpy(pairs->keys[pairs->count], key);
+        (void)strcpy(pairs->values[pairs->count], value);
+        pairs->status[pairs->count] = status;
+    }
+    pairs->count++;
+    return (strcmp(key, "stop") != 0);
+}
+
+static void parse_in_chunks(pairs_t *pairs, const char *body, size_t chunk)
+{
+    form_parser_t parser;
+    size_t len = strlen(body);
+
+    (void)memset(pairs, 0, sizeof(*pairs));
+    form_parser_init(&parser, record_pair, pairs);
+    for (size_t i = 0U; i < len; i += chunk) {
+        (void)form_parser_feed(&parser, &body[i], ((len - i) < chunk) ? (len - i) : chunk);
+    }
+    (void)form_parser_finish(&parser);
+}
+
+// Pairs are decoded the same whatever the chunk boundaries
+void test_form_parser_chunks(void) {
+    static const char body[] = "ssid=my+net%21&&mode=2&wpa-passphrase=a%3Db%26c&ntp";
+    pairs_t pairs;
+
+    for (size_t chunk = 1U; chunk <= sizeof(body); chunk++) {
+        parse_in_chunks(&pairs, body, chunk);
+        TEST_ASSERT_EQUAL_UINT32(4U, pairs.count);
+        TEST_ASSERT_EQUAL_STRING("ssid", pairs.keys[0]);
+        TEST_ASSERT_EQUAL_STRING("my net!", pairs.values[0]);
+        TEST_ASSERT_EQUAL_STRING("2", pairs.values[1]);
+        TEST_ASSERT_EQUAL_STRING("wpa-passphrase", pairs.keys[2]);
+        TEST_ASSERT_EQUAL_STRING("a=b&c", pairs.values[2]);
+        TEST_ASSERT_EQUAL_STRING("ntp", pairs.keys[3]);
+        TEST_ASSERT_EQUAL_STRING("", pairs.values[3]);
+        TEST_ASSERT_EQUAL_UINT8(FORM_PARSER_OK, pairs.status[0]);
+    }
+}
+
+// Malformed escapes are kept, long values are truncated, both are flagged
+void test_form_parser_warnings(void) {
+    char body[2U * FORM_PARSER_VALUE_SIZE];
+    pairs_t pairs;
+
+    parse_in_chunks(&pairs, "a=%zz&b=50%&c=%4", 3U);
+    TEST_ASSERT_EQUAL_UINT32(3U, pairs.count);
+    TEST_ASSERT_EQUAL_STRING("%zz", pairs.values[0]);
+    TEST_ASSERT_EQUAL_UINT8(FORM_PARSER_WARN_INVALID_SEQ, pairs.status[0]);
+    TEST_ASSERT_EQUAL_STRING("50%", pairs.values[1]);
+    TEST_ASSERT_EQUAL_STRING("%4", pairs.values[2]);
+    TEST_ASSERT_EQUAL_UINT8(FORM_PARSER_WARN_INVALID_SEQ, pairs.status[2]);
+
+    (void)memset(body, 'x', sizeof(body));
+    (void)memcpy(body, "v=", 2U);
+    body[sizeof(body) - 1U] = '\0';
+    parse_in_chunks(&pairs, body, 16U);
+    TEST_ASSERT_EQUAL_UINT32(1U, pairs.count);
+    TEST_ASSERT_EQUAL_UINT32(FORM_PARSER_VALUE_SIZE - 1U, strlen(pairs.values[0]));
+    TEST_ASSERT_EQUAL_UINT8(FORM_PARSER_WARN_TRUNCATED, pairs.status[0]);
+}
+
+// The callback can stop the parsing
+void test_form_parser_abort(void) {
+    static const char body[] = "a=1&stop=1&b=2";
+    form_parser_t parser;
+    pairs_t pairs = { 0 };
+
+    form_parser_init(&parser, record_pair, &pairs);
+    TEST_ASSERT_FALSE(form_parser_feed(&parser, body, strlen(body)));
+    TEST_ASSERT_FALSE(form_parser_finish(&parser));
+    TEST_ASSERT_EQUAL_UINT32(2U, pairs.count);
+}
@@ -0,0 +1,130 @@
+#include <string.h>
+#include "unity.h"
+#include "json_stream.h"
+
+static char out[128];
+static size_t out_len;
+static uint32_t flush_count;
+
+static bool collect(void *ctx, const char *data, size_t len)
+{
+    (void)ctx;
+    bool fits = (out_len + len) < sizeof(out);
+    if (fits == true) {
+        (void)memcpy(&out[out_len], data, len);
+        out_len += len;
+        out[out_len] = '\0';
+    }
+    flush_count++;
+    return fits;
+}
+
+typedef struct {
+    uint32_t count;
+    char keys[4][16];
+    json_value_t values[4];
+} members_t;
+
+static bool record_member(void *ctx, const char *key, const json_value_t *value)
+{
+    members_t *m = (members_t *)ctx;
+    if (m->count < 4U) {
+        (void)strncpy(m->keys[m->count], key, sizeof(m->keys[0]) - 1U);
+        m->values[m->count] = *value;
+    }
+    m->count++;
+    return (strcmp(key, "stop") != 0);
+}
+
+// Writer streams through a tiny buffer with commas and escaping
+void test_json_writer_document(void) {
+    char buf[8];
+    json_writer_t w;
+    out_len = 0U;
+    flush_count = 0U;
+
+    json_writer_init(&w, buf, sizeof(buf), collect, NULL);
+    json_object_begin(&w);
+    json_key(&w, "name");
+    json_string(&w, "a\"b\\c\n\x01");
+    json_key(&w, "n");
+    json_int(&w, -42);
+    json_key(&w, "list");
+    json_array_begin(&w);
+    json_uint(&w, 7UL);
+    json_bool(&w, true);
+    json_null(&w);
+    json_array_end(&w);
+    json_object_end(&w);
+
+    TEST_ASSERT_TRUE(json_writer_finish(&w));
+    TEST_ASSERT_EQUAL_STRING("{\"name\":\"a\\\"b\\\\c\\n\\u0001\",\"n\":-42,\"list\":[7,true,null]}", out);
+    TEST_ASSERT_TRUE(flush_count > 1U);
+}
+
+// Unbalanced documents and failed flushes are reported
+void test_json_writer_errors(void) {
+    char buf[8];
+    json_writer_t w;
+    out_len = 0U;
+
+    json_writer_init(&w, buf, sizeof(buf), collect, NULL);
+    json_object_begin(&w);
+    TEST_ASSERT_FALSE(json_writer_finish(&w));
+
+    json_writer_init(&w, buf, sizeof(buf), collect, NULL);
+    json_object_end(&w);
+    TEST_ASSERT_FALSE(json_writer_finish(&w));
+
+    out_len = sizeof(out) - 1U;
+    json_writer_init(&w, buf, sizeof(buf), collect, NULL);
+    json_string(&w, "does not fit");
+    TEST_ASSERT_FALSE(json_writer_finish(&w));
+}
+
+// Flat object members are decoded in place
+void test_json_parse_members(void) {
+    char doc[] = " { \"ssid\" : \"caf\\u00e9\\\"\", \"mode\":2, \"neg\":-5, \"on\":false } ";
+    members_t m = { 0 };
+
+    TEST_ASSERT_EQUAL_UINT8(JSON_OK, json_parse_object(doc, strlen(doc), record_member, &m));
+    TEST_ASSERT_EQUAL_UINT32(4U, m.count);
+    TEST_ASSERT_EQUAL_STRING("ssid", m.keys[0]);
+    TEST_ASSERT_EQUAL_UINT8(JSON_VALUE_STRING, m.values[0].type);
+    TEST_ASSERT_EQUAL_STRING("caf\xc3\xa9\"", m.values[0].str);
+    TEST_ASSERT_EQUAL_UINT8(JSON_VALUE_NUMBER, m.values[1].type);
+    TEST_ASSERT_EQUAL_INT32(2, m.values[1].number);
+    TEST_ASSERT_EQUAL_INT32(-5, m.values[2].number);
+    TEST_ASSERT_EQUAL_UINT8(JSON_VALUE_BOOL, m.values[3].type);
+    TEST_ASSERT_FALSE(m.values[3].boolean);
+
+    char empty[] = "{}";
+    m.count = 0U;
+    TEST_ASSERT_EQUAL_UINT8(JSON_OK, json_parse_object(empty, strlen(empty), record_member, &m));
+    TEST_ASSERT_EQUAL_UINT32(0U, m.count);
+}
+
+// Malformed or unsupported input is rejected
+void test_json_parse_errors(void) {
+    members_t m = { 0 };
+    char trailing[] = "{\"a\":1,}";
+    char missing[] = "{\"a\" 1}";
+    char garbage[] = "{\"a\":1} x";
+    char nested[] = "{\"a\":{}}";
+    char fraction[] = "{\"a\":1.5}";
+    char surrogate[] = "{\"a\":\"\\ud83d\"}";
+    char big[] = "{\"a\":99999999999999999999999}";
+    char stop[] = "{\"stop\":1,\"b\":2}";
+
+    TEST_ASSERT_EQUAL_UINT8(JSON_ERR_SYNTAX, json_parse_object(trailing, strlen(trailing), record_member, &m));
+    TEST_ASSERT_EQUAL_UINT8(JSON_ERR_SYNTAX, json_parse_object(missing, strlen(missing), record_member, &m));
+    TEST_ASSERT_EQUAL_UINT8(JSON_ERR_SYNTAX, json_parse_object(garbage, strlen(garbage), record_member, &m));
+    TEST_ASSERT_EQUAL_UINT8(JSON_ERR_UNSUPPORTED, json_parse_object(nested, strlen(nested), record_member, &m));
+    TEST_ASSERT_EQUAL_UINT8(JSON_ERR_UNSUPPORTED, json_parse_object(fraction, strlen(fraction), record_member, &m));
+    TEST_ASSERT_EQUAL_UINT8(JSON_ERR_UNSUPPORTED, json_parse_object(surrogate, strlen(surrogate), record_member, &m));
+    TEST_ASSERT_EQUAL_UINT8(JSON_ERR_RANGE, json_parse_object(big, strlen(big), record_member, &m));
+
+    m.count = 0U;
+    TEST_ASSERT_EQUAL_UINT8(JSON_ERR_ABORTED, json_parse_object(stop, strlen(stop), record_member, &m));
+    TEST_ASSERT_EQUAL_UINT32(1U, m.count);
+}
@@ -0,0 +1,77 @@
+#include "unity.h"
+#include "rate_limiter.h"
+
+static rate_limiter_t limiter;
+
+/* 3 requests at once per client then one per second, 5 then one per 500 ms overall */
+static void reset_limiter(uint32_t now_ms)
+{
+    const rate_limiter_rate_t client_rate = { .burst = 3U, .period_ms = 1000U };
+    const rate_limiter_rate_t global_rate = { .burst = 5U, .period_ms = 500U };
+
+    rate_limiter_init(&limiter, &client_rate, &global_rate, now_ms);
+}
+
+// A burst is allowed, then one request per period, without banking idle time
+void test_rate_limiter_client_burst(void) {
+    uint32_t retry_ms = 0U;
+    reset_limiter(0U);
+
+    for (uint8_t i = 0U; i < 3U; i++) {
+        TEST_ASSERT_EQUAL_UINT8(RATE_LIMITER_ALLOWED, rate_limiter_take(&limiter, 1U, 10U, &retry_ms));
+        TEST_ASSERT_EQUAL_UINT32(0U, retry_ms);
+    }
+    TEST_ASSERT_EQUAL_UINT8(RATE_LIMITER_LIMITED_CLIENT, rate_limiter_take(&limiter, 1U, 400U, &retry_ms));
+    TEST_ASSERT_EQUAL_UINT32(610U, retry_ms);
+
+    /* One token after a period, the remainder of the period is kept */
+    TEST_ASSERT_EQUAL_UINT8(RATE_LIMITER_ALLOWED, rate_limiter_take(&limiter, 1U, 1500U, NULL));
+    TEST_ASSERT_EQUAL_UINT8(RATE_LIMITER_LIMITED_CLIENT, rate_limiter_take(&limiter, 1U, 1600U, &retry_ms));
+    TEST_ASSERT_EQUAL_UINT32(410U, retry_ms);
+
+    /* A long pause refills the burst, not more */
+    for (uint8_t i = 0U; i < 3U; i++) {
+        TEST_ASSERT_EQUAL_UINT8(RATE_LIMITER_ALLOWED, rate_limiter_take(&limiter, 1U, 60000U, NULL));
+    }
+    TEST_ASSERT_EQUAL_UINT8(RATE_LIMITER_LIMITED_CLIENT, rate_limiter_take(&limiter, 1U, 60000U, NULL));
+}
+
+// The global bucket caps all clients together, a limited client does not drain it
+void test_rate_limiter_global(void) {
+    uint32_t retry_ms = 0U;
+    reset_limiter(0U);
+
+    for (uint8_t i = 0U; i < 4U; i++) {
+        (void)rate_limiter_take(&limiter, 1U, 0U, NULL);
+    }
+    TEST_ASSERT_EQUAL_UINT8(RATE_LIMITER_ALLOWED, rate_limiter_take(&limiter, 2U, 0U, NULL));
+    TEST_ASSERT_EQUAL_UINT8(RATE_LIMITER_ALLOWED, rate_limiter_take(&limiter, 2U, 0U, NULL));
+    TEST_ASSERT_EQUAL_UINT8(RATE_LIMITER_LIMITED_GLOBAL, rate_limiter_take(&limiter, 3U, 100U, &retry_ms));
+    TEST_ASSERT_EQUAL_UINT32(400U, retry_ms);
+    TEST_ASSERT_EQUAL_UINT8(RATE_LIMITER_ALLOWED, rate_limiter_take(&limiter, 3U, 500U, NULL));
+}
+
+// Time may wrap, clients beyond the table recycle the least recent slot
+void test_rate_limiter_recycle_and_wrap(void) {
+    const rate_limiter_rate_t client_rate = { .burst = 1U, .period_ms = 1000U };
+    const rate_limiter_rate_t global_rate = { .burst = 20U, .period_ms = 10U };
+    const uint32_t start = 0xFFFFFF00UL;
+    uint32_t retry_ms = 0U;
+
+    rate_limiter_init(&limiter, &client_rate, &global_rate, start);
+    TEST_ASSERT_EQUAL_UINT8(RATE_LIMITER_ALLOWED, rate_limiter_take(&limiter, 100U, start, NULL));
+    TEST_ASSERT_EQUAL_UINT8(RATE_LIMITER_LIMITED_CLIENT, rate_limiter_take(&limiter, 100U, start + 0x200U, &retry_ms));
+    TEST_ASSERT_EQUAL_UINT32(1000U - 0x200U, retry_ms);
+    TEST_ASSERT_EQUAL_UINT8(RATE_LIMITER_ALLOWED, rate_limiter_take(&limiter, 100U, start + 1000U, NULL));
+
+    /* Client 100 is now limited and the least recent of a full table */
+    for (uint32_t key = 0U; key < RATE_LIMITER_MAX_CLIENTS; key++) {
+        TEST_ASSERT_EQUAL_UINT8(RATE_LIMITER_ALLOWED, rate_limiter_take(&limiter, key, start + 1001U + key, NULL));
+    }
+    /* Its slot went to the last client, it comes back with a full bucket */
+    TEST_ASSERT_EQUAL_UINT8(RATE_LIMITER_ALLOWED, rate_limiter_take(&limiter, 100U, start + 1010U, NULL));
+    TEST_ASSERT_EQUAL_UINT8(RATE_LIMITER_LIMITED_CLIENT, rate_limiter_take(&limiter, 100U, start + 1011U, NULL));
+    /* Client 0 was then the least recent and was recycled for it, client 7 was kept */
+    TEST_ASSERT_EQUAL_UINT8(RATE_LIMITER_ALLOWED, rate_limiter_take(&limiter, 0U, start + 1012U, NULL));
+    TEST_ASSERT_EQUAL_UINT8(RATE_LIMITER_LIMITED_CLIENT, rate_limiter_take(&limiter, 7U, start + 1012U, NULL));
+}
@@ -46,4 +46,71 @@ void test_rotary_encoder(void) {
             t->expected, ev, "Rotary encoder test failed"
         );
     }
-}
\ No newline at end of file
+}
+
+// One detent is reported per 4 valid edges, in the direction of rotation
+void test_rotary_encoder_decoder_detents(void) {
+    static const uint8_t cw[] = { 1U, 3U, 2U, 0U };
+    rotary_encoder_decoder_t decoder;
+    rotary_encoder_decoder_init(&decoder, 0U);
+
+    for (uint8_t turn = 0U; turn < 3U; turn++) {
+        for (uint8_t i = 0U; i < 3U; i++) {
+            TEST_ASSERT_EQUAL_INT8(0, rotary_encoder_decode(&decoder, cw[i]));
+        }
+        TEST_ASSERT_EQUAL_INT8(1, rotary_encoder_decode(&decoder, cw[3]));
+    }
+
+    /* Counterclockwise walks the same states backwards */
+    TEST_ASSERT_EQUAL_INT8(0, rotary_encoder_decode(&decoder, 2U));
+    TEST_ASSERT_EQUAL_INT8(0, rotary_encoder_decode(&decoder, 3U));
+    TEST_ASSERT_EQUAL_INT8(0, rotary_encoder_decode(&decoder, 1U));
+    TEST_ASSERT_EQUAL_INT8(-1, rotary_encoder_decode(&decoder, 0U));
+}
+
+// Bounces, repeated levels and invalid jumps never complete a detent
+void test_rotary_encoder_decoder_noise(void) {
+    rotary_encoder_decoder_t decoder;
+    rotary_encoder_decoder_init(&decoder, 0U);
+
+    /* Contact bounce on A: forward then back, repeatedly */
+    for (uint8_t i = 0U; i < 10U; i++) {
+        TEST_ASSERT_EQUAL_INT8(0, rotary_encoder_decode(&decoder, 1U));
+        TEST_ASSERT_EQUAL_INT8(0, rotary_encoder_decode(&decoder, 0U));
+    }
+    TEST_ASSERT_EQUAL_INT8(0, decoder.edges);
+
+    /* Same levels twice and a two-channel jump count as no movement */
+    TEST_ASSERT_EQUAL_INT8(0, rotary_encoder_decode(&decoder, 0U));
+    TEST_ASSERT_EQUAL_INT8(0, rotary_encoder_decode(&decoder, 3U));
+    TEST_ASSERT_EQUAL_INT8(0, decoder.edges);
+}
+
+static const rotary_encoder_accel_point_t test_accel_curve[] = {
+    { 20000U, 5U },
+    { 50000U, 2U },
+};
+
+// Detent steps grow with the rotation speed and reset on a direction change
+void test_rotary_encoder_accel(void) {
+    rotary_encoder_accel_t accel;
+    rotary_encoder_accel_init(&accel, test_accel_curve, 2U);
+
+    /* First detent and slow turns count one step */
+    TEST_ASSERT_EQUAL_UINT8(1U, rotary_encoder_accel_steps(&accel, 1, 1000000));
+    TEST_ASSERT_EQUAL_UINT8(1U, rotary_encoder_accel_steps(&accel, 1, 1200000));
+
+    /* Faster detents climb the curve */
+    TEST_ASSERT_EQUAL_UINT8(2U, rotary_encoder_accel_steps(&accel, 1, 1240000));
+    TEST_ASSERT_EQUAL_UINT8(5U, rotary_encoder_accel_steps(&accel, 1, 1250000));
+    TEST_ASSERT_EQUAL_UINT8(2U, rotary_encoder_accel_steps(&accel, 1, 1270000));
+
+    /* Turning back is never accelerated */
+    TEST_ASSERT_EQUAL_UINT8(1U, rotary_encoder_accel_steps(&accel, -1, 1275000));
+    TEST_ASSERT_EQUAL_UINT8(5U, rotary_encoder_accel_steps(&accel, -1, 1280000));
+
+    /* An empty curve disables acceleration */
+    rotary_encoder_accel_init(&accel, test_accel_curve, 0U);
+    (void)rotary_encoder_accel_steps(&accel, 1, 0);
+    TEST_ASSERT_EQUAL_UINT8(1U, rotary_encoder_accel_steps(&accel, 1, 1000));
+}
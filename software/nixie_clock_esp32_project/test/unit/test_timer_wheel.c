@@ -0,0 +1,140 @@
+#include "unity.h"
+#include "timer_wheel.h"
+
+static timer_wheel_t wheel;
+static uint32_t fired_count;
+static uint32_t fired_user;
+static uint32_t fired_at[8];
+
+static void record_expiry(void *ctx, timer_wheel_id_t id, uint32_t user)
+{
+    (void)ctx;
+    (void)id;
+    if (fired_count < 8U) {
+        fired_at[fired_count] = wheel.now;
+    }
+    fired_user = user;
+    fired_count++;
+}
+
+static void reset_wheel(void)
+{
+    timer_wheel_init(&wheel);
+    fired_count = 0U;
+    fired_user = 0U;
+}
+
+// One-shot timer fires exactly once, on its expiry tick
+void test_timer_wheel_one_shot(void) {
+    reset_wheel();
+    timer_wheel_id_t id = timer_wheel_alloc(&wheel, 42U);
+    TEST_ASSERT_NOT_EQUAL(TIMER_WHEEL_NONE, id);
+    TEST_ASSERT_TRUE(timer_wheel_start(&wheel, id, 5U, 0U));
+
+    TEST_ASSERT_EQUAL_UINT32(0U, timer_wheel_advance(&wheel, 4U, record_expiry, NULL));
+    TEST_ASSERT_EQUAL_UINT32(1U, timer_wheel_advance(&wheel, 1U, record_expiry, NULL));
+    TEST_ASSERT_EQUAL_UINT32(42U, fired_user);
+    TEST_ASSERT_FALSE(timer_wheel_is_active(&wheel, id));
+    TEST_ASSERT_EQUAL_UINT32(0U, timer_wheel_advance(&wheel, 100U, record_expiry, NULL));
+}
+
+// Periodic timer reloads without drift
+void test_timer_wheel_periodic(void) {
+    reset_wheel();
+    timer_wheel_id_t id = timer_wheel_alloc(&wheel, 1U);
+    TEST_ASSERT_TRUE(timer_wheel_start(&wheel, id, 100U, 100U));
+
+    TEST_ASSERT_EQUAL_UINT32(3U, timer_wheel_advance(&wheel, 300U, record_expiry, NULL));
+    TEST_ASSERT_EQUAL_UINT32(100U, fired_at[0]);
+    TEST_ASSERT_EQUAL_UINT32(200U, fired_at[1]);
+    TEST_ASSERT_EQUAL_UINT32(300U, fired_at[2]);
+    TEST_ASSERT_TRUE(timer_wheel_is_active(&wheel, id));
+}
+
+// Long delays cascade from the upper levels and still fire on time
+void test_timer_wheel_cascade(void) {
+    reset_wheel();
+    timer_wheel_id_t near = timer_wheel_alloc(&wheel, 1U);
+    timer_wheel_id_t far = timer_wheel_alloc(&wheel, 2U);
+
+    /* Start off a slot boundary to exercise partial slots */
+    (void)timer_wheel_advance(&wheel, 37U, record_expiry, NULL);
+    TEST_ASSERT_TRUE(timer_wheel_start(&wheel, near, 4095U, 0U));
+    TEST_ASSERT_TRUE(timer_wheel_start(&wheel, far, 70000U, 0U));
+
+    TEST_ASSERT_EQUAL_UINT32(1U, timer_wheel_advance(&wheel, 4095U, record_expiry, NULL));
+    TEST_ASSERT_EQUAL_UINT32(37U + 4095U, fired_at[0]);
+    TEST_ASSERT_EQUAL_UINT32(1U, timer_wheel_advance(&wheel, 70000U - 4095U, record_expiry, NULL));
+    TEST_ASSERT_EQUAL_UINT32(37U + 70000U, fired_at[1]);
+    TEST_ASSERT_EQUAL_UINT32(2U, fired_user);
+}
+
+// Stopped timers never fire, out of range delays are rejected
+void test_timer_wheel_stop_and_limits(void) {
+    reset_wheel();
+    timer_wheel_id_t id = timer_wheel_alloc(&wheel, 7U);
+    TEST_ASSERT_TRUE(timer_wheel_start(&wheel, id, 10U, 0U));
+    timer_wheel_stop(&wheel, id);
+    TEST_ASSERT_EQUAL_UINT32(0U, timer_wheel_advance(&wheel, 20U, record_expiry, NULL));
+
+    TEST_ASSERT_FALSE(timer_wheel_start(&wheel, id, TIMER_WHEEL_MAX_DELAY + 1U, 0U));
+    timer_wheel_free(&wheel, id);
+    TEST_ASSERT_FALSE(timer_wheel_start(&wheel, id, 10U, 0U));
+
+    for (uint8_t i = 0U; i < TIMER_WHEEL_MAX_TIMERS; i++) {
+        TEST_ASSERT_NOT_EQUAL(TIMER_WHEEL_NONE, timer_wheel_alloc(&wheel, i));
+    }
+    TEST_ASSERT_EQUAL(TIMER_WHEEL_NONE, timer_wheel_alloc(&wheel, 0U));
+}
+
+// A late advance over several periods delivers every expiry of each timer
+void test_timer_wheel_catch_up_counts(void) {
+    uint32_t counts[4] = { 0U };
+    timer_wheel_counter_t counter = { counts, 4U };
+
+    reset_wheel();
+    timer_wheel_id_t tick = timer_wheel_alloc(&wheel, 1U);
+    timer_wheel_id_t frame = timer_wheel_alloc(&wheel, 2U);
+    TEST_ASSERT_TRUE(timer_wheel_start(&wheel, tick, 100U, 100U));
+    TEST_ASSERT_TRUE(timer_wheel_start(&wheel, frame, 5U, 5U));
+
+    /* 3.5 periods in one call, as after a stalled esp_timer task */
+    TEST_ASSERT_EQUAL_UINT32(3U + 70U, timer_wheel_advance(&wheel, 350U, timer_wheel_count_expiry, &counter));
+    TEST_ASSERT_EQUAL_UINT32(3U, counts[1]);
+    TEST_ASSERT_EQUAL_UINT32(70U, counts[2]);
+
+    /* The partial period is not lost */
+    (void)timer_wheel_advance(&wheel, 50U, timer_wheel_count_expiry, &counter);
+    TEST_ASSERT_EQUAL_UINT32(4U, counts[1]);
+    TEST_ASSERT_EQUAL_UINT32(0U, counts[0]);
+}
+
+// The nearest expiry is what a one-shot host timer has to be armed for
+void test_timer_wheel_next_expiry(void) {
+    uint32_t ticks = 0U;
+
+    reset_wheel();
+    TEST_ASSERT_FALSE(timer_wheel_next_expiry(&wheel, &ticks));
+
+    timer_wheel_id_t slow = timer_wheel_alloc(&wheel, 1U);
+    timer_wheel_id_t fast = timer_wheel_alloc(&wheel, 2U);
+    TEST_ASSERT_TRUE(timer_wheel_start(&wheel, slow, 5000U, 0U));
+    TEST_ASSERT_TRUE(timer_wheel_next_expiry(&wheel, &ticks));
+    TEST_ASSERT_EQUAL_UINT32(5000U, ticks);
+
+    TEST_ASSERT_TRUE(timer_wheel_start(&wheel, fast, 5U, 5U));
+    (void)timer_wheel_advance(&wheel, 3U, record_expiry, NULL);
+    TEST_ASSERT_TRUE(timer_wheel_next_expiry(&wheel, &ticks));
+    TEST_ASSERT_EQUAL_UINT32(2U, ticks);
+
+    /* Periodic reload, then only the slow timer once the fast one stops */
+    (void)timer_wheel_advance(&wheel, 2U, record_expiry, NULL);
+    TEST_ASSERT_TRUE(timer_wheel_next_expiry(&wheel, &ticks));
+    TEST_ASSERT_EQUAL_UINT32(5U, ticks);
+    timer_wheel_stop(&wheel, fast);
+    TEST_ASSERT_TRUE(timer_wheel_next_expiry(&wheel, &ticks));
+    TEST_ASSERT_EQUAL_UINT32(4995U, ticks);
+
+    timer_wheel_stop(&wheel, slow);
+    TEST_ASSERT_FALSE(timer_wheel_next_expiry(&wheel, &ticks));
+}
@@ -17,9 +17,29 @@ extern void test_clock_increment_hours(void);
 extern void test_clock_increment_minutes(void);
 extern void test_clock_decrement_hours(void);
 extern void test_clock_decrement_minutes(void);
+extern void test_clock_pack_round_trip(void);
 extern void test_display_pattern_1(void);
 extern void test_rotary_encoder(void);
+extern void test_rotary_encoder_decoder_detents(void);
+extern void test_rotary_encoder_decoder_noise(void);
+extern void test_rotary_encoder_accel(void);
 extern void test_nvs(void);
+extern void test_timer_wheel_one_shot(void);
+extern void test_timer_wheel_periodic(void);
+extern void test_timer_wheel_cascade(void);
+extern void test_timer_wheel_stop_and_limits(void);
+extern void test_timer_wheel_catch_up_counts(void);
+extern void test_timer_wheel_next_expiry(void);
+extern void test_json_writer_document(void);
+extern void test_json_writer_errors(void);
+extern void test_json_parse_members(void);
+extern void test_json_parse_errors(void);
+extern void test_form_parser_chunks(void);
+extern void test_form_parser_warnings(void);
+extern void test_form_parser_abort(void);
+extern void test_rate_limiter_client_burst(void);
+extern void test_rate_limiter_global(void);
+extern void test_rate_limiter_recycle_and_wrap(void);
 
 int main(void) {
     UNITY_BEGIN();
@@ -37,9 +57,29 @@ int main(void) {
     RUN_TEST(test_clock_increment_minutes);
     RUN_TEST(test_clock_decrement_hours);
     RUN_TEST(test_clock_decrement_minutes);
+    RUN_TEST(test_clock_pack_round_trip);
     RUN_TEST(test_display_pattern_1);
     RUN_TEST(test_rotary_encoder);
+    RUN_TEST(test_rotary_encoder_decoder_detents);
+    RUN_TEST(test_rotary_encoder_decoder_noise);
+    RUN_TEST(test_rotary_encoder_accel);
     RUN_TEST(test_nvs);
+    RUN_TEST(test_timer_wheel_one_shot);
+    RUN_TEST(test_timer_wheel_periodic);
+    RUN_TEST(test_timer_wheel_cascade);
+    RUN_TEST(test_timer_wheel_stop_and_limits);
+    RUN_TEST(test_timer_wheel_catch_up_counts);
+    RUN_TEST(test_timer_wheel_next_expiry);
+    RUN_TEST(test_json_writer_document);
+    RUN_TEST(test_json_writer_errors);
+    RUN_TEST(test_json_parse_members);
+    RUN_TEST(test_json_parse_errors);
+    RUN_TEST(test_form_parser_chunks);
+    RUN_TEST(test_form_parser_warnings);
+    RUN_TEST(test_form_parser_abort);
+    RUN_TEST(test_rate_limiter_client_burst);
+    RUN_TEST(test_rate_limiter_global);
+    RUN_TEST(test_rate_limiter_recycle_and_wrap);
 
     return UNITY_END();
 }
\ No newline at end of file
@@ -0,0 +1,30 @@
+#!/usr/bin/env python3
+"""Gzip a static web asset for embedding in the firmware.
+
+The output is reproducible (no name, no timestamp), so the ETag derived
+from it only changes when the asset does.
+
+Usage: gzip_asset.py <input> <output.gz>
+"""
+
+import gzip
+import sys
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write(__doc__)
+        return 1
+
+    with open(sys.argv[1], "rb") as f:
+        data = f.read()
+    compressed = gzip.compress(data, compresslevel=9, mtime=0)
+    with open(sys.argv[2], "wb") as f:
+        f.write(compressed)
+
+    print("%s: %u -> %u bytes" % (sys.argv[1], len(data), len(compressed)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
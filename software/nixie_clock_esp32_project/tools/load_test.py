@@ -0,0 +1,393 @@
+#!/usr/bin/env python3
+"""Load test of the embedded webserver and its effect on the display.
+
+Drives GET /, POST /update and the JSON API with a configurable number of
+concurrent clients and reports, for each concurrency level:
+
+- client side: requests per second, errors, writes refused with 429 by
+  the configuration rate limiter and latency percentiles per endpoint;
+- device side, from /metrics deltas: display frame jitter, publish-to-
+  dispatch latency of the display and clock tick events, and coalesced or
+  late time-lane events, configuration applies, next to the same figures
+  measured idle.
+
+POST /update and PATCH /api/config resend the current configuration, so
+the load does not change the clock settings nor wear the flash (unchanged
+configurations are not written back).
+
+Runs against a device (--url) or boots the firmware under QEMU (--qemu,
+see ota_qemu_test.py for the build).
+
+Usage: load_test.py [--url http://clock.local | --qemu] [--concurrency 1,2,4,8]
+                    [--duration 20] [--idle 10] [--mix root=2,update=1,...]
+                    [--json report.json]
+"""
+
+import argparse
+import http.client
+import json
+import math
+import os
+import sys
+import threading
+import time
+import urllib.parse
+
+# Endpoint name -> (method, path, body kind, expected status)
+ENDPOINTS = {
+    "root":         ("GET",   "/",            None,   200),
+    "update":       ("POST",  "/update",      "form", 303),
+    "api_config":   ("GET",   "/api/config",  None,   200),
+    "api_patch":    ("PATCH", "/api/config",  "json", 200),
+    "api_time":     ("GET",   "/api/time",    None,   200),
+    "api_status":   ("GET",   "/api/status",  None,   200),
+}
+DEFAULT_MIX = "root=2,update=1,api_config=1,api_patch=1,api_time=2,api_status=1"
+
+# Device side histograms, (metric, label filter)
+JITTER = ("nixie_display_frame_jitter_us", {})
+DISPATCH = {
+    "display": ("nixie_event_dispatch_latency_us", {"event": "display"}),
+    "clock_tick": ("nixie_event_dispatch_latency_us", {"event": "clock_tick"}),
+}
+TIME_LANE_COUNTERS = (
+    "nixie_event_bus_coalesced_total",
+    "nixie_event_bus_dropped_total",
+    "nixie_event_bus_budget_overruns_total",
+)
+CONFIG_WRITE_COUNTERS = (
+    "nixie_config_writes_total",
+    "nixie_config_writes_merged_total",
+    "nixie_config_applies_total",
+)
+HTTP_TOO_MANY_REQUESTS = 429
+PERCENTILES = (50, 90, 99)
+TIMEOUT_S = 10
+
+
+# ---------------------------------------------------------------- metrics
+
+def parse_metrics(text):
+    """Return {(name, frozenset(labels)): value} of a text exposition."""
+    samples = {}
+    for line in text.splitlines():
+        if not line or line.startswith("#"):
+            continue
+        head, _, value = line.rpartition(" ")
+        labels = {}
+        if "{" in head:
+            head, _, rest = head.partition("{")
+            for pair in rest.rstrip("}").split(","):
+                if pair:
+                    key, _, val = pair.partition("=")
+                    labels[key] = val.strip('"')
+        samples[(head, frozenset(labels.items()))] = float(value)
+    return samples
+
+
+def histogram(samples, name, labels):
+    """Return ([(le, cumulative count)], sum) of one histogram."""
+    buckets = []
+    for (metric, metric_labels), value in samples.items():
+        metric_labels = dict(metric_labels)
+        le = metric_labels.pop("le", None)
+        if metric == name + "_bucket" and metric_labels == labels:
+            buckets.append((math.inf if le == "+Inf" else float(le), value))
+    key = (name + "_sum", frozenset(labels.items()))
+    return sorted(buckets), samples.get(key, 0.0)
+
+
+def histogram_delta(before, after, name, labels):
+    """Return ([(le, count)], sum) of the observations between two scrapes."""
+    b_buckets, b_sum = histogram(before, name, labels)
+    a_buckets, a_sum = histogram(after, name, labels)
+    previous = dict(b_buckets)
+    return [(le, count - previous.get(le, 0.0)) for le, count in a_buckets], a_sum - b_sum
+
+
+def histogram_summary(buckets, total):
+    """Count, mean and bucket bound of the percentiles of a delta histogram."""
+    count = buckets[-1][1] if buckets else 0.0
+    summary = {"count": int(count), "mean": (total / count) if count else None}
+    for p in PERCENTILES:
+        rank = count * p / 100.0
+        summary["p%d" % p] = next((le for le, c in buckets if count and c >= rank), None)
+    # Smallest bound holding every observation, the worst case to a bucket
+    summary["max"] = next((le for le, c in buckets if count and c >= count), None)
+    return summary
+
+
+def counter_delta(before, after, name, labels):
+    key = (name, frozenset(labels.items()))
+    return after.get(key, 0.0) - before.get(key, 0.0)
+
+
+def device_report(before, after):
+    report = {"display_jitter_us": histogram_summary(*histogram_delta(before, after, *JITTER))}
+    for event, (name, labels) in DISPATCH.items():
+        report["dispatch_%s_us" % event] = histogram_summary(*histogram_delta(before, after, name, labels))
+    for name in TIME_LANE_COUNTERS:
+        report[name.replace("nixie_event_bus_", "time_lane_")] = int(
+            counter_delta(before, after, name, {"lane": "time"}))
+    for name in CONFIG_WRITE_COUNTERS:
+        report[name.replace("nixie_", "")] = int(counter_delta(before, after, name, {}))
+    return report
+
+
+# ---------------------------------------------------------------- clients
+
+class Client:
+    """Keep-alive HTTP connection of one simulated client."""
+
+    def __init__(self, host, port):
+        self.host, self.port = host, port
+        self.conn = None
+
+    def request(self, method, path, body=None, headers=None):
+        """Return (status, body), reconnects once on a dropped connection."""
+        for attempt in (0, 1):
+            if self.conn is None:
+                self.conn = http.client.HTTPConnection(self.host, self.port, timeout=TIMEOUT_S)
+            try:
+                self.conn.request(method, path, body=body, headers=headers or {})
+                resp = self.conn.getresponse()
+                data = resp.read()
+                if resp.will_close:
+                    self.close()
+                return resp.status, data
+            except (http.client.HTTPException, OSError):
+                self.close()
+                if attempt == 1:
+                    raise
+        return None, b""
+
+    def close(self):
+        if self.conn is not None:
+            self.conn.close()
+            self.conn = None
+
+
+def scrape(host, port):
+    client = Client(host, port)
+    try:
+        status, body = client.request("GET", "/metrics")
+    finally:
+        client.close()
+    if status != 200:
+        raise RuntimeError("/metrics answered %s" % status)
+    return parse_metrics(body.decode("utf-8", "replace"))
+
+
+def request_bodies(host, port):
+    """Form and JSON bodies resending the current configuration."""
+    client = Client(host, port)
+    try:
+        status, body = client.request("GET", "/api/config")
+    finally:
+        client.close()
+    if status != 200:
+        raise RuntimeError("/api/config answered %s" % status)
+    config = json.loads(body)
+    # Like the page: checked boxes submit "1", unchecked ones nothing
+    form = {key: (1 if value is True else value) for key, value in config.items() if value is not False}
+    return {
+        "form": (urllib.parse.urlencode(form).encode(),
+                 {"Content-Type": "application/x-www-form-urlencoded"}),
+        "json": (json.dumps(config).encode(), {"Content-Type": "application/json"}),
+    }
+
+
+def parse_mix(text):
+    schedule = []
+    for item in text.split(","):
+        name, _, weight = item.partition("=")
+        if name not in ENDPOINTS:
+            raise SystemExit("unknown endpoint %r, choose from %s" % (name, ", ".join(ENDPOINTS)))
+        schedule += [name] * int(weight or 1)
+    return schedule
+
+
+def worker(index, host, port, schedule, bodies, stop, results, lock):
+    client = Client(host, port)
+    local = {name: [[], 0, 0] for name in set(schedule)}
+    i = index    # Stagger the clients over the schedule
+    while not stop.is_set():
+        name = schedule[i % len(schedule)]
+        i += 1
+        method, path, kind, expected = ENDPOINTS[name]
+        body, headers = bodies[kind] if kind else (None, None)
+        start = time.perf_counter()
+        try:
+            status, _ = client.request(method, path, body, headers)
+        except (http.client.HTTPException, OSError):
+            status = None
+        elapsed_ms = (time.perf_counter() - start) * 1000.0
+        if status == expected:
+            local[name][0].append(elapsed_ms)
+        elif status == HTTP_TOO_MANY_REQUESTS:
+            local[name][2] += 1
+        else:
+            local[name][1] += 1
+    client.close()
+    with lock:
+        for name, (latencies, errors, limited) in local.items():
+            results[name][0].extend(latencies)
+            results[name][1] += errors
+            results[name][2] += limited
+
+
+def percentile(sorted_values, p):
+    if not sorted_values:
+        return None
+    rank = max(0, math.ceil(len(sorted_values) * p / 100.0) - 1)
+    return sorted_values[rank]
+
+
+def client_report(results, duration):
+    report = {}
+    all_latencies = []
+    total_errors = 0
+    total_limited = 0
+    for name, (latencies, errors, limited) in sorted(results.items()):
+        latencies.sort()
+        all_latencies += latencies
+        total_errors += errors
+        total_limited += limited
+        report[name] = latency_summary(latencies, errors, limited, duration)
+    all_latencies.sort()
+    report["all"] = latency_summary(all_latencies, total_errors, total_limited, duration)
+    return report
+
+
+def latency_summary(latencies, errors, limited, duration):
+    summary = {"ok": len(latencies), "errors": errors, "limited": limited, "rps": len(latencies) / duration}
+    for p in PERCENTILES:
+        summary["p%d_ms" % p] = percentile(latencies, p)
+    summary["max_ms"] = latencies[-1] if latencies else None
+    return summary
+
+
+def run_phase(host, port, concurrency, duration, schedule, bodies):
+    results = {name: [[], 0, 0] for name in set(schedule)}
+    lock = threading.Lock()
+    stop = threading.Event()
+    before = scrape(host, port)
+    threads = [threading.Thread(target=worker, args=(i, host, port, schedule, bodies, stop, results, lock))
+               for i in range(concurrency)]
+    start = time.monotonic()
+    for t in threads:
+        t.start()
+    time.sleep(duration)
+    stop.set()
+    for t in threads:
+        t.join()
+    elapsed = time.monotonic() - start
+    after = scrape(host, port)
+    return {"concurrency": concurrency, "duration_s": elapsed,
+            "client": client_report(results, elapsed), "device": device_report(before, after)}
+
+
+def run_idle(host, port, duration):
+    before = scrape(host, port)
+    time.sleep(duration)
+    return {"concurrency": 0, "duration_s": duration, "client": {}, "device": device_report(before, scrape(host, port))}
+
+
+# ---------------------------------------------------------------- output
+
+def fmt(value, digits=1):
+    if value is None:
+        return "-"
+    if value == math.inf:
+        return "inf"
+    return "%.*f" % (digits, value)
+
+
+def print_phase(phase, idle):
+    title = "idle" if phase["concurrency"] == 0 else "%d clients" % phase["concurrency"]
+    print("\n== %s, %.0f s" % (title, phase["duration_s"]))
+    if phase["client"]:
+        print("  %-11s %7s %6s %6s %7s %8s %8s %8s %8s" % (
+            "endpoint", "ok", "err", "429", "req/s", "p50 ms", "p90 ms", "p99 ms", "max ms"))
+        for name, s in phase["client"].items():
+            print("  %-11s %7d %6d %6d %7s %8s %8s %8s %8s" % (
+                name, s["ok"], s["errors"], s["limited"], fmt(s["rps"]), fmt(s["p50_ms"]),
+                fmt(s["p90_ms"]), fmt(s["p99_ms"]), fmt(s["max_ms"])))
+
+    # Percentiles are bucket bounds: the value is at most this
+    print("  %-24s %7s %9s %9s %9s %9s %14s" % ("device (us, <=)", "count", "mean", "p50", "p90", "p99", "idle p99"))
+    for key, s in phase["device"].items():
+        if isinstance(s, dict):
+            idle_p99 = idle["device"][key]["p99"] if idle else None
+            print("  %-24s %7d %9s %9s %9s %9s %14s" % (
+                key, s["count"], fmt(s["mean"], 0), fmt(s["p50"], 0), fmt(s["p90"], 0),
+                fmt(s["p99"], 0), fmt(idle_p99, 0)))
+    counters = ", ".join("%s %d" % (k, v) for k, v in phase["device"].items() if not isinstance(v, dict))
+    print("  %s" % counters)
+
+
+def json_safe(value):
+    """Open-ended bucket bounds are written as "+Inf", JSON has no infinity."""
+    if isinstance(value, dict):
+        return {k: json_safe(v) for k, v in value.items()}
+    if isinstance(value, list):
+        return [json_safe(v) for v in value]
+    return "+Inf" if value == math.inf else value
+
+
+# ---------------------------------------------------------------- main
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    target = parser.add_mutually_exclusive_group()
+    target.add_argument("--url", default="http://192.168.4.1", help="device base URL")
+    target.add_argument("--qemu", action="store_true", help="boot the firmware under QEMU first")
+    parser.add_argument("--port", type=int, default=8080, help="host port forwarded to QEMU port 80")
+    parser.add_argument("--no-build", action="store_true", help="with --qemu, reuse the existing build_qemu")
+    parser.add_argument("--concurrency", default="1,2,4,8", help="comma-separated client counts")
+    parser.add_argument("--duration", type=float, default=20.0, help="seconds per concurrency level")
+    parser.add_argument("--idle", type=float, default=10.0, help="idle baseline seconds, 0 to skip")
+    parser.add_argument("--mix", default=DEFAULT_MIX, help="endpoint=weight list")
+    parser.add_argument("--json", help="also write the report to this file")
+    args = parser.parse_args()
+
+    schedule = parse_mix(args.mix)
+    levels = [int(c) for c in args.concurrency.split(",")]
+    qemu = None
+    if args.qemu:
+        sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+        import ota_qemu_test
+        project = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+        if not args.no_build:
+            ota_qemu_test.build(project)
+        qemu = ota_qemu_test.Qemu(project, args.port, echo=False)
+        base = "http://127.0.0.1:%d" % args.port
+        ota_qemu_test.wait_status(base)
+    else:
+        base = args.url
+    url = urllib.parse.urlsplit(base)
+    host, port = url.hostname, url.port or 80
+
+    phases = []
+    try:
+        bodies = request_bodies(host, port)
+        idle = run_idle(host, port, args.idle) if args.idle > 0 else None
+        if idle:
+            phases.append(idle)
+            print_phase(idle, None)
+        for level in levels:
+            phase = run_phase(host, port, level, args.duration, schedule, bodies)
+            phases.append(phase)
+            print_phase(phase, idle)
+    finally:
+        if qemu is not None:
+            qemu.stop()
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(json_safe({"target": base, "mix": args.mix, "phases": phases}), f, indent=2)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+"""RAM budget report of the statically allocated RTOS objects.
+
+Reads the symbol table of the firmware ELF and groups the static buffers
+declared for tasks, queues and semaphores (see components/mem_budget) by
+kind, then adds the few objects still allocated from the heap at runtime.
+
+Usage: mem_budget.py <firmware.elf> [--header mem_budget.h] [--ram-kb 400]
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+# Symbol name suffix -> budget category, first match wins
+CATEGORIES = (
+    ("Task stacks", re.compile(r"_stack$")),
+    ("Task control blocks", re.compile(r"_tcb$")),
+    ("Queue storage", re.compile(r"_queue_storage$")),
+    ("Queue/semaphore control blocks", re.compile(r"_(queue|mutex|sem|count)_buffer$")),
+    ("Event payload pool", re.compile(r"^s_(small|medium|large)_storage$")),
+)
+
+# Sections holding static data in internal RAM
+RAM_SECTIONS = (".dram0.data", ".dram0.bss", ".noinit")
+
+# mem_budget.h entries allocated from the heap, not visible in the ELF
+HEAP_DEFINES = ("MEM_BUDGET_HTTPD_STACK_SIZE",)
+
+SHT_SYMTAB = 2
+STT_OBJECT = 1
+
+
+def read_elf(path):
+    """Return ({section name: size}, [(symbol name, size)]) of an ELF32 file."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != b"\x7fELF" or data[4] != 1:
+        raise ValueError("%s is not an ELF32 file" % path)
+    endian = "<" if data[5] == 1 else ">"
+
+    shoff, = struct.unpack_from(endian + "I", data, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", data, 0x2E)
+    sections = []
+    for i in range(shnum):
+        sections.append(struct.unpack_from(endian + "IIIIIIIIII", data, shoff + i * shentsize))
+
+    def cstr(offset):
+        return data[offset:data.index(b"\0", offset)].decode("ascii", "replace")
+
+    names_off = sections[shstrndx][4]
+    section_sizes = {cstr(names_off + s[0]): s[5] for s in sections}
+
+    symbols = []
+    for s in sections:
+        if s[1] != SHT_SYMTAB:
+            continue
+        strtab_off = sections[s[6]][4]
+        for off in range(s[4], s[4] + s[5], s[9]):
+            st_name, _, st_size, st_info, _, _ = struct.unpack_from(endian + "IIIBBH", data, off)
+            if (st_info & 0xF) == STT_OBJECT and st_size > 0:
+                symbols.append((cstr(strtab_off + st_name), st_size))
+    return section_sizes, symbols
+
+
+def read_defines(path):
+    """Return the numeric #defines of a header."""
+    defines = {}
+    pattern = re.compile(r"^#define\s+(\w+)\s+\(?(\d+)U?\)?")
+    with open(path) as f:
+        for line in f:
+            match = pattern.match(line)
+            if match:
+                defines[match.group(1)] = int(match.group(2))
+    return defines
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf")
+    parser.add_argument("--header", help="mem_budget.h, for the heap allocated entries")
+    parser.add_argument("--ram-kb", type=int, default=400, help="internal RAM size")
+    args = parser.parse_args()
+
+    section_sizes, symbols = read_elf(args.elf)
+
+    print("RTOS static RAM budget")
+    static_total = 0
+    for category, pattern in CATEGORIES:
+        matched = sorted((s for s in symbols if pattern.search(s[0])), key=lambda s: -s[1])
+        symbols = [s for s in symbols if not pattern.search(s[0])]
+        total = sum(size for _, size in matched)
+        static_total += total
+        print("  %-34s %8u B" % (category, total))
+        for name, size in matched:
+            print("    %-32s %8u B" % (name, size))
+
+    heap_total = 0
+    if args.header:
+        defines = read_defines(args.header)
+        print("Heap allocated at runtime")
+        for name in HEAP_DEFINES:
+            size = defines.get(name, 0)
+            heap_total += size
+            print("  %-34s %8u B" % (name, size))
+
+    ram_static = sum(section_sizes.get(name, 0) for name in RAM_SECTIONS)
+    ram_size = args.ram_kb * 1024
+    print("Totals")
+    print("  %-34s %8u B" % ("RTOS objects (static)", static_total))
+    print("  %-34s %8u B" % ("RTOS objects (heap)", heap_total))
+    print("  %-34s %8u B" % ("All static data in RAM", ram_static))
+    print("  %-34s %8u B (%.1f %% of %u KB)" % ("Static data + RTOS heap", ram_static + heap_total,
+                                                100.0 * (ram_static + heap_total) / ram_size, args.ram_kb))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
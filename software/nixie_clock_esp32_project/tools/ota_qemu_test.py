@@ -0,0 +1,212 @@
+#!/usr/bin/env python3
+"""End-to-end test of POST /api/ota on the QEMU emulator.
+
+Builds the firmware with the sdkconfig.qemu overlay (OpenETH instead of
+Wi-Fi), boots it in QEMU with the HTTP port forwarded to the host, then:
+
+1. posts a corrupted image and a wrong X-Image-SHA256, both must be
+   rejected with 422 and the device must keep running its partition;
+2. posts the real image with its hash, the device must reboot on the
+   other OTA partition pending verification, then confirm it once the
+   health check passed;
+3. with --rollback, uploads again and resets QEMU while the new image is
+   still pending verification, the bootloader must roll back.
+
+Usage: ota_qemu_test.py [--project DIR] [--port 8080] [--rollback] [--no-build]
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import socket
+import subprocess
+import sys
+import threading
+import time
+import urllib.error
+import urllib.request
+
+BUILD_DIR = "build_qemu"
+APP_BIN = "nixie_clock.bin"
+MONITOR_PORT = 4444
+BOOT_TIMEOUT_S = 120
+HEALTH_CHECK_S = 10     # MAIN_OTA_HEALTH_CHECK_S in main/main.c
+PENDING_LOG = "New firmware pending verification"
+BOOT_LOG = "ESP-ROM:"      # First line printed by the ROM on every reset
+
+
+class Qemu:
+    """idf.py qemu session, its output is scanned for log lines."""
+
+    def __init__(self, project, port, echo=True):
+        extra = ("-nic user,model=open_eth,hostfwd=tcp:127.0.0.1:%d-:80 "
+                 "-monitor tcp:127.0.0.1:%d,server,nowait" % (port, MONITOR_PORT))
+        self.proc = subprocess.Popen(
+            ["idf.py", "-B", BUILD_DIR, "qemu", "--qemu-extra-args", extra],
+            cwd=project, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+            text=True, errors="replace")
+        self.echo = echo
+        self.lines = []
+        self.cond = threading.Condition()
+        threading.Thread(target=self._read, daemon=True).start()
+
+    def _read(self):
+        for line in self.proc.stdout:
+            if self.echo:
+                sys.stdout.write("  | " + line)
+            with self.cond:
+                self.lines.append(line)
+                self.cond.notify_all()
+
+    def wait_log(self, text, start, timeout):
+        """Index of the first line after start containing text, None on timeout."""
+        deadline = time.monotonic() + timeout
+        with self.cond:
+            while True:
+                for i in range(start, len(self.lines)):
+                    if text in self.lines[i]:
+                        return i
+                remaining = deadline - time.monotonic()
+                if remaining <= 0:
+                    return None
+                self.cond.wait(remaining)
+
+    def reset(self):
+        """Hard reset of the emulated chip through the QEMU monitor."""
+        with socket.create_connection(("127.0.0.1", MONITOR_PORT), timeout=5) as s:
+            s.sendall(b"system_reset\n")
+
+    def stop(self):
+        self.proc.terminate()
+        try:
+            self.proc.wait(timeout=10)
+        except subprocess.TimeoutExpired:
+            self.proc.kill()
+
+
+def build(project):
+    """Build the firmware with the QEMU overlay into BUILD_DIR."""
+    subprocess.run(["idf.py", "-B", BUILD_DIR,
+                    "-D", "SDKCONFIG=%s/sdkconfig" % BUILD_DIR,
+                    "-D", "SDKCONFIG_DEFAULTS=sdkconfig;sdkconfig.qemu", "build"],
+                   cwd=project, check=True)
+
+
+def request(base, path, data=None, headers=None, timeout=30):
+    """Return (HTTP status, decoded JSON body or None)."""
+    req = urllib.request.Request(base + path, data=data, headers=headers or {},
+                                 method="POST" if data is not None else "GET")
+    try:
+        with urllib.request.urlopen(req, timeout=timeout) as resp:
+            status, body = resp.status, resp.read()
+    except urllib.error.HTTPError as e:
+        status, body = e.code, e.read()
+    try:
+        return status, json.loads(body)
+    except ValueError:
+        return status, None
+
+
+def wait_status(base, timeout=BOOT_TIMEOUT_S):
+    """Poll /api/status until the device answers, return its firmware object."""
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        try:
+            status, body = request(base, "/api/status", timeout=5)
+            if status == 200 and body is not None:
+                return body["firmware"]
+        except (OSError, urllib.error.URLError):
+            pass
+        time.sleep(1)
+    raise RuntimeError("device did not answer /api/status")
+
+
+def upload(base, image, sha256):
+    headers = {"Content-Type": "application/octet-stream"}
+    if sha256 is not None:
+        headers["X-Image-SHA256"] = sha256
+    return request(base, "/api/ota", data=image, headers=headers, timeout=120)
+
+
+def check(cond, message):
+    if not cond:
+        raise AssertionError(message)
+    print("PASS", message)
+
+
+def test_rejects(base, image):
+    before = wait_status(base)
+    corrupted = bytearray(image)
+    corrupted[len(corrupted) // 2] ^= 0xFF
+    status, _ = upload(base, bytes(corrupted), None)
+    check(status == 422, "corrupted image rejected (%d)" % status)
+    status, _ = upload(base, image, "00" * 32)
+    check(status == 422, "wrong sha256 rejected (%d)" % status)
+    after = wait_status(base)
+    check(after["partition"] == before["partition"], "still running %s" % before["partition"])
+    return before["partition"]
+
+
+def test_update(qemu, base, image, running):
+    mark = len(qemu.lines)
+    status, body = upload(base, image, hashlib.sha256(image).hexdigest())
+    check(status == 200 and body["reboot"] is True, "image accepted (%d)" % status)
+    target = body["partition"]
+    check(target != running, "written to the inactive partition %s" % target)
+    # The old image keeps answering until the delayed restart, poll once the new one booted
+    check(qemu.wait_log(PENDING_LOG, mark, BOOT_TIMEOUT_S) is not None, "rebooted pending verification")
+    fw = wait_status(base)
+    check(fw["partition"] == target, "rebooted on %s" % target)
+    check(fw["pending_verify"] is True, "new image pending verification")
+    time.sleep(HEALTH_CHECK_S + 5)
+    fw = wait_status(base)
+    check(fw["pending_verify"] is False, "new image confirmed by the health check")
+    return target
+
+
+def test_rollback(qemu, base, image, running):
+    mark = len(qemu.lines)
+    status, body = upload(base, image, hashlib.sha256(image).hexdigest())
+    check(status == 200, "image accepted (%d)" % status)
+    check(qemu.wait_log(PENDING_LOG, mark, BOOT_TIMEOUT_S) is not None, "rebooted pending verification")
+    mark = len(qemu.lines)
+    qemu.reset()
+    check(qemu.wait_log(BOOT_LOG, mark, BOOT_TIMEOUT_S) is not None, "chip reset")
+    fw = wait_status(base)
+    check(fw["partition"] == running, "rolled back to %s" % running)
+    check(fw["pending_verify"] is False, "previous image still valid")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--project", default=os.path.join(os.path.dirname(__file__), ".."))
+    parser.add_argument("--port", type=int, default=8080, help="host port forwarded to port 80")
+    parser.add_argument("--rollback", action="store_true", help="also test the rollback on reset")
+    parser.add_argument("--no-build", action="store_true", help="reuse the existing build_qemu")
+    args = parser.parse_args()
+    project = os.path.abspath(args.project)
+
+    if not args.no_build:
+        build(project)
+    with open(os.path.join(project, BUILD_DIR, APP_BIN), "rb") as f:
+        image = f.read()
+
+    base = "http://127.0.0.1:%d" % args.port
+    qemu = Qemu(project, args.port)
+    try:
+        running = test_rejects(base, image)
+        running = test_update(qemu, base, image, running)
+        if args.rollback:
+            test_rollback(qemu, base, image, running)
+    except (AssertionError, RuntimeError) as e:
+        print("FAIL", e)
+        return 1
+    finally:
+        qemu.stop()
+    print("OK")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())